@@ -0,0 +1,203 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file Benchmark.hpp
+ * \brief Minimal timing harness for the kernel benchmarks, with
+ * output as JSON.
+ */
+#ifndef STRUMPACK_BENCHMARK_HPP
+#define STRUMPACK_BENCHMARK_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <ctime>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "StrumpackConfig.hpp"
+#include "misc/TaskTimer.hpp"
+
+namespace strumpack {
+  namespace bench {
+
+    /**
+     * Timings for one kernel on one input.
+     */
+    struct Result {
+      std::string name, input;
+      std::size_t n, nnz;
+      std::vector<double> times;
+
+      double min() const {
+        return *std::min_element(times.begin(), times.end());
+      }
+      double max() const {
+        return *std::max_element(times.begin(), times.end());
+      }
+      double mean() const {
+        return std::accumulate(times.begin(), times.end(), 0.)
+          / times.size();
+      }
+      double median() const {
+        auto t = times;
+        std::sort(t.begin(), t.end());
+        auto m = t.size() / 2;
+        return (t.size() % 2) ? t[m] : (t[m-1] + t[m]) / 2;
+      }
+    };
+
+    /**
+     * Runs each benchmark for a number of warmup and timed
+     * repetitions, prints a summary and optionally writes all results
+     * to a JSON file. Command line options:
+     *
+     *   --reps r       number of timed repetitions (default 5)
+     *   --warmup w     number of untimed repetitions (default 1)
+     *   --filter s     only run benchmarks whose name or input contains s
+     *   --json file    write the results to file
+     *
+     * Other options are left for the benchmark driver.
+     */
+    class Runner {
+    public:
+      Runner(int argc, char* argv[]) {
+        for (int i=1; i<argc; i++) {
+          std::string a(argv[i]);
+          if (i+1 < argc && a == "--reps") reps_ = std::stoi(argv[++i]);
+          else if (i+1 < argc && a == "--warmup")
+            warmup_ = std::stoi(argv[++i]);
+          else if (i+1 < argc && a == "--filter") filter_ = argv[++i];
+          else if (i+1 < argc && a == "--json") json_ = argv[++i];
+        }
+        reps_ = std::max(1, reps_);
+        warmup_ = std::max(0, warmup_);
+      }
+
+      bool selected(const std::string& name,
+                    const std::string& input) const {
+        return filter_.empty() ||
+          name.find(filter_) != std::string::npos ||
+          input.find(filter_) != std::string::npos;
+      }
+
+      /**
+       * Time kernel() for the given input. setup() is called before
+       * every call to kernel(), and is not timed. This can be used to
+       * reset data modified by the kernel.
+       */
+      template<typename Setup, typename Kernel> void
+      run(const std::string& name, const std::string& input,
+          std::size_t n, std::size_t nnz,
+          const Setup& setup, const Kernel& kernel) {
+        if (!selected(name, input)) return;
+        Result r{name, input, n, nnz, {}};
+        for (int i=0; i<warmup_+reps_; i++) {
+          setup();
+          TaskTimer t("bench");
+          t.start();
+          kernel();
+          t.stop();
+          if (i >= warmup_) r.times.push_back(t.elapsed());
+        }
+        std::cout << std::left << std::setw(28) << name
+                  << std::setw(24) << input << std::right
+                  << " n=" << std::setw(9) << n
+                  << " median= " << std::scientific
+                  << std::setprecision(3) << r.median()
+                  << " s, min= " << r.min() << " s"
+                  << std::defaultfloat << std::endl;
+        results_.push_back(std::move(r));
+      }
+      template<typename Kernel> void
+      run(const std::string& name, const std::string& input,
+          std::size_t n, std::size_t nnz, const Kernel& kernel) {
+        run(name, input, n, nnz, [](){}, kernel);
+      }
+
+      /**
+       * Write the results, if requested with --json, together with
+       * the version and the number of threads.
+       */
+      void finish() const {
+        if (json_.empty()) return;
+        std::ofstream f(json_);
+        if (!f) {
+          std::cerr << "ERROR: could not open " << json_ << std::endl;
+          return;
+        }
+        int threads = 1;
+#if defined(_OPENMP)
+        threads = omp_get_max_threads();
+#endif
+        char date[32];
+        auto now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                      std::localtime(&now));
+        f << "{\n  \"context\": {\n"
+          << "    \"date\": \"" << date << "\",\n"
+          << "    \"strumpack_version\": \""
+          << STRUMPACK_VERSION_MAJOR << "." << STRUMPACK_VERSION_MINOR
+          << "." << STRUMPACK_VERSION_PATCH << "\",\n"
+          << "    \"threads\": " << threads << ",\n"
+          << "    \"repetitions\": " << reps_ << ",\n"
+          << "    \"warmup\": " << warmup_ << "\n  },\n"
+          << "  \"benchmarks\": [";
+        f << std::setprecision(9);
+        for (std::size_t i=0; i<results_.size(); i++) {
+          auto& r = results_[i];
+          f << (i ? ",\n" : "\n")
+            << "    {\"name\": \"" << r.name
+            << "\", \"input\": \"" << r.input
+            << "\", \"n\": " << r.n << ", \"nnz\": " << r.nnz
+            << ", \"median\": " << r.median() << ", \"min\": " << r.min()
+            << ", \"max\": " << r.max() << ", \"mean\": " << r.mean()
+            << ", \"times\": [";
+          for (std::size_t j=0; j<r.times.size(); j++)
+            f << (j ? ", " : "") << r.times[j];
+          f << "]}";
+        }
+        f << "\n  ]\n}" << std::endl;
+      }
+
+    private:
+      int reps_ = 5, warmup_ = 1;
+      std::string filter_, json_;
+      std::vector<Result> results_;
+    };
+
+  } // end namespace bench
+} // end namespace strumpack
+
+#endif // STRUMPACK_BENCHMARK_HPP
@@ -0,0 +1,140 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file Generators.hpp
+ * \brief Sparse test matrices, generated in-process, for the
+ * benchmarks.
+ */
+#ifndef STRUMPACK_BENCHMARK_GENERATORS_HPP
+#define STRUMPACK_BENCHMARK_GENERATORS_HPP
+
+#include <cmath>
+#include <complex>
+
+#include "sparse/CSRMatrix.hpp"
+
+namespace strumpack {
+  namespace bench {
+
+    /**
+     * Matrix for a 7 point stencil (5 point if nz == 1) on a regular
+     * nx x ny x nz grid, with lexicographic ordering of the grid
+     * points, x fastest. The coefficients are given in c as {center,
+     * -x, +x, -y, +y, -z, +z}. The column indices in each row are
+     * sorted.
+     */
+    template<typename scalar_t,typename integer_t>
+    CSRMatrix<scalar_t,integer_t>
+    stencil_matrix(int nx, int ny, int nz, const scalar_t (&c)[7]) {
+      integer_t nxy = integer_t(nx) * ny, N = nxy * nz,
+        nnz = 7 * N - 2 * (integer_t(ny) * nz + integer_t(nx) * nz + nxy);
+      CSRMatrix<scalar_t,integer_t> A(N, nnz);
+      auto ptr = A.ptr();
+      auto ind = A.ind();
+      auto val = A.val();
+      integer_t k = 0;
+      ptr[0] = 0;
+      for (int z=0; z<nz; z++)
+        for (int y=0; y<ny; y++)
+          for (int x=0; x<nx; x++) {
+            integer_t r = x + y * integer_t(nx) + z * nxy;
+            auto add = [&](integer_t col, scalar_t v) {
+              ind[k] = col; val[k++] = v;
+            };
+            if (z > 0)    add(r - nxy, c[5]);
+            if (y > 0)    add(r - nx,  c[3]);
+            if (x > 0)    add(r - 1,   c[1]);
+            add(r, c[0]);
+            if (x < nx-1) add(r + 1,   c[2]);
+            if (y < ny-1) add(r + nx,  c[4]);
+            if (z < nz-1) add(r + nxy, c[6]);
+            ptr[r+1] = k;
+          }
+      return A;
+    }
+
+    /**
+     * 5 point finite difference Laplacian on an n x n grid.
+     */
+    template<typename scalar_t,typename integer_t>
+    CSRMatrix<scalar_t,integer_t> poisson2d(int n) {
+      const scalar_t c[7] = {4, -1, -1, -1, -1, 0, 0};
+      auto A = stencil_matrix<scalar_t,integer_t>(n, n, 1, c);
+      A.set_symm_sparse();
+      return A;
+    }
+
+    /**
+     * 7 point finite difference Laplacian on an n x n x n grid.
+     */
+    template<typename scalar_t,typename integer_t>
+    CSRMatrix<scalar_t,integer_t> poisson3d(int n) {
+      const scalar_t c[7] = {6, -1, -1, -1, -1, -1, -1};
+      auto A = stencil_matrix<scalar_t,integer_t>(n, n, n, c);
+      A.set_symm_sparse();
+      return A;
+    }
+
+    /**
+     * Convection-diffusion -Laplace(u) + b.grad(u) on an n x n grid,
+     * with constant velocity b = (beta, beta) and first order upwind
+     * differences for the convection term. This has a symmetric
+     * sparsity pattern, but is not symmetric.
+     */
+    template<typename scalar_t,typename integer_t>
+    CSRMatrix<scalar_t,integer_t> convection_diffusion2d(int n, double beta) {
+      const double bh = beta / (n + 1);
+      const scalar_t c[7] =
+        {4 + 2 * bh, -1 - bh, -1, -1 - bh, -1, 0, 0};
+      auto A = stencil_matrix<scalar_t,integer_t>(n, n, 1, c);
+      A.set_symm_sparse();
+      return A;
+    }
+
+    /**
+     * Helmholtz equation -Laplace(u) - k^2 (1 + i alpha) u on an n x
+     * n x n grid, with ppw points per wavelength and a small damping
+     * alpha. This is complex symmetric, and indefinite.
+     */
+    template<typename real_t,typename integer_t>
+    CSRMatrix<std::complex<real_t>,integer_t>
+    helmholtz3d(int n, double ppw=10., double alpha=0.05) {
+      using scalar_t = std::complex<real_t>;
+      const double kh = 2. * M_PI / ppw;
+      const scalar_t c[7] =
+        {scalar_t(6 - kh*kh, -alpha*kh*kh), -1, -1, -1, -1, -1, -1};
+      auto A = stencil_matrix<scalar_t,integer_t>(n, n, n, c);
+      A.set_symm_sparse();
+      return A;
+    }
+
+  } // end namespace bench
+} // end namespace strumpack
+
+#endif // STRUMPACK_BENCHMARK_GENERATORS_HPP
@@ -0,0 +1,205 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Benchmark.hpp"
+#include "Generators.hpp"
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/EliminationTree.hpp"
+#include "sparse/ordering/MatrixReordering.hpp"
+#include "sparse/fronts/FrontalMatrixDense.hpp"
+#include "BLR/BLRMatrix.hpp"
+#include "HSS/HSSMatrix.hpp"
+#if defined(STRUMPACK_USE_ZFP)
+#include "sparse/fronts/FrontalMatrixLossy.hpp"
+#endif
+
+using namespace strumpack;
+using namespace strumpack::bench;
+
+/**
+ * Dense front with the structure of another front, with a random
+ * contribution block, to time the extend-add of that contribution
+ * block into the parent.
+ */
+template<typename scalar_t,typename integer_t> class CBFront
+  : public FrontalMatrixDense<scalar_t,integer_t> {
+  using F_t = FrontalMatrix<scalar_t,integer_t>;
+public:
+  CBFront(const F_t& f, std::vector<integer_t> upd)
+    : FrontalMatrixDense<scalar_t,integer_t>
+    (f.sep(), f.sep_begin(), f.sep_end(), upd) {}
+  void random_CB() {
+    this->allocate_CB(nullptr);
+    this->F22_.random();
+  }
+};
+
+/**
+ * Benchmarks for the sparse matrix A, from a stencil on an nx x ny x
+ * nz grid: spmv, nested dissection, symbolic factorization and the
+ * assembly and extend-add for the root front.
+ */
+template<typename scalar_t,typename integer_t> void
+sparse_benchmarks(Runner& r, const std::string& input,
+                  const CSRMatrix<scalar_t,integer_t>& A,
+                  int nx, int ny, int nz) {
+  using DenseM_t = DenseMatrix<scalar_t>;
+  std::size_t n = A.size(), nnz = A.nnz();
+  SPOptions<scalar_t> opts;
+  opts.set_verbose(false);
+
+  DenseM_t x(n, 1), y(n, 1);
+  x.random();
+  r.run("spmv", input, n, nnz, [&](){ A.spmv(x, y); });
+
+  MatrixReordering<scalar_t,integer_t> nd(n);
+  opts.set_reordering_method(ReorderingStrategy::GEOMETRIC);
+  r.run("nested_dissection_geometric", input, n, nnz, [&](){
+      nd.nested_dissection(opts, A, nx, ny, nz, 1, 1);
+    });
+  opts.set_reordering_method(ReorderingStrategy::METIS);
+  r.run("nested_dissection_metis", input, n, nnz, [&](){
+      nd.nested_dissection(opts, A, nx, ny, nz, 1, 1);
+    });
+  // the following are for the last computed (METIS) ordering, which
+  // is also computed when the nested dissection benchmarks are
+  // filtered out
+  if (!r.selected("nested_dissection_metis", input))
+    nd.nested_dissection(opts, A, nx, ny, nz, 1, 1);
+  auto Ap = A;
+  Ap.permute(nd.iperm(), nd.perm());
+
+  std::unique_ptr<EliminationTree<scalar_t,integer_t>> etree;
+  r.run("symbolic_factorization", input, n, nnz, [&](){
+      etree.reset(new EliminationTree<scalar_t,integer_t>
+                  (opts, Ap, nd.tree()));
+    });
+  if (!etree)
+    etree.reset(new EliminationTree<scalar_t,integer_t>
+                (opts, Ap, nd.tree()));
+
+  auto root = etree->root();
+  std::size_t dsep = root->dim_sep(), dupd = root->dim_upd();
+  DenseM_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep),
+    F22(dupd, dupd);
+  r.run("extract_front", input, dsep+dupd, nnz,
+        [&](){ F11.zero(); F12.zero(); F21.zero(); },
+        [&](){
+          Ap.extract_front(F11, F12, F21, root->sep_begin(),
+                           root->sep_end(), root->upd(), 0);
+        });
+
+  auto ch = root->lchild();
+  if (!ch || !ch->dim_upd()) return;
+  CBFront<scalar_t,integer_t> f(*ch, ch->upd());
+  r.run("extend_add_to_dense", input, ch->dim_upd(), nnz,
+        [&](){ f.random_CB(); },
+        [&](){ f.extend_add_to_dense(F11, F12, F21, F22, root, 0); });
+}
+
+/**
+ * Benchmarks for the compression of a dense m x m matrix, for the
+ * structured (BLR, HSS, lossy) fronts. This uses the Toeplitz matrix
+ * A(i,j) = 1 / (1 + |i-j|), which has low rank off-diagonal blocks.
+ */
+void dense_benchmarks(Runner& r, int m, int leaf) {
+  using DenseM_t = DenseMatrix<double>;
+  std::string input = "toeplitz_" + std::to_string(m);
+  DenseM_t A(m, m), B(m, m);
+  for (int j=0; j<m; j++)
+    for (int i=0; i<m; i++)
+      A(i, j) = 1. / (1 + std::abs(i - j));
+
+  HSS::HSSPartitionTree tree(m);
+  tree.refine(leaf);
+  auto tiles = tree.template leaf_sizes<std::size_t>();
+  std::size_t nt = tiles.size();
+  DenseMatrix<bool> adm(nt, nt);
+  adm.fill(true);
+  for (std::size_t t=0; t<nt; t++) adm(t, t) = false;
+  BLR::BLROptions<double> blr_opts;
+  blr_opts.set_leaf_size(leaf);
+  r.run("blr_compress", input, m, m*m, [&](){ B.copy(A); }, [&](){
+      BLR::BLRMatrix<double> H(B, tiles, tiles, blr_opts);
+    });
+  std::vector<int> piv;
+  r.run("blr_factor", input, m, m*m, [&](){ B.copy(A); }, [&](){
+      BLR::BLRMatrix<double> H(B, tiles, adm, piv, blr_opts);
+    });
+
+  HSS::HSSOptions<double> hss_opts;
+  hss_opts.set_leaf_size(leaf);
+  hss_opts.set_verbose(false);
+  r.run("hss_compress", input, m, m*m, [&](){
+      HSS::HSSMatrix<double> H(A, hss_opts);
+    });
+
+#if defined(STRUMPACK_USE_ZFP)
+  LossyMatrix<double> L;
+  r.run("lossy_compress", input, m, m*m, [&](){
+      L = LossyMatrix<double>(A, 16);
+    });
+  r.run("lossy_decompress", input, m, m*m, [&](){ L.decompress(B); });
+#endif
+}
+
+int main(int argc, char* argv[]) {
+  int n2d = 256, n3d = 32, m = 1000, leaf = 128;
+  for (int i=1; i<argc-1; i++) {
+    std::string a(argv[i]);
+    if (a == "--n2d") n2d = std::stoi(argv[++i]);
+    else if (a == "--n3d") n3d = std::stoi(argv[++i]);
+    else if (a == "--m") m = std::stoi(argv[++i]);
+    else if (a == "--leaf") leaf = std::stoi(argv[++i]);
+  }
+  std::cout << "# usage: " << argv[0] << " [--n2d n] [--n3d n]"
+            << " [--m m] [--leaf l]" << std::endl
+            << "#    [--reps r] [--warmup w] [--filter s] [--json file]"
+            << std::endl;
+  Runner r(argc, argv);
+
+  auto s2 = std::to_string(n2d), s3 = std::to_string(n3d);
+  sparse_benchmarks
+    (r, "poisson2d_" + s2, poisson2d<double,int>(n2d), n2d, n2d, 1);
+  sparse_benchmarks
+    (r, "poisson3d_" + s3, poisson3d<double,int>(n3d), n3d, n3d, n3d);
+  sparse_benchmarks
+    (r, "convdiff2d_" + s2,
+     convection_diffusion2d<double,int>(n2d, 100.), n2d, n2d, 1);
+  sparse_benchmarks
+    (r, "helmholtz3d_" + s3, helmholtz3d<double,int>(n3d), n3d, n3d, n3d);
+  dense_benchmarks(r, m, leaf);
+
+  r.finish();
+  return 0;
+}
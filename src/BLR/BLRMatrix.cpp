@@ -1715,28 +1715,18 @@ namespace strumpack {
           trsm(s, ul, ta, d, alpha, a.tile(j, j), bj, task_depth);
         }
       } else if (s == Side::L) {
-        if (ul == UpLo::L) {
-          for (std::size_t j=0; j<a.colblocks(); j++) {
-            DMW_t bj(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0);\
-            for (std::size_t k=0; k<j; k++){
-              gemm(ta, Trans::N, scalar_t(-1.),
-                   ta==Trans::N ? a.tile(j, k) : a.tile(k, j),
-                   DMW_t(a.tilecols(k), b.cols(), b, a.tilecoff(k), 0),
-                   scalar_t(1.), bj, task_depth);
-            }
-            trsm(s, ul, ta, d, alpha, a.tile(j, j), bj, task_depth);
-          }
-        } else {
-          for (int j=a.colblocks()-1; j>=0; j--) {
-            DMW_t bj(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0);
-            for (std::size_t k=j+1; k<a.colblocks(); k++){
-              gemm(ta, Trans::N, scalar_t(-1.),
-                   ta==Trans::N ? a.tile(j, k) : a.tile(k, j),
-                   DMW_t(a.tilecols(k), b.cols(), b, a.tilecoff(k), 0),
-                   scalar_t(1.), bj, task_depth);
-            }
-            trsm(s, ul, ta, d, alpha, a.tile(j, j), bj, task_depth);
-          }
+        // L and U^T/U^H are solved top-down, U and L^T/L^H bottom-up
+        const bool down = (ul == UpLo::L) == (ta == Trans::N);
+        const int nb = a.colblocks();
+        for (int jj=0; jj<nb; jj++) {
+          const int j = down ? jj : nb-1-jj;
+          DMW_t bj(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0);
+          for (int k=(down ? 0 : j+1); k<(down ? j : nb); k++)
+            gemm(ta, Trans::N, scalar_t(-1.),
+                 ta==Trans::N ? a.tile(j, k) : a.tile(k, j),
+                 DMW_t(a.tilecols(k), b.cols(), b, a.tilecoff(k), 0),
+                 scalar_t(1.), bj, task_depth);
+          trsm(s, ul, ta, d, alpha, a.tile(j, j), bj, task_depth);
         }
       } else { assert(false); }
     }
@@ -1747,28 +1737,18 @@ namespace strumpack {
       // TODO threading
       assert(b.cols() == 1);
       using DMW_t = DenseMatrixWrapper<scalar_t>;
-      if (ul == UpLo::L) {
-        for (std::size_t i=0; i<a.rowblocks(); i++) {
-          DMW_t bi(a.tilecols(i), b.cols(), b, a.tilecoff(i), 0);
-          for (std::size_t j=0; j<i; j++)
-            (ta==Trans::N ? a.tile(i, j) : a.tile(j, i)).gemv_a
-              (ta, scalar_t(-1.),
-               DMW_t(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0),
-               scalar_t(1.), bi);
-          trsv(ul, ta, d, a.tile(i, i).D(), bi,
-               params::task_recursion_cutoff_level);
-        }
-      } else {
-        for (int i=int(a.rowblocks())-1; i>=0; i--) {
-          DMW_t bi(a.tilecols(i), b.cols(), b, a.tilecoff(i), 0);
-          for (int j=int(a.colblocks())-1; j>i; j--)
-            (ta==Trans::N ? a.tile(i, j) : a.tile(j, i)).gemv_a
-              (ta, scalar_t(-1.),
-               DMW_t(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0),
-               scalar_t(1.), bi);
-          trsv(ul, ta, d, a.tile(i, i).D(), bi,
-               params::task_recursion_cutoff_level);
-        }
+      const bool down = (ul == UpLo::L) == (ta == Trans::N);
+      const int nb = a.rowblocks();
+      for (int ii=0; ii<nb; ii++) {
+        const int i = down ? ii : nb-1-ii;
+        DMW_t bi(a.tilecols(i), b.cols(), b, a.tilecoff(i), 0);
+        for (int j=(down ? 0 : i+1); j<(down ? i : nb); j++)
+          (ta==Trans::N ? a.tile(i, j) : a.tile(j, i)).gemv_a
+            (ta, scalar_t(-1.),
+             DMW_t(a.tilecols(j), b.cols(), b, a.tilecoff(j), 0),
+             scalar_t(1.), bi);
+        trsv(ul, ta, d, a.tile(i, i).D(), bi,
+             params::task_recursion_cutoff_level);
       }
     }
 
@@ -1833,16 +1813,98 @@ namespace strumpack {
     gemm(Trans ta, Trans tb, scalar_t alpha, const BLRMatrix<scalar_t>& A,
          const DenseMatrix<scalar_t>& B, scalar_t beta,
          DenseMatrix<scalar_t>& C, int task_depth) {
-      std::cout << "TODO gemm BLR*Dense+Dense" << std::endl;
+      using DMW_t = DenseMatrixWrapper<scalar_t>;
+      auto& Bc = const_cast<DenseMatrix<scalar_t>&>(B);
+      const auto imax = ta == Trans::N ? A.rowblocks() : A.colblocks();
+      const auto kmax = ta == Trans::N ? A.colblocks() : A.rowblocks();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+      for (std::size_t i=0; i<imax; i++) {
+        DMW_t Ci(ta==Trans::N ? A.tilerows(i) : A.tilecols(i), C.cols(), C,
+                 ta==Trans::N ? A.tileroff(i) : A.tilecoff(i), 0);
+        for (std::size_t k=0; k<kmax; k++) {
+          auto nk = ta==Trans::N ? A.tilecols(k) : A.tilerows(k);
+          auto ok = ta==Trans::N ? A.tilecoff(k) : A.tileroff(k);
+          DMW_t Bk = tb==Trans::N ? DMW_t(nk, B.cols(), Bc, ok, 0) :
+            DMW_t(B.rows(), nk, Bc, 0, ok);
+          gemm(ta, tb, alpha, ta==Trans::N ? A.tile(i, k) : A.tile(k, i),
+               Bk, k==0 ? beta : scalar_t(1.), Ci, task_depth);
+        }
+      }
     }
 
 
     // explicit template instantiations
+    /**
+     * Write the tiles of a BLRMatrix to a binary stream, low-rank
+     * tiles as U and V, dense tiles as D.
+     */
+    template<typename scalar_t> std::ofstream&
+    operator<<(std::ofstream& os, const BLRMatrix<scalar_t>& B) {
+      os.write((const char*)&B.m_, sizeof(std::size_t));
+      os.write((const char*)&B.n_, sizeof(std::size_t));
+      os.write((const char*)&B.nbrows_, sizeof(std::size_t));
+      os.write((const char*)&B.nbcols_, sizeof(std::size_t));
+      os.write((const char*)B.roff_.data(), sizeof(std::size_t)*(B.nbrows_+1));
+      os.write((const char*)B.coff_.data(), sizeof(std::size_t)*(B.nbcols_+1));
+      for (auto& b : B.blocks_) {
+        char t = !b ? 0 : (b->is_low_rank() ? 2 : 1);
+        os.write(&t, 1);
+        if (t == 1) os << b->D();
+        else if (t == 2) os << b->U() << b->V();
+      }
+      return os;
+    }
+
+    template<typename scalar_t> std::ifstream&
+    operator>>(std::ifstream& is, BLRMatrix<scalar_t>& B) {
+      std::size_t m = 0, n = 0, rb = 0, cb = 0;
+      is.read((char*)&m, sizeof(std::size_t));
+      is.read((char*)&n, sizeof(std::size_t));
+      is.read((char*)&rb, sizeof(std::size_t));
+      is.read((char*)&cb, sizeof(std::size_t));
+      if (!is) return is;
+      B = BLRMatrix<scalar_t>();
+      B.m_ = m;  B.n_ = n;
+      B.nbrows_ = rb;  B.nbcols_ = cb;
+      B.roff_.resize(rb+1);
+      B.coff_.resize(cb+1);
+      is.read((char*)B.roff_.data(), sizeof(std::size_t)*(rb+1));
+      is.read((char*)B.coff_.data(), sizeof(std::size_t)*(cb+1));
+      B.blocks_.resize(rb*cb);
+      for (auto& b : B.blocks_) {
+        char t = 0;
+        is.read(&t, 1);
+        if (t == 1) {
+          DenseMatrix<scalar_t> D;
+          is >> D;
+          b.reset(new DenseTile<scalar_t>(D));
+        } else if (t == 2) {
+          DenseMatrix<scalar_t> U, V;
+          is >> U >> V;
+          b.reset(new LRTile<scalar_t>(U.rows(), V.cols(), U.cols()));
+          b->U() = U;
+          b->V() = V;
+        }
+      }
+      return is;
+    }
+
     template class BLRMatrix<float>;
     template class BLRMatrix<double>;
     template class BLRMatrix<std::complex<float>>;
     template class BLRMatrix<std::complex<double>>;
 
+    template std::ofstream& operator<<(std::ofstream& os, const BLRMatrix<float>& B);
+    template std::ofstream& operator<<(std::ofstream& os, const BLRMatrix<double>& B);
+    template std::ofstream& operator<<(std::ofstream& os, const BLRMatrix<std::complex<float>>& B);
+    template std::ofstream& operator<<(std::ofstream& os, const BLRMatrix<std::complex<double>>& B);
+    template std::ifstream& operator>>(std::ifstream& is, BLRMatrix<float>& B);
+    template std::ifstream& operator>>(std::ifstream& is, BLRMatrix<double>& B);
+    template std::ifstream& operator>>(std::ifstream& is, BLRMatrix<std::complex<float>>& B);
+    template std::ifstream& operator>>(std::ifstream& is, BLRMatrix<std::complex<double>>& B);
+
     template void trsm(Side, UpLo, Trans, Diag, float, const BLRMatrix<float>&, DenseMatrix<float>&, int);
     template void trsm(Side, UpLo, Trans, Diag, double, const BLRMatrix<double>&, DenseMatrix<double>&, int);
     template void trsm(Side, UpLo, Trans, Diag, std::complex<float>, const BLRMatrix<std::complex<float>>&, DenseMatrix<std::complex<float>>&, int);
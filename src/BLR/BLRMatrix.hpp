@@ -36,6 +36,7 @@
 #include <memory>
 #include <functional>
 #include <algorithm>
+#include <fstream>
 
 #include "BLROptions.hpp"
 #include "BLRTileBLAS.hpp" // TODO remove
@@ -154,6 +155,11 @@ namespace strumpack {
       (const BLRMatrix<scalar_t>& F1, const BLRMatrix<scalar_t>& F2,
        DenseMatrix<scalar_t>& B1, DenseMatrix<scalar_t>& B2, int task_depth);
 
+      template<typename T> friend std::ofstream&
+      operator<<(std::ofstream& os, const BLRMatrix<T>& B);
+      template<typename T> friend std::ifstream&
+      operator>>(std::ifstream& is, BLRMatrix<T>& B);
+
     private:
       std::size_t m_ = 0, n_ = 0, nbrows_ = 0, nbcols_ = 0;
       std::vector<std::size_t> roff_, coff_;
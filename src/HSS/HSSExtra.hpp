@@ -28,6 +28,8 @@
 #ifndef HSS_EXTRA_HPP
 #define HSS_EXTRA_HPP
 
+#include <fstream>
+
 #include "dense/DenseMatrix.hpp"
 
 namespace strumpack {
@@ -198,6 +200,29 @@ namespace strumpack {
        */
       DenseMatrix<scalar_t>& Vhat() { return _Vt0; }
 
+      friend std::ofstream& operator<<
+      (std::ofstream& os, const HSSFactors<scalar_t>& F) {
+        std::size_t nc = F._ch.size(), npiv = F._piv.size();
+        os.write((const char*)&nc, sizeof(std::size_t));
+        for (auto& c : F._ch) os << c;
+        os << F._L << F._Vt0 << F._W1 << F._Q << F._D;
+        os.write((const char*)&npiv, sizeof(std::size_t));
+        os.write((const char*)(F._piv.data()), sizeof(int)*npiv);
+        return os;
+      }
+      friend std::ifstream& operator>>
+      (std::ifstream& is, HSSFactors<scalar_t>& F) {
+        std::size_t nc = 0, npiv = 0;
+        is.read((char*)&nc, sizeof(std::size_t));
+        F._ch.resize(nc);
+        for (auto& c : F._ch) is >> c;
+        is >> F._L >> F._Vt0 >> F._W1 >> F._Q >> F._D;
+        is.read((char*)&npiv, sizeof(std::size_t));
+        F._piv.resize(npiv);
+        is.read((char*)(F._piv.data()), sizeof(int)*npiv);
+        return is;
+      }
+
     private:
       std::vector<HSSFactors<scalar_t>> _ch;
       DenseMatrix<scalar_t> _L;   // (U.rows-U.cols x U.rows-U.cols),
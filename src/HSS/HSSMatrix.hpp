@@ -500,6 +500,21 @@ namespace strumpack {
        */
       static HSSMatrix<scalar_t> read(const std::string& fname);
 
+      /**
+       * Read this HSSMatrix<scalar_t> from a binary input stream,
+       * for instance as part of a larger file.
+       *
+       * \see write(std::ofstream&)
+       */
+      void read(std::ifstream& is) override;
+
+      /**
+       * Write this HSSMatrix<scalar_t> to a binary output stream.
+       *
+       * \see read(std::ifstream&)
+       */
+      void write(std::ofstream& os) const override;
+
     protected:
       HSSMatrix(std::size_t m, std::size_t n,
                 const opts_t& opts, bool active);
@@ -647,9 +662,6 @@ namespace strumpack {
       template<typename T> friend void draw
       (const HSSMatrix<T>& H, const std::string& name);
 
-      void read(std::ifstream& is) override;
-      void write(std::ofstream& os) const override;
-
       friend class HSSMatrixMPI<scalar_t>;
     };
 
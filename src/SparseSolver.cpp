@@ -60,6 +60,7 @@ namespace strumpack {
   SparseSolver<scalar_t,integer_t>::setup_tree() {
     tree_.reset(new EliminationTree<scalar_t,integer_t>
                 (opts_, *mat_, nd_->tree()));
+    tree_->set_Schur_root(!Schur_idx_.empty());
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -70,10 +71,19 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolver<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
-    if (p) return nd_->set_permutation(opts_, *mat_, p, base);
-    return nd_->nested_dissection
-      (opts_, *mat_, nx, ny, nz, components, width);
+   int components, int width, const double* coords, int d) {
+    int ierr = p ? nd_->set_permutation(opts_, *mat_, p, base) :
+      coords ? nd_->coordinate_nested_dissection
+      (opts_, *mat_, coords, d, components) :
+      nd_->nested_dissection(opts_, *mat_, nx, ny, nz, components, width);
+    if (ierr || Schur_idx_.empty()) return ierr;
+    if (matching_.job != MatchingJob::NONE) {
+      std::cerr << "ERROR: the Schur complement cannot be computed"
+                << " with matching" << std::endl;
+      return 1;
+    }
+    nd_->Schur_reordering(*mat_, Schur_idx_);
+    return 0;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -85,6 +95,7 @@ namespace strumpack {
   SparseSolver<scalar_t,integer_t>::set_matrix
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
+    clear_low_rank_update();
     factored_ = reordered_ = false;
   }
 
@@ -106,6 +117,8 @@ namespace strumpack {
    const scalar_t* values, bool symmetric_pattern) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
+    mat_->sort_indices();
+    clear_low_rank_update();
     factored_ = reordered_ = false;
   }
 
@@ -120,6 +133,7 @@ namespace strumpack {
     }
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
+    mat_->sort_indices();
     permute_matrix_values();
   }
 
@@ -133,6 +147,7 @@ namespace strumpack {
       if (opts_.compression() != CompressionType::NONE)
         separator_reordering();
     }
+    clear_low_rank_update();
     factored_ = false;
   }
 
@@ -148,7 +163,81 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolver<scalar_t,integer_t>::solve_internal
   (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    if (lr_U_.cols())
+      return solve_low_rank_update(b, x, use_initial_guess);
+    return solve_op(Trans::N, b, x, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_transposed_internal
+  (Trans op, const scalar_t* b, scalar_t* x, bool use_initial_guess) {
+    auto N = matrix()->size();
+    auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
+    DenseMW_t X(N, 1, x, N);
+    return solve_transposed_internal(op, *B, X, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_transposed_internal
+  (Trans op, const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    switch (opts_.compression()) {
+    case CompressionType::NONE:
+    case CompressionType::BLR:
+    case CompressionType::LOSSY:
+    case CompressionType::LOSSLESS: break;
+    default:
+      if (is_root_)
+        std::cerr << "# ERROR: transposed solve not supported with "
+                  << get_name(opts_.compression()) << " compression"
+                  << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (is_GPU(opts_)) {
+      if (is_root_)
+        std::cerr << "# ERROR: transposed solve not supported on GPU"
+                  << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (lr_U_.cols()) {
+      if (is_root_)
+        std::cerr << "# ERROR: transposed solve not supported with"
+                  << " a low-rank update" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (opts_.factorization_type() != FactorizationType::LU) {
+      // A is Hermitian (Cholesky) or complex symmetric (LDLt), so
+      // A^T or A^H is either A, or conj(A) which is solved as
+      // A conj(x) = conj(b)
+      bool herm = opts_.factorization_type() == FactorizationType::CHOLESKY;
+      if (!is_complex<scalar_t>() || (op == Trans::C) == herm)
+        return solve_op(Trans::N, b, x, use_initial_guess);
+      DenseM_t bc(b.rows(), b.cols());
+      for (std::size_t j=0; j<b.cols(); j++)
+        for (std::size_t i=0; i<b.rows(); i++) {
+          bc(i, j) = blas::my_conj(b(i, j));
+          if (use_initial_guess) x(i, j) = blas::my_conj(x(i, j));
+        }
+      auto ierr = solve_op(Trans::N, bc, x, use_initial_guess);
+      for (std::size_t j=0; j<x.cols(); j++)
+        for (std::size_t i=0; i<x.rows(); i++)
+          x(i, j) = blas::my_conj(x(i, j));
+      return ierr;
+    }
+    return solve_op(op, b, x, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_op
+  (Trans op, const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
     using real_t = typename RealType<scalar_t>::value_type;
+    if (!Schur_idx_.empty()) {
+      // the root front, holding the interface, is not factored
+      if (is_root_)
+        std::cerr << "# ERROR: solve not supported after"
+                  << " set_Schur_indices, use Schur_forward_solve and"
+                  << " Schur_backward_solve" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
     TaskTimer t("solve");
     this->perf_counters_start();
     t.start();
@@ -173,21 +262,47 @@ namespace strumpack {
     assert(N < std::numeric_limits<int>::max());
     DenseM_t bloc(b.rows(), d);
 
-    auto spmv = [&](const scalar_t* x, scalar_t* y)
-                { matrix()->spmv(x, y); };
+    auto spmv = [&](const scalar_t* x, scalar_t* y) {
+      if (op == Trans::N) matrix()->spmv(x, y);
+      else {
+        auto X = ConstDenseMatrixWrapperPtr(N, 1, x, N);
+        DenseMW_t Y(N, 1, y, N);
+        mat_->spmv(op, *X, Y);
+      }
+    };
     Krylov_its_ = 0;
 
     auto& P = reordering()->iperm();
 
-    std::vector<real_t> C(N, 1.);
-    if (equil_.type == EquilibrationType::COLUMN ||
-        equil_.type == EquilibrationType::BOTH)
-      for (integer_t i=0; i<N; i++) C[i] *= equil_.C[i];
-    if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
-      for (integer_t i=0; i<N; i++) C[i] *= matching_.C[i];
-
-    if (use_initial_guess &&
-        opts_.Krylov_solver() != KrylovSolver::DIRECT) {
+    std::vector<real_t> R, C;
+    scaling(R, C);
+
+    // row i of matrix() is row P[i] of R A C, column i is column
+    // Q[P[i]], so with op != N the roles of rows and columns, and of
+    // R and C, are swapped
+    auto col = [&](integer_t i) {
+      return opts_.matching() == MatchingJob::NONE ?
+        P[i] : matching_.Q[P[i]];
+    };
+    if (op != Trans::N) {
+      if (use_initial_guess &&
+          opts_.Krylov_solver() != KrylovSolver::DIRECT) {
+        for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+          for (integer_t i=0; i<N; i++) {
+            auto p = P[i];
+            bloc(i, j) = x(p, j) / R[p];
+          }
+        x.copy(bloc);
+      }
+      for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+        for (integer_t i=0; i<N; i++) {
+          auto q = col(i);
+          bloc(i, j) = C[q] * b(q, j);
+        }
+    } else if (use_initial_guess &&
+               opts_.Krylov_solver() != KrylovSolver::DIRECT) {
       if (opts_.matching() == MatchingJob::NONE)
         for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
@@ -204,88 +319,106 @@ namespace strumpack {
           }
       x.copy(bloc);
     }
-
-    {
-      std::vector<real_t> R(N, 1.);
-      if (equil_.type == EquilibrationType::ROW ||
-          equil_.type == EquilibrationType::BOTH)
-        for (integer_t i=0; i<N; i++) R[i] *= equil_.R[i];
-      if (this->reordered_ &&
-          opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
-        for (integer_t i=0; i<N; i++) R[i] *= matching_.R[i];
+    if (op == Trans::N)
       for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++) {
           auto p = P[i];
           bloc(i, j) = R[p] * b(p, j);
         }
-    }
 
     auto MFsolve =
       [&](scalar_t* w) {
         DenseMW_t X(x.rows(), 1, w, x.ld());
-        tree()->multifrontal_solve(X);
+        tree()->multifrontal_solve(X, op);
+      };
+    auto block_spmv = [&](const DenseM_t& X, DenseM_t& Y) {
+      if (op == Trans::N) matrix()->spmv(X, Y);
+      else mat_->spmv(op, X, Y);
+    };
+    auto block_MFsolve =
+      [&](DenseM_t& W) { tree()->multifrontal_solve(W, op); };
+    // with multiple right hand sides, use the block Krylov solvers,
+    // which apply the preconditioner to all right hand sides at once
+    auto gmres =
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& block_prec) {
+        if (x.cols() == 1)
+          iterative::GMRes<scalar_t>
+            (spmv, prec, x.rows(), x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockGMRes<scalar_t>
+            (block_spmv, block_prec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto bicgstab =
+      [&](const iterative::PREC<scalar_t>& prec,
+          const iterative::BlockPREC<scalar_t>& block_prec) {
+        if (x.cols() == 1)
+          iterative::BiCGStab<scalar_t>
+            (spmv, prec, x.rows(), x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockBiCGStab<scalar_t>
+            (block_spmv, block_prec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto refine =
+      [&]() {
+        if (op == Trans::N)
+          iterative::IterativeRefinement<scalar_t,integer_t>
+            (*matrix(), block_MFsolve, x, bloc, opts_.rel_tol(),
+             opts_.abs_tol(), Krylov_its_, opts_.maxit(), use_initial_guess,
+             opts_.verbose() && is_root_);
+        else
+          iterative::IterativeRefinement<scalar_t>
+            (block_spmv, block_MFsolve, x, bloc, opts_.rel_tol(),
+             opts_.abs_tol(), Krylov_its_, opts_.maxit(), use_initial_guess,
+             opts_.verbose() && is_root_);
       };
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
-        iterative::GMRes<scalar_t>
-          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-           opts_.gmres_restart(), opts_.GramSchmidt_type(),
-           use_initial_guess, opts_.verbose() && is_root_);
-      else
-        iterative::IterativeRefinement<scalar_t,integer_t>
-          (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-           x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-           Krylov_its_, opts_.maxit(), use_initial_guess,
-           opts_.verbose() && is_root_);
+      if (opts_.compression() != CompressionType::NONE)
+        gmres(MFsolve, block_MFsolve);
+      else refine();
     }; break;
     case KrylovSolver::DIRECT: {
       x = bloc;
-      tree()->multifrontal_solve(x);
+      tree()->multifrontal_solve(x, op);
     }; break;
     case KrylovSolver::REFINE: {
-      iterative::IterativeRefinement<scalar_t,integer_t>
-        (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-         x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-         Krylov_its_, opts_.maxit(), use_initial_guess,
-         opts_.verbose() && is_root_);
+      refine();
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      gmres(MFsolve, block_MFsolve);
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      bicgstab(MFsolve, block_MFsolve);
     }; break;
     case KrylovSolver::GMRES: { // see above
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
-    }
+      gmres([](scalar_t*) {}, [](DenseM_t&) {});
+    }; break;
     case KrylovSolver::BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
-    }
+      bicgstab([](scalar_t*) {}, [](DenseM_t&) {});
+    }; break;
     }
 
-    if (opts_.matching() == MatchingJob::NONE) {
+    if (op != Trans::N)
+      for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+        for (integer_t i=0; i<N; i++) {
+          auto p = P[i];
+          bloc(p, j) = x(i, j) * R[p];
+        }
+    else if (opts_.matching() == MatchingJob::NONE) {
       auto& Pi = reordering()->perm();
       for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
@@ -306,11 +439,401 @@ namespace strumpack {
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_sparse
+  (const DenseM_t& b, DenseM_t& x, const std::vector<integer_t>& b_nz,
+   const std::vector<integer_t>& x_idx) {
+    if (!this->reordered_) {
+      ReturnCode ierr = this->reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    // map the indices to the rows of the permuted system, see
+    // solve_internal
+    integer_t N = matrix()->size();
+    auto& Pi = reordering()->perm();
+    std::vector<integer_t> pb(b_nz.size()), px(x_idx.size());
+    for (std::size_t i=0; i<b_nz.size(); i++)
+      pb[i] = Pi[b_nz[i]];
+    if (opts_.matching() == MatchingJob::NONE)
+      for (std::size_t i=0; i<x_idx.size(); i++)
+        px[i] = Pi[x_idx[i]];
+    else {
+      std::vector<integer_t> Qinv(N);
+      for (integer_t i=0; i<N; i++)
+        Qinv[matching_.Q[i]] = i;
+      for (std::size_t i=0; i<x_idx.size(); i++)
+        px[i] = Pi[Qinv[x_idx[i]]];
+    }
+    // the Woodbury formula needs all entries of A^{-1} b
+    if (!lr_U_.cols())
+      tree()->set_solve_pattern(pb, px);
+    auto ks = opts_.Krylov_solver();
+    opts_.set_Krylov_solver(KrylovSolver::DIRECT);
+    auto ierr = this->solve(b, x);
+    opts_.set_Krylov_solver(ks);
+    tree()->clear_solve_pattern();
+    return ierr;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::add_low_rank_update
+  (const DenseM_t& U, const DenseM_t& V) {
+    assert(mat_ && U.rows() == std::size_t(mat_->size()) &&
+           V.rows() == U.rows() && V.cols() == U.cols());
+    if (!U.cols()) return ReturnCode::SUCCESS;
+    if (!this->reordered_) {
+      ReturnCode ierr = this->reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    std::size_t r = lr_U_.cols() + U.cols();
+    if (r > std::size_t(opts_.low_rank_update_max_rank()) &&
+        opts_.factorization_type() == FactorizationType::LU) {
+      DenseM_t Ur(lr_U_), Vr(lr_V_);
+      if (Ur.cols()) { Ur.hconcat(U); Vr.hconcat(V); }
+      else { Ur = U; Vr = V; }
+      if (add_low_rank_update_to_matrix(Ur, Vr)) {
+        if (opts_.verbose() && is_root_)
+          std::cout << "# low-rank update of rank " << r
+                    << " added to the matrix, refactoring" << std::endl;
+        clear_low_rank_update();
+        factored_ = false;
+        return this->factor();
+      }
+      if (opts_.verbose() && is_root_)
+        std::cout << "# WARNING: low-rank update does not fit in the"
+                  << " sparsity pattern, using the Woodbury formula"
+                  << " with rank " << r << std::endl;
+    }
+    // solve with A, without the updates registered so far
+    DenseM_t W(U.rows(), U.cols());
+    auto ierr = solve_op(Trans::N, U, W, false);
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    // only keep the update when K is nonsingular
+    DenseM_t Ur(lr_U_), Vr(lr_V_), Wr(lr_W_);
+    if (Ur.cols()) { Ur.hconcat(U); Vr.hconcat(V); Wr.hconcat(W); }
+    else { Ur = U; Vr = V; Wr = std::move(W); }
+    DenseM_t K(r, r);
+    gemm(Trans::T, Trans::N, scalar_t(1.), Vr, Wr, scalar_t(0.), K);
+    auto nrm = K.normF();
+    for (std::size_t i=0; i<r; i++) K(i, i) += scalar_t(1.);
+    // a pivot which is small compared to I + V^T W, up to the
+    // accuracy of W, means K is (numerically) singular, and so is
+    // A + U V^T
+    std::vector<int> piv;
+    bool singular = K.LU(piv);
+    real_t tol = std::max
+      (real_t(opts_.rel_tol()), std::sqrt(blas::lamch<real_t>('E')));
+    for (std::size_t i=0; i<r; i++)
+      if (std::abs(K(i, i)) <= tol * (real_t(1.) + nrm))
+        singular = true;
+    if (singular) {
+      if (is_root_)
+        std::cerr << "# ERROR: low-rank update, the capacitance matrix"
+                  << " I + V^T A^{-1} U is singular, the update is"
+                  << " not applied" << std::endl;
+      return ReturnCode::INVALID_ARGUMENT;
+    }
+    lr_U_ = std::move(Ur);
+    lr_V_ = std::move(Vr);
+    lr_W_ = std::move(Wr);
+    lr_K_ = std::move(K);
+    lr_piv_ = std::move(piv);
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::clear_low_rank_update() {
+    lr_U_.clear();
+    lr_V_.clear();
+    lr_W_.clear();
+    lr_K_.clear();
+    lr_piv_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_low_rank_update
+  (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    // (A + U V^T)^{-1} b = y - W K^{-1} V^T y, with y = A^{-1} b,
+    // the initial guess is for A + U V^T, not for A, so it is ignored
+    auto ierr = solve_op(Trans::N, b, x, false);
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    DenseM_t t(lr_V_.cols(), x.cols());
+    gemm(Trans::T, Trans::N, scalar_t(1.), lr_V_, x, scalar_t(0.), t);
+    lr_K_.solve_LU_in_place(t, lr_piv_);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), lr_W_, t, scalar_t(1.), x);
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolver<scalar_t,integer_t>::add_low_rank_update_to_matrix
+  (const DenseM_t& U, const DenseM_t& V) {
+    // entry (i,j) of matrix() is R[p] A(p,q) C[q], with p = P[i] and
+    // q = col(j), see solve_op
+    integer_t N = matrix()->size(), r = U.cols();
+    auto& P = reordering()->iperm();
+    auto col = [&](integer_t i) {
+      return opts_.matching() == MatchingJob::NONE ?
+        P[i] : matching_.Q[P[i]];
+    };
+    std::vector<real_t> R, C;
+    scaling(R, C);
+    // U V^T fits in the sparsity pattern if the entries in the
+    // pattern have the same Frobenius norm as U V^T, which is
+    // computed as trace(U^H U (V^H V)^H)
+    DenseM_t GU(r, r), GV(r, r);
+    gemm(Trans::C, Trans::N, scalar_t(1.), U, U, scalar_t(0.), GU);
+    gemm(Trans::C, Trans::N, scalar_t(1.), V, V, scalar_t(0.), GV);
+    real_t nrm2 = 0.;
+    for (integer_t l=0; l<r; l++)
+      for (integer_t k=0; k<r; k++)
+        nrm2 += std::real(GU(k, l) * blas::my_conj(GV(l, k)));
+    auto ptr = matrix()->ptr();
+    auto ind = matrix()->ind();
+    auto val = matrix()->val();
+    std::vector<scalar_t> dv(matrix()->nnz());
+    real_t in2 = 0.;
+#pragma omp parallel for reduction(+:in2)
+    for (integer_t i=0; i<N; i++) {
+      auto p = P[i];
+      for (integer_t j=ptr[i]; j<ptr[i+1]; j++) {
+        auto q = col(ind[j]);
+        scalar_t uv(0.);
+        for (integer_t k=0; k<r; k++)
+          uv += U(p, k) * V(q, k);
+        in2 += std::norm(uv);
+        dv[j] = R[p] * uv * C[q];
+      }
+    }
+    auto nU = U.normF(), nV = V.normF();
+    if (nrm2 - in2 > real_t(1e3) * blas::lamch<real_t>('E') *
+        nU * nU * nV * nV)
+      return false;
+    for (std::size_t j=0; j<dv.size(); j++)
+      val[j] += dv[j];
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::set_Schur_indices
+  (const std::vector<integer_t>& S) {
+    Schur_idx_ = S;
+    // the matching permutes the columns, not the rows
+    if (!S.empty()) opts_.set_matching(MatchingJob::NONE);
+    factored_ = reordered_ = false;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::scaling
+  (std::vector<real_t>& R, std::vector<real_t>& C) const {
+    // the row and column scaling of matrix(), from the equilibration
+    // and the matching
+    integer_t N = matrix()->size();
+    R.assign(N, 1.);
+    C.assign(N, 1.);
+    if (equil_.type == EquilibrationType::ROW ||
+        equil_.type == EquilibrationType::BOTH)
+      for (integer_t i=0; i<N; i++) R[i] = equil_.R[i];
+    if (equil_.type == EquilibrationType::COLUMN ||
+        equil_.type == EquilibrationType::BOTH)
+      for (integer_t i=0; i<N; i++) C[i] = equil_.C[i];
+    if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+      for (integer_t i=0; i<N; i++) {
+        R[i] *= matching_.R[i];
+        C[i] *= matching_.C[i];
+      }
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::no_Schur_indices() const {
+    if (is_root_)
+      std::cerr << "# ERROR: no Schur complement interface, call"
+                << " set_Schur_indices first" << std::endl;
+    return ReturnCode::NOT_SUPPORTED;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::Schur_complement(DenseM_t& S) {
+    if (Schur_idx_.empty()) return no_Schur_indices();
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    // undo the equilibration, the Schur complement of R A C is
+    // R_S (A_SS - A_SI A_II^{-1} A_IS) C_S
+    std::vector<real_t> R, C;
+    scaling(R, C);
+    auto& Pi = reordering()->perm();
+    auto& F = tree()->Schur_complement();
+    integer_t nS = Schur_idx_.size(), sb = matrix()->size() - nS;
+    S = DenseM_t(nS, nS);
+    for (integer_t j=0; j<nS; j++) {
+      auto sj = Schur_idx_[j];
+      for (integer_t i=0; i<nS; i++) {
+        auto si = Schur_idx_[i];
+        S(i, j) = F(Pi[si]-sb, Pi[sj]-sb) / (R[si] * C[sj]);
+      }
+    }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::Schur_forward_solve
+  (const DenseM_t& b, DenseM_t& x, DenseM_t& g) {
+    if (Schur_idx_.empty()) return no_Schur_indices();
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    integer_t N = matrix()->size(), d = b.cols(), nS = Schur_idx_.size();
+    if (b.rows() != std::size_t(N) || x.rows() != std::size_t(N) ||
+        x.cols() != std::size_t(d)) {
+      if (is_root_)
+        std::cerr << "# ERROR: Schur_forward_solve, b and x should be "
+                  << N << " x " << d << std::endl;
+      return ReturnCode::INVALID_ARGUMENT;
+    }
+    std::vector<real_t> R, C;
+    scaling(R, C);
+    auto& P = reordering()->iperm();
+    auto& Pi = reordering()->perm();
+    for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+      for (integer_t i=0; i<N; i++) {
+        auto p = P[i];
+        x(i, j) = R[p] * b(p, j);
+      }
+    tree()->forward_Schur_solve(x);
+    g = DenseM_t(nS, d);
+    for (integer_t j=0; j<d; j++)
+      for (integer_t k=0; k<nS; k++) {
+        auto s = Schur_idx_[k];
+        g(k, j) = x(Pi[s], j) / R[s];
+      }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::Schur_backward_solve
+  (const DenseM_t& xS, DenseM_t& x) {
+    if (Schur_idx_.empty()) return no_Schur_indices();
+    if (!this->factored_) {
+      if (is_root_)
+        std::cerr << "# ERROR: Schur_backward_solve requires the"
+                  << " factors, call Schur_forward_solve first"
+                  << std::endl;
+      return ReturnCode::INVALID_ARGUMENT;
+    }
+    integer_t N = matrix()->size(), d = x.cols(), nS = Schur_idx_.size();
+    if (x.rows() != std::size_t(N) || xS.rows() != std::size_t(nS) ||
+        xS.cols() != std::size_t(d)) {
+      if (is_root_)
+        std::cerr << "# ERROR: Schur_backward_solve, xS should be "
+                  << nS << " x " << d << " and x " << N << " x " << d
+                  << std::endl;
+      return ReturnCode::INVALID_ARGUMENT;
+    }
+    std::vector<real_t> R, C;
+    scaling(R, C);
+    auto& Pi = reordering()->perm();
+    for (integer_t j=0; j<d; j++)
+      for (integer_t k=0; k<nS; k++) {
+        auto s = Schur_idx_[k];
+        x(Pi[s], j) = xS(k, j) / C[s];
+      }
+    tree()->backward_Schur_solve(x);
+    DenseM_t xloc(N, d);
+    for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+      for (integer_t i=0; i<N; i++)
+        xloc(i, j) = x(Pi[i], j) * C[i];
+    x.copy(xloc);
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::delete_factors_internal() {
     tree_.reset(nullptr);
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolver<scalar_t,integer_t>::write_factors(std::ofstream& os) const {
+    if (!mat_ || !nd_ || !tree_) return false;
+    // the matrix after matching, scaling and permutation, as used
+    // for iterative refinement or as preconditioner in the solve
+    std::int64_t n = mat_->size(), nnz = mat_->nnz();
+    char symm = mat_->symm_sparse();
+    io::write_binary(os, n);
+    io::write_binary(os, nnz);
+    io::write_binary(os, symm);
+    os.write((const char*)mat_->ptr(), sizeof(integer_t)*(n+1));
+    os.write((const char*)mat_->ind(), sizeof(integer_t)*nnz);
+    os.write((const char*)mat_->val(), sizeof(scalar_t)*nnz);
+    nd_->write_permutation(os);
+    return tree_->write_factors(os);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolver<scalar_t,integer_t>::read_factors
+  (std::ifstream& is, std::unique_ptr<io::MappedFile> f) {
+    std::int64_t n = 0, nnz = 0;
+    char symm = 0;
+    io::read_binary(is, n);
+    io::read_binary(is, nnz);
+    io::read_binary(is, symm);
+    if (!is || n < 0 || nnz < 0 ||
+        n > std::numeric_limits<integer_t>::max() - 1 ||
+        nnz > std::numeric_limits<integer_t>::max() ||
+        std::uint64_t(n+1) * sizeof(integer_t) +
+        std::uint64_t(nnz) * (sizeof(integer_t) + sizeof(scalar_t)) >
+        io::remaining(is))
+      return false;
+    std::vector<integer_t> ptr(n+1), ind(nnz);
+    std::vector<scalar_t> val(nnz);
+    is.read((char*)ptr.data(), sizeof(integer_t)*(n+1));
+    is.read((char*)ind.data(), sizeof(integer_t)*nnz);
+    is.read((char*)val.data(), sizeof(scalar_t)*nnz);
+    if (!is || ptr[0] != 0 || ptr[n] != nnz) return false;
+    for (std::int64_t i=0; i<n; i++)
+      if (ptr[i] > ptr[i+1]) return false;
+    for (std::int64_t i=0; i<nnz; i++)
+      if (ind[i] < 0 || ind[i] >= n) return false;
+    mat_.reset(new CSRMatrix<scalar_t,integer_t>
+               (n, ptr.data(), ind.data(), val.data(), symm));
+    nd_.reset(new MatrixReordering<scalar_t,integer_t>(n));
+    nd_->read_permutation(is);
+    auto& P = nd_->perm();
+    auto& Pi = nd_->iperm();
+    if (!is || P.size() != std::size_t(n) || Pi.size() != std::size_t(n))
+      return false;
+    for (std::int64_t i=0; i<n; i++)
+      if (P[i] < 0 || P[i] >= n || Pi[P[i]] != i) return false;
+    // the matching and equilibration, read before, should match n
+    auto N = std::size_t(n);
+    if (matching_.job != MatchingJob::NONE) {
+      if (matching_.Q.size() != N) return false;
+      for (auto q : matching_.Q)
+        if (q < 0 || q >= n) return false;
+    }
+    if (matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING &&
+        (matching_.R.size() != N || matching_.C.size() != N))
+      return false;
+    if (((equil_.type == EquilibrationType::ROW ||
+          equil_.type == EquilibrationType::BOTH) && equil_.R.size() != N) ||
+        ((equil_.type == EquilibrationType::COLUMN ||
+          equil_.type == EquilibrationType::BOTH) && equil_.C.size() != N))
+      return false;
+    tree_.reset(new EliminationTree<scalar_t,integer_t>());
+    if (!is || !tree_->read_factors(is, std::move(f), n)) {
+      tree_.reset();
+      return false;
+    }
+    return true;
+  }
+
   // explicit template instantiations
   template class SparseSolver<float,int>;
   template class SparseSolver<double,int>;
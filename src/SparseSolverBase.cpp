@@ -33,10 +33,12 @@
 
 #include "misc/Tools.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/Trace.hpp"
 #include "StrumpackOptions.hpp"
 #include "sparse/ordering/MatrixReordering.hpp"
 #include "sparse/EliminationTree.hpp"
 #include "sparse/iterative/IterativeSolvers.hpp"
+#include "sparse/fronts/FrontFactory.hpp"
 #if defined(STRUMPACK_USE_CUDA)
 #include "dense/CUDAWrapper.hpp"
 #else
@@ -100,6 +102,18 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t>
   SparseSolverBase<scalar_t,integer_t>::~SparseSolverBase() {
     std::set_new_handler(old_handler_);
+    if (tracing_) {
+      trace::write(opts_.trace_file());
+      trace::disable();
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::trace_enable() {
+    // enable once per solver, matched by disable in the destructor
+    if (tracing_ || opts_.trace_file().empty()) return;
+    trace::enable();
+    tracing_ = true;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -150,6 +164,11 @@ namespace strumpack {
     return tree()->factor_nonzeros() * sizeof(scalar_t);
   }
 
+  template<typename scalar_t,typename integer_t> std::size_t
+  SparseSolverBase<scalar_t,integer_t>::CB_stack_peak_memory() const {
+    return tree()->CB_stack_peak() * sizeof(scalar_t);
+  }
+
   template<typename scalar_t,typename integer_t> int
   SparseSolverBase<scalar_t,integer_t>::Krylov_iterations() const {
     return Krylov_its_;
@@ -303,14 +322,21 @@ namespace strumpack {
     return reorder_internal(p, base, 1, 1, 1, 1, 1);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::reorder
+  (const double* coords, int d, int components) {
+    return reorder_internal(nullptr, 0, 1, 1, 1, components, 1, coords, d);
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::reorder_internal
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const double* coords, int d) {
     if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
     if (reordered_) return ReturnCode::SUCCESS;
     TaskTimer t1("permute-scale");
     int ierr;
+    check_factorization_type();
     if (opts_.matching() != MatchingJob::NONE) {
       if (opts_.verbose() && is_root_)
         std::cout << "# matching job: " << get_description(opts_.matching())
@@ -323,8 +349,11 @@ namespace strumpack {
       }
     }
 
-    equil_ = matrix()->equilibration();
-    matrix()->equilibrate(equil_);
+    // (row or column) equilibration destroys the symmetry
+    if (!symmetric_factorization()) {
+      equil_ = matrix()->equilibration();
+      matrix()->equilibrate(equil_);
+    }
     if (opts_.verbose() && is_root_)
       std::cout << "# matrix equilibration, r_cond = "
                 << equil_.rcond << " , c_cond = " << equil_.ccond
@@ -346,7 +375,8 @@ namespace strumpack {
     perf_counters_start();
     t3.start();
     setup_reordering();
-    ierr = compute_reordering(p, base, nx, ny, nz, components, width);
+    ierr = compute_reordering
+      (p, base, nx, ny, nz, components, width, coords, d);
     if (ierr) {
       std::cerr << "ERROR: nested dissection went wrong, ierr="
                 << ierr << std::endl;
@@ -374,6 +404,17 @@ namespace strumpack {
         std::cout << "# symbolic factorization:" << std::endl;
         std::cout << "#   - nr of dense Frontal matrices = "
                   << number_format_with_commas(fc.dense) << std::endl;
+        auto& am = tree()->amalgamation();
+        if (am.fronts_before) {
+          std::cout << "#   - amalgamation: nr of fronts = "
+                    << number_format_with_commas(am.fronts_before) << " -> "
+                    << number_format_with_commas(am.fronts_after)
+                    << std::endl;
+          std::cout << "#   - amalgamation: dense factor nonzeros = "
+                    << number_format_with_commas(am.nnz_before) << " -> "
+                    << number_format_with_commas(am.nnz_after)
+                    << std::endl;
+        }
         switch (opts_.compression()) {
         case CompressionType::HSS:
           std::cout << "#   - nr of HSS Frontal matrices = "
@@ -401,6 +442,9 @@ namespace strumpack {
         case CompressionType::NONE:
         default: break;
         }
+        std::cout << "#   - CB stack peak memory (sequential) = "
+                  << float(CB_stack_peak_memory()) / 1.e6
+                  << " MB" << std::endl;
         std::cout << "#   - symb-factor time = " << t0.elapsed() << std::endl;
       }
     }
@@ -508,6 +552,36 @@ namespace strumpack {
     std::cout << "# --------------------------------------------" << std::endl << std::endl;
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolverBase<scalar_t,integer_t>::symmetric_factorization_supported()
+    const {
+    return opts_.compression() == CompressionType::NONE && !is_GPU(opts_);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::check_factorization_type() {
+    if (!symmetric_factorization()) return;
+    // the matrix can only be permuted symmetrically, so the matching
+    // and equilibration should not have been applied
+    if (!symmetric_factorization_supported() ||
+        (reordered_ && (matching_.job != MatchingJob::NONE ||
+                        equil_.type != EquilibrationType::NONE))) {
+      if (is_root_)
+        std::cerr << "# WARNING: " << get_name(opts_.factorization_type())
+                  << " factorization is not supported with these options,"
+                  << " using lu instead" << std::endl;
+      opts_.set_factorization_type(FactorizationType::LU);
+      return;
+    }
+    if (opts_.matching() != MatchingJob::NONE) {
+      if (opts_.verbose() && is_root_)
+        std::cout << "# disabling matching for the "
+                  << get_name(opts_.factorization_type())
+                  << " factorization" << std::endl;
+      opts_.set_matching(MatchingJob::NONE);
+    }
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::factor() {
     if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
@@ -516,6 +590,7 @@ namespace strumpack {
       ReturnCode ierr = reorder();
       if (ierr != ReturnCode::SUCCESS) return ierr;
     }
+    check_factorization_type();
     using real_t = typename RealType<scalar_t>::value_type;
     opts_.set_pivot_threshold
       (std::sqrt(blas::lamch<real_t>('E')) * matrix()->norm1());
@@ -533,6 +608,7 @@ namespace strumpack {
                   << " enabled" << std::endl;
       }
     }
+    trace_enable();
     perf_counters_start();
     flop_breakdown_reset();
     TaskTimer t1("Sparse-factorization", [&]() {
@@ -555,10 +631,10 @@ namespace strumpack {
         std::cout << "#   - factor flop rate = " << ftot_ / t1.elapsed() / 1e9
                   << " GFlop/s" << std::endl;
         std::cout << "#   - factor peak memory usage (estimate) = "
-                  << double(params::peak_memory) / 1.0e6
+                  << double(params::memory.peak()) / 1.0e6
                   << " MB" << std::endl;
         std::cout << "#   - factor peak device memory usage (estimate) = "
-                  << double(params::peak_device_memory)/1.e6
+                  << double(params::device_memory.peak())/1.e6
                   << " MB" << std::endl;
 #endif
         if (opts_.compression() != CompressionType::NONE) {
@@ -625,15 +701,180 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve
   (const scalar_t* b, scalar_t* x, bool use_initial_guess) {
+    trace_enable();
     return solve_internal(b, x, use_initial_guess);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve
   (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    trace_enable();
     return solve_internal(b, x, use_initial_guess);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve
+  (Trans op, const scalar_t* b, scalar_t* x, bool use_initial_guess) {
+    trace_enable();
+    if (op == Trans::N) return solve_internal(b, x, use_initial_guess);
+    return solve_transposed_internal(op, b, x, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve
+  (Trans op, const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    trace_enable();
+    if (op == Trans::N) return solve_internal(b, x, use_initial_guess);
+    return solve_transposed_internal(op, b, x, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve_transposed_internal
+  (Trans op, const scalar_t* b, scalar_t* x, bool use_initial_guess) {
+    if (is_root_)
+      std::cerr << "# ERROR: transposed solve not supported by this solver"
+                << std::endl;
+    return ReturnCode::NOT_SUPPORTED;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve_transposed_internal
+  (Trans op, const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
+    if (is_root_)
+      std::cerr << "# ERROR: transposed solve not supported by this solver"
+                << std::endl;
+    return ReturnCode::NOT_SUPPORTED;
+  }
+
+  namespace {
+    // identifies a file written by SparseSolverBase::save_factors
+    const char factor_file_magic[8] = {'S','P','F','A','C','T','O','R'};
+    // increment when the layout of the factor file changes
+    const std::uint32_t factor_file_version = 2;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::save_factors
+  (const std::string& fname) const {
+    if (!factored_) {
+      std::cerr << "# ERROR: save_factors called before factor"
+                << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    TaskTimer t("save_factors");
+    t.start();
+    std::ofstream os(fname, std::ios::out | std::ios::trunc |
+                     std::ios::binary);
+    if (!os) {
+      std::cerr << "# ERROR: could not open " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    int v[3];
+    get_version(v[0], v[1], v[2]);
+    os.write(factor_file_magic, sizeof(factor_file_magic));
+    io::write_binary(os, factor_file_version);
+    io::write_binary(os, v);
+    // check on load that the types match
+    std::int32_t types[3] =
+      {int(sizeof(scalar_t)), is_complex<scalar_t>(), int(sizeof(integer_t))};
+    io::write_binary(os, types);
+    std::int32_t o[2] =
+      {int(opts_.compression()), int(opts_.matching())};
+    io::write_binary(os, o);
+    io::write_binary(os, int(matching_.job));
+    io::write_binary(os, matching_.Q);
+    io::write_binary(os, matching_.R);
+    io::write_binary(os, matching_.C);
+    io::write_binary(os, int(equil_.type));
+    io::write_binary(os, equil_.R);
+    io::write_binary(os, equil_.C);
+    if (!write_factors(os) || !os) {
+      std::cerr << "# ERROR: writing factors to " << fname
+                << " failed" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    t.stop();
+    if (opts_.verbose() && is_root_)
+      std::cout << "# saved factors to " << fname << ", "
+                << double(os.tellp()) / 1.e6 << " MB, in "
+                << t.elapsed() << " sec" << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::load_factors
+  (const std::string& fname) {
+    TaskTimer t("load_factors");
+    t.start();
+    std::ifstream is(fname, std::ios::in | std::ios::binary);
+    if (!is) {
+      std::cerr << "# ERROR: could not open " << fname << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    char magic[sizeof(factor_file_magic)];
+    std::uint32_t fversion = 0;
+    int v[3], vf[3];
+    std::int32_t types[3], o[2];
+    is.read(magic, sizeof(magic));
+    io::read_binary(is, fversion);
+    io::read_binary(is, vf);
+    io::read_binary(is, types);
+    if (!is || !std::equal(magic, magic+sizeof(magic), factor_file_magic)) {
+      std::cerr << "# ERROR: " << fname
+                << " is not a STRUMPACK factor file" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (fversion != factor_file_version) {
+      std::cerr << "# ERROR: " << fname << " has factor file format "
+                << fversion << ", expected " << factor_file_version
+                << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    if (types[0] != int(sizeof(scalar_t)) ||
+        types[1] != is_complex<scalar_t>() ||
+        types[2] != int(sizeof(integer_t))) {
+      std::cerr << "# ERROR: " << fname << " was written by a solver"
+                << " with a different scalar or integer type"
+                << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    get_version(v[0], v[1], v[2]);
+    if (v[0] != vf[0] || v[1] != vf[1] || v[2] != vf[2])
+      std::cerr << "Warning, file was created with a different"
+                << " strumpack version (v"
+                << vf[0] << "." << vf[1] << "." << vf[2]
+                << " instead of v"
+                << v[0] << "." << v[1] << "." << v[2]
+                << ")" << std::endl;
+    int mjob = 0, etype = 0;
+    io::read_binary(is, o);
+    io::read_binary(is, mjob);
+    io::read_binary(is, matching_.Q);
+    io::read_binary(is, matching_.R);
+    io::read_binary(is, matching_.C);
+    io::read_binary(is, etype);
+    io::read_binary(is, equil_.R);
+    io::read_binary(is, equil_.C);
+    opts_.set_compression(CompressionType(o[0]));
+    opts_.set_matching(MatchingJob(o[1]));
+    matching_.job = MatchingJob(mjob);
+    equil_.type = EquilibrationType(etype);
+    std::unique_ptr<io::MappedFile> f(new io::MappedFile(fname));
+    if (!f->good()) f.reset();
+    factored_ = reordered_ = false;
+    if (!is || !read_factors(is, std::move(f))) {
+      std::cerr << "# ERROR: reading factors from " << fname
+                << " failed" << std::endl;
+      return ReturnCode::FILE_ERROR;
+    }
+    factored_ = reordered_ = true;
+    t.stop();
+    if (opts_.verbose() && is_root_)
+      std::cout << "# loaded factors from " << fname << " in "
+                << t.elapsed() << " sec" << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolverBase<scalar_t,integer_t>::delete_factors() {
     delete_factors_internal();
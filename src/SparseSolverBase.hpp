@@ -42,6 +42,7 @@
 #include "StrumpackOptions.hpp"
 #include "sparse/CSRMatrix.hpp"
 #include "dense/DenseMatrix.hpp"
+#include "misc/BinaryIO.hpp"
 
 /**
  * All of STRUMPACK is contained in the strumpack namespace.
@@ -158,6 +159,27 @@ namespace strumpack {
      */
     ReturnCode reorder(const int* p, int base=0);
 
+    /**
+     * Perform sparse matrix reordering, using a nested dissection
+     * based on the coordinates of the mesh points, for unstructured
+     * meshes. The subgraphs are recursively split along a coordinate
+     * direction (or along the principal direction, see
+     * SPOptions::enable_inertial_bisection), and vertex separators
+     * are extracted from the graph. This ignores the reordering
+     * method selected in the options struct.
+     *
+     * \param coords coordinates of the rows, d values per row, row
+     * after row. For the distributed solver, these are the
+     * coordinates of the local rows.
+     * \param d number of coordinates (spatial dimension)
+     * \param components number of degrees of freedom per mesh
+     * point. These should be ordered consecutively, and are kept
+     * together in the ordering. The number of rows should be a
+     * multiple of components.
+     * \return error code
+     */
+    ReturnCode reorder(const double* coords, int d, int components=1);
+
     /**
      * Perform numerical factorization of the sparse input matrix.
      *
@@ -229,6 +251,43 @@ namespace strumpack {
     ReturnCode solve(const DenseM_t& b, DenseM_t& x,
                      bool use_initial_guess=false);
 
+    /**
+     * Solve a linear system with the transpose (op = Trans::T) or the
+     * conjugate transpose (op = Trans::C) of the matrix, using the
+     * same factorization as solve(b, x). With op = Trans::N this is
+     * the same as solve(b, x). This is currently only supported by
+     * the sequential/multithreaded solver, without GPU, and with
+     * dense, BLR or lossy compressed fronts, otherwise
+     * ReturnCode::NOT_SUPPORTED is returned.
+     *
+     * \param op Trans::N, Trans::T or Trans::C
+     * \param b input, will not be modified. Pointer to the right-hand
+     * side, see solve(const scalar_t*, scalar_t*, bool).
+     * \param x Output, pointer to the solution vector.
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code
+     */
+    ReturnCode solve(Trans op, const scalar_t* b, scalar_t* x,
+                     bool use_initial_guess=false);
+
+    /**
+     * Solve a linear system with the transpose (op = Trans::T) or the
+     * conjugate transpose (op = Trans::C) of the matrix, with a single
+     * or multiple right-hand sides, see solve(Trans, const scalar_t*,
+     * scalar_t*, bool).
+     *
+     * \param op Trans::N, Trans::T or Trans::C
+     * \param b input, will not be modified. DenseMatrix containing
+     * the right-hand side vector/matrix.
+     * \param x Output, the solution vector/matrix.
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code
+     */
+    ReturnCode solve(Trans op, const DenseM_t& b, DenseM_t& x,
+                     bool use_initial_guess=false);
+
     /**
      * Return the object holding the options for this sparse solver.
      */
@@ -286,6 +345,18 @@ namespace strumpack {
      */
     std::size_t factor_memory() const;
 
+    /**
+     * Return the predicted peak memory (in bytes) of the stack of
+     * contribution blocks, the update matrices which are passed from
+     * a front to its parent, for a sequential traversal of the
+     * elimination tree. The children of each front are visited in
+     * the order which minimizes this peak. This is available after
+     * the reordering, before the numerical factorization. For the
+     * distributed memory solvers, this is for the part of the tree
+     * on this process.
+     */
+    std::size_t CB_stack_peak_memory() const;
+
     /**
      * Return the number of iterations performed by the outer (Krylov)
      * iterative solver. Call this after calling the solve routine.
@@ -310,13 +381,51 @@ namespace strumpack {
      */
     void delete_factors();
 
+    /**
+     * Save the complete factorization to a binary file: the
+     * (permuted and scaled) sparse matrix, the matching,
+     * equilibration and fill-reducing permutations, and the
+     * structure and factors of the multifrontal tree. This can be
+     * loaded again with load_factors, to solve with the same matrix
+     * without redoing the reordering and numerical factorization.
+     *
+     * The file is in a versioned binary format, and can only be read
+     * by a solver with the same scalar_t and integer_t types, on a
+     * machine with the same endianness. Saving is supported for the
+     * sequential/multithreaded solver, with dense, HSS, BLR or lossy
+     * fronts, not for HODLR or GPU fronts.
+     *
+     * \param fname name of the file to create
+     * \return error code
+     * \see load_factors
+     */
+    ReturnCode save_factors(const std::string& fname) const;
+
+    /**
+     * Load a factorization written with save_factors. After this,
+     * solve can be called directly. This also sets the compression
+     * and matching options as they were when the file was written.
+     *
+     * The file is memory mapped (when supported by the OS), and the
+     * factors of the dense fronts are used in place, so pages of the
+     * file are only read from disk when the solve accesses them.
+     * Hence the file should not be modified while the factorization
+     * is in use.
+     *
+     * \param fname name of the file written with save_factors
+     * \return error code
+     * \see save_factors
+     */
+    ReturnCode load_factors(const std::string& fname);
+
   protected:
     virtual void setup_tree() = 0;
     virtual void setup_reordering() = 0;
     virtual
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) = 0;
+                           int components, int width,
+                           const double* coords, int d) = 0;
     virtual void separator_reordering() = 0;
 
     virtual SpMat_t* matrix() = 0;
@@ -332,6 +441,17 @@ namespace strumpack {
     virtual void synchronize() {}
     virtual void communicate_ordering() {}
 
+    /**
+     * Whether the symmetric front factorizations, see
+     * SPOptions::set_factorization_type, can be used with the
+     * current options. If not, LU is used instead.
+     */
+    virtual bool symmetric_factorization_supported() const;
+    void check_factorization_type();
+    bool symmetric_factorization() const {
+      return opts_.factorization_type() != FactorizationType::LU;
+    }
+
     void papi_initialize();
     long long dense_factor_nonzeros() const;
     void print_solve_stats(TaskTimer& t) const;
@@ -342,6 +462,13 @@ namespace strumpack {
     void flop_breakdown_reset() const;
 
     void print_wrong_sparsity_error();
+    void trace_enable();
+
+    virtual bool write_factors(std::ofstream& os) const { return false; }
+    virtual bool read_factors(std::ifstream& is,
+                              std::unique_ptr<io::MappedFile> f) {
+      return false;
+    }
 
     SPOptions<scalar_t> opts_;
     bool is_root_;
@@ -353,6 +480,7 @@ namespace strumpack {
     std::ostream* rank_out_ = nullptr;
     bool factored_ = false;
     bool reordered_ = false;
+    bool tracing_ = false;
     int Krylov_its_ = 0;
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -371,7 +499,8 @@ namespace strumpack {
   private:
     ReturnCode reorder_internal(const int* p, int base,
                                 int nx, int ny, int nz,
-                                int components, int width);
+                                int components, int width,
+                                const double* coords=nullptr, int d=0);
 
     virtual
     ReturnCode solve_internal(const scalar_t* b, scalar_t* x,
@@ -379,6 +508,14 @@ namespace strumpack {
     virtual
     ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x,
                               bool use_initial_guess=false) = 0;
+    virtual
+    ReturnCode solve_transposed_internal(Trans op, const scalar_t* b,
+                                         scalar_t* x,
+                                         bool use_initial_guess);
+    virtual
+    ReturnCode solve_transposed_internal(Trans op, const DenseM_t& b,
+                                         DenseM_t& x,
+                                         bool use_initial_guess);
 
     virtual void delete_factors_internal() = 0;
   };
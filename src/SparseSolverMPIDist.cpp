@@ -176,9 +176,14 @@ namespace strumpack {
       matrix()->apply_matching(this->matching_);
       matrix()->equilibrate(this->equil_);
       matrix()->symmetrize_sparsity();
-      setup_tree();
-      if (opts_.compression() != CompressionType::NONE)
-        separator_reordering();
+      // the sparsity pattern is unchanged, so try to keep the tree
+      // and only redistribute the values
+      if (!(tree_mpi_dist_ &&
+            tree_mpi_dist_->update_values(opts_, *mat_mpi_))) {
+        setup_tree();
+        if (opts_.compression() != CompressionType::NONE)
+          separator_reordering();
+      }
     }
     this->factored_ = false;
   }
@@ -193,8 +198,11 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   SparseSolverMPIDist<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
-   int components, int width) {
+   int components, int width, const double* coords, int d) {
     if (p) return nd_mpi_->set_permutation(opts_, *mat_mpi_, p, base);
+    if (coords)
+      return nd_mpi_->coordinate_nested_dissection
+        (opts_, *mat_mpi_, coords, d, components);
     return nd_mpi_->nested_dissection
       (opts_, *mat_mpi_, nx, ny, nz, components, width);
   }
@@ -268,61 +276,83 @@ namespace strumpack {
       mat_mpi_->spmv(x, y);
     };
 
+    auto block_spmv = [&](const DenseM_t& X, DenseM_t& Y) {
+      mat_mpi_->spmv(X, Y);
+    };
+    // with multiple right hand sides, use the block Krylov solvers,
+    // which apply the preconditioner to all right hand sides at once
     auto gmres =
-      [&](const std::function<void(scalar_t*)>& prec) {
-        assert(x.cols() == 1);
-        iterative::GMResMPI<scalar_t>
-          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
-           opts_.gmres_restart(), opts_.GramSchmidt_type(),
-           use_initial_guess, opts_.verbose() && is_root_);
+      [&](const std::function<void(scalar_t*)>& prec,
+          const std::function<void(DenseM_t&)>& block_prec) {
+        if (x.cols() == 1)
+          iterative::GMResMPI<scalar_t>
+            (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockGMResMPI<scalar_t>
+            (comm_, block_spmv, block_prec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             opts_.gmres_restart(), opts_.GramSchmidt_type(),
+             use_initial_guess, opts_.verbose() && is_root_);
       };
     auto bicgstab =
-      [&](const std::function<void(scalar_t*)>& prec) {
-        assert(x.cols() == 1);
-        iterative::BiCGStabMPI<scalar_t>
-          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
-           use_initial_guess, opts_.verbose() && is_root_);
+      [&](const std::function<void(scalar_t*)>& prec,
+          const std::function<void(DenseM_t&)>& block_prec) {
+        if (x.cols() == 1)
+          iterative::BiCGStabMPI<scalar_t>
+            (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockBiCGStabMPI<scalar_t>
+            (comm_, block_spmv, block_prec, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(),
+             this->Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
       };
     auto MFsolve =
       [&](scalar_t* w) {
         DenseMW_t X(nloc, x.cols(), w, x.ld());
         tree()->multifrontal_solve_dist(X, mat_mpi_->dist());
       };
+    auto block_MFsolve =
+      [&](DenseM_t& w) {
+        tree()->multifrontal_solve_dist(w, mat_mpi_->dist());
+      };
     auto refine =
       [&]() {
         iterative::IterativeRefinementMPI<scalar_t,integer_t>
           (comm_, *mat_mpi_,
-           [&](DenseM_t& w) {
-             tree()->multifrontal_solve_dist(w, mat_mpi_->dist()); },
-           x, bloc, opts_.rel_tol(), opts_.abs_tol(),
+           block_MFsolve, x, bloc, opts_.rel_tol(), opts_.abs_tol(),
            this->Krylov_its_, opts_.maxit(),
            use_initial_guess, opts_.verbose() && is_root_);
       };
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
-        gmres(MFsolve);
+      if (opts_.compression() != CompressionType::NONE)
+        gmres(MFsolve, block_MFsolve);
       else refine();
     }; break;
     case KrylovSolver::REFINE: {
       refine();
     }; break;
     case KrylovSolver::GMRES: {
-      gmres([](scalar_t*){});
+      gmres([](scalar_t*){}, [](DenseM_t&){});
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      gmres(MFsolve);
+      gmres(MFsolve, block_MFsolve);
     }; break;
     case KrylovSolver::BICGSTAB: {
-      bicgstab([](scalar_t*){});
+      bicgstab([](scalar_t*){}, [](DenseM_t&){});
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      bicgstab(MFsolve);
+      bicgstab(MFsolve, block_MFsolve);
     }; break;
     case KrylovSolver::DIRECT: {
       // TODO bloc is already a copy, avoid extra copy?
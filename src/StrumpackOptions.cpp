@@ -47,6 +47,7 @@ namespace strumpack {
     case ReorderingStrategy::PARMETIS: return "ParMetis"; break;
     case ReorderingStrategy::PTSCOTCH: return "PTScotch"; break;
     case ReorderingStrategy::RCM: return "RCM"; break;
+    case ReorderingStrategy::ND: return "ND"; break;
     }
     return "UNKNOWN";
   }
@@ -60,6 +61,7 @@ namespace strumpack {
     case ReorderingStrategy::PARMETIS: return true; break;
     case ReorderingStrategy::PTSCOTCH: return true; break;
     case ReorderingStrategy::RCM: return false; break;
+    case ReorderingStrategy::ND: return false; break;
     }
     return false;
   }
@@ -77,6 +79,24 @@ namespace strumpack {
     return "UNKNOWN";
   }
 
+  std::string get_name(FactorizationType t) {
+    switch (t) {
+    case FactorizationType::LU: return "lu";
+    case FactorizationType::CHOLESKY: return "cholesky";
+    case FactorizationType::LDLT: return "ldlt";
+    }
+    return "UNKNOWN";
+  }
+
+  std::string get_name(FrontPivoting p) {
+    switch (p) {
+    case FrontPivoting::PARTIAL: return "partial";
+    case FrontPivoting::REUSE: return "reuse";
+    case FrontPivoting::NONE: return "none";
+    }
+    return "UNKNOWN";
+  }
+
   MatchingJob get_matching(int job) {
     if (job < 0 || job > 6)
       std::cerr << "ERROR: Matching job not recognized!!" << std::endl;
@@ -153,6 +173,18 @@ namespace strumpack {
        {"sp_disable_gpu",               no_argument, 0, 37},
        {"sp_gpu_streams",               required_argument, 0, 38},
        {"sp_lossy_precision",           required_argument, 0, 39},
+       {"sp_enable_level_batching",     no_argument, 0, 40},
+       {"sp_disable_level_batching",    no_argument, 0, 41},
+       {"sp_level_batching_max_size",   required_argument, 0, 42},
+       {"sp_factorization",             required_argument, 0, 43},
+       {"sp_enable_async_extend_add",   no_argument, 0, 44},
+       {"sp_disable_async_extend_add",  no_argument, 0, 45},
+       {"sp_front_pivoting",            required_argument, 0, 46},
+       {"sp_low_rank_update_max_rank",  required_argument, 0, 47},
+       {"sp_trace",                     required_argument, 0, 48},
+       {"sp_enable_inertial_bisection", no_argument, 0, 49},
+       {"sp_disable_inertial_bisection", no_argument, 0, 50},
+       {"sp_amalgamation_fraction",     required_argument, 0, 51},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -215,9 +247,10 @@ namespace strumpack {
         else if (s == "ptscotch") set_reordering_method(ReorderingStrategy::PTSCOTCH);
         else if (s == "geometric") set_reordering_method(ReorderingStrategy::GEOMETRIC);
         else if (s == "rcm") set_reordering_method(ReorderingStrategy::RCM);
+        else if (s == "nd") set_reordering_method(ReorderingStrategy::ND);
         else std::cerr << "# WARNING: matrix reordering strategy not"
                " recognized, use 'metis', 'parmetis', 'scotch', 'ptscotch',"
-               " 'geometric' or 'rcm'" << std::endl;
+               " 'geometric', 'rcm' or 'nd'" << std::endl;
       } break;
       case 8: {
         std::istringstream iss(optarg);
@@ -319,6 +352,45 @@ namespace strumpack {
         iss >> lossy_precision_;
         set_lossy_precision(lossy_precision_);
       } break;
+      case 40: enable_level_batching(); break;
+      case 41: disable_level_batching(); break;
+      case 42: {
+        std::istringstream iss(optarg);
+        iss >> level_batching_max_size_;
+        set_level_batching_max_size(level_batching_max_size_);
+      } break;
+      case 43: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        if (s == "lu") set_factorization_type(FactorizationType::LU);
+        else if (s == "cholesky")
+          set_factorization_type(FactorizationType::CHOLESKY);
+        else if (s == "ldlt") set_factorization_type(FactorizationType::LDLT);
+        else std::cerr << "# WARNING: factorization type not recognized,"
+               " using default" << std::endl;
+      } break;
+      case 44: enable_async_extend_add(); break;
+      case 45: disable_async_extend_add(); break;
+      case 46: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        if (s == "partial") set_front_pivoting(FrontPivoting::PARTIAL);
+        else if (s == "reuse") set_front_pivoting(FrontPivoting::REUSE);
+        else if (s == "none") set_front_pivoting(FrontPivoting::NONE);
+        else std::cerr << "# WARNING: front pivoting not recognized,"
+               " using default" << std::endl;
+      } break;
+      case 47: {
+        std::istringstream iss(optarg);
+        iss >> low_rank_update_max_rank_;
+        set_low_rank_update_max_rank(low_rank_update_max_rank_);
+      } break;
+      case 48: set_trace_file(optarg); break;
+      case 49: enable_inertial_bisection(); break;
+      case 50: disable_inertial_bisection(); break;
+      case 51: {
+        std::istringstream iss(optarg);
+        iss >> amalgamation_fraction_;
+        set_amalgamation_fraction(amalgamation_fraction_);
+      } break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -368,12 +440,23 @@ namespace strumpack {
               << std::endl;
     std::cout << "#          Gram-Schmidt type for GMRES" << std::endl;
     std::cout << "#   --sp_reordering_method [natural|metis|scotch|parmetis|"
-              << "ptscotch|rcm|geometric]" << std::endl;
+              << "ptscotch|rcm|geometric|nd]" << std::endl;
     std::cout << "#          Code for nested dissection." << std::endl;
     std::cout << "#          Geometric only works on regular meshes and you"
               << " need to provide the sizes." << std::endl;
+    std::cout << "#          nd is the built-in (multithreaded)"
+              << " multilevel nested dissection." << std::endl;
     std::cout << "#   --sp_nd_param int (default " << nd_param() << ")"
               << std::endl;
+    std::cout << "#   --sp_enable_inertial_bisection" << std::endl;
+    std::cout << "#   --sp_disable_inertial_bisection (default "
+              << !inertial_bisection() << ")" << std::endl;
+    std::cout << "#          split along the principal direction in the"
+              << " coordinate based nested dissection" << std::endl;
+    std::cout << "#   --sp_amalgamation_fraction real (default "
+              << amalgamation_fraction() << ")" << std::endl;
+    std::cout << "#          merge small fronts when the added zeros are"
+              << " at most this fraction, 0 disables" << std::endl;
     std::cout << "#   --sp_nx int (default " << nx() << ")"
               << std::endl;
     std::cout << "#   --sp_ny int (default " << ny() << ")"
@@ -442,6 +525,32 @@ namespace strumpack {
               << lossy_precision() << ")" << std::endl
               << "#          lossy compression precision" << std::endl
               << "#          (for lossless use <= 0)" << std::endl;
+    std::cout << "#   --sp_enable_level_batching" << std::endl;
+    std::cout << "#   --sp_disable_level_batching" << std::endl;
+    std::cout << "#   --sp_level_batching_max_size int (default "
+              << level_batching_max_size() << ")" << std::endl
+              << "#          max front size for level batched factorization"
+              << std::endl;
+    std::cout << "#   --sp_factorization [lu|cholesky|ldlt] (default "
+              << get_name(factorization_type()) << ")" << std::endl;
+    std::cout << "#          factorization of the dense fronts,"
+              << " cholesky/ldlt for symmetric matrices" << std::endl;
+    std::cout << "#   --sp_enable_async_extend_add" << std::endl;
+    std::cout << "#   --sp_disable_async_extend_add (default "
+              << !async_extend_add() << ")" << std::endl;
+    std::cout << "#          non-blocking extend-add between"
+              << " distributed fronts" << std::endl;
+    std::cout << "#   --sp_front_pivoting [partial|reuse|none] (default "
+              << get_name(front_pivoting()) << ")" << std::endl;
+    std::cout << "#          pivoting in the LU factorization of the"
+              << " dense fronts" << std::endl;
+    std::cout << "#   --sp_low_rank_update_max_rank int (default "
+              << low_rank_update_max_rank() << ")" << std::endl;
+    std::cout << "#          max rank of updates applied with the"
+              << " Woodbury formula" << std::endl;
+    std::cout << "#   --sp_trace file (default none)" << std::endl;
+    std::cout << "#          write a Chrome trace of the work on the"
+              << " fronts" << std::endl;
     std::cout << "#   --sp_verbose or -v (default " << verbose() << ")"
               << std::endl;
     std::cout << "#   --sp_quiet or -q (default " << !verbose() << ")"
@@ -52,8 +52,10 @@ namespace strumpack {
     SCOTCH,     /*!< Use Scotch nested-dissection reordering        */
     PTSCOTCH,   /*!< Use PT-Scotch nested-dissection reordering     */
     RCM,        /*!< Use RCM reordering                             */
-    GEOMETRIC   /*!< A simple geometric nested dissection code that
+    GEOMETRIC,  /*!< A simple geometric nested dissection code that
                   only works for regular meshes. (see Sp::reorder)  */
+    ND          /*!< Built-in multilevel nested dissection, using
+                  OpenMP, see nd_nested_dissection                  */
   };
 
   /**
@@ -138,7 +140,10 @@ namespace strumpack {
   };
 
   /**
-   * Type of outer iterative (Krylov) solver.
+   * Type of outer iterative (Krylov) solver. With multiple right-hand
+   * sides, the GMRes and BiCGStab variants use a block Krylov method,
+   * which applies the multifrontal solver to all right-hand sides at
+   * once.
    * \ingroup Enumerations
    */
   enum class KrylovSolver {
@@ -155,6 +160,47 @@ namespace strumpack {
     BICGSTAB        /*!< UN-preconditioned BiCGStab. (for testing mainly)   */
   };
 
+  /**
+   * Type of factorization used for the dense frontal matrices. For
+   * the symmetric variants, only the lower triangular parts of the
+   * fronts and contribution blocks are referenced and the F12 blocks
+   * are not stored. These are currently only supported without
+   * compression, and without MPI, otherwise LU is used.
+   * \ingroup Enumerations
+   */
+  enum class FactorizationType {
+    LU,             /*!< LU with partial pivoting in the separator block */
+    CHOLESKY,       /*!< Cholesky, for symmetric (Hermitian) positive
+                      definite matrices.                                  */
+    LDLT            /*!< Bunch-Kaufman LDL^T, for symmetric indefinite
+                      matrices.                                           */
+  };
+
+  /**
+   * Return a short string with the name of the factorization type.
+   */
+  std::string get_name(FactorizationType t);
+
+  /**
+   * Pivoting in the separator block of the dense fronts, for the LU
+   * factorization.
+   * \ingroup Enumerations
+   */
+  enum class FrontPivoting {
+    PARTIAL, /*!< Partial (row) pivoting, getrf                     */
+    REUSE,   /*!< Reuse the pivot sequence of the previous
+                  factorization, useful for a sequence of matrices
+                  with the same sparsity pattern and slowly changing
+                  values, the first factorization uses PARTIAL      */
+    NONE     /*!< No pivoting, relying on matching, replacement of
+                  tiny pivots and iterative refinement              */
+  };
+
+  /**
+   * Return a short string with the name of the front pivoting.
+   */
+  std::string get_name(FrontPivoting p);
+
   /**
    * Default relative tolerance used when solving a linear system. For
    * iterative solvers such as GMRES and BiCGStab, this is the
@@ -310,6 +356,36 @@ namespace strumpack {
     void set_nd_param(int nd_param)
     { assert(nd_param>=0); nd_param_ = nd_param; }
 
+    /**
+     * Use inertial bisection, i.e., split along the principal
+     * direction of the coordinates, in the coordinate based nested
+     * dissection, see SparseSolverBase::reorder(const double*, int,
+     * int). By default, the coordinates are split along the
+     * direction with the largest extent.
+     */
+    void enable_inertial_bisection() { inertial_bisection_ = true; }
+
+    /**
+     * Split along the coordinate direction with the largest extent
+     * in the coordinate based nested dissection.
+     * \see enable_inertial_bisection()
+     */
+    void disable_inertial_bisection() { inertial_bisection_ = false; }
+
+    /**
+     * Set the fraction of explicit zeros allowed in the relaxed
+     * amalgamation of small fronts. After the symbolic
+     * factorization, the children of a front are merged into it if
+     * they are leaves and the number of zeros this adds to the
+     * (dense) factors is at most this fraction of the factors of the
+     * merged front. This avoids many tiny fronts at the bottom of
+     * the tree. The default 0 disables the amalgamation.
+     *
+     * \param f fraction, should be in [0,1)
+     */
+    void set_amalgamation_fraction(double f)
+    { assert(f >= 0 && f < 1); amalgamation_fraction_ = f; }
+
     /**
      * Set the mesh dimensions. This is only useful when the sparse
      * matrix was generated by a stencil on a regular 1d, 2d or 3d
@@ -686,6 +762,116 @@ namespace strumpack {
      */
     void set_lossy_precision(int p) { lossy_precision_ = p; }
 
+    /**
+     * Enable level batching of small fronts. Subtrees of the
+     * elimination tree containing only dense fronts with dimension
+     * smaller than level_batching_max_size() are factored one level
+     * at a time, with all fronts of a level processed in parallel,
+     * using small size specialized kernels instead of BLAS/LAPACK.
+     *
+     * \see disable_level_batching(), set_level_batching_max_size()
+     */
+    void enable_level_batching() { level_batching_ = true; }
+
+    /**
+     * Disable level batching of small fronts.
+     *
+     * \see enable_level_batching()
+     */
+    void disable_level_batching() { level_batching_ = false; }
+
+    /**
+     * Set the maximum front dimension (separator + update size) for
+     * a front to be included in the level batched factorization.
+     *
+     * \see enable_level_batching()
+     */
+    void set_level_batching_max_size(int s) {
+      assert(s >= 0);
+      level_batching_max_size_ = s;
+    }
+
+    /**
+     * Select the factorization for the dense frontal matrices. Use
+     * FactorizationType::CHOLESKY or FactorizationType::LDLT only
+     * for symmetric (for Cholesky in the complex case, Hermitian)
+     * matrices. With a symmetric factorization, no matching is
+     * performed, since that destroys the symmetry. The symmetric
+     * factorizations are only used without compression, and not in
+     * the distributed memory solvers.
+     *
+     * \see factorization_type()
+     */
+    void set_factorization_type(FactorizationType t)
+    { factorization_type_ = t; }
+
+    /**
+     * Enable the non-blocking extend-add between distributed
+     * fronts. Instead of a collective MPI_Alltoallv on the
+     * communicator of the parent front, each rank of a child starts
+     * sending its part of the contribution block as soon as the
+     * child is factored, and the parent assembles the contribution
+     * of a child as soon as it has been received, while the other
+     * child can still be busy. This only affects the distributed
+     * memory solver.
+     *
+     * \see disable_async_extend_add()
+     */
+    void enable_async_extend_add() { async_extend_add_ = true; }
+
+    /**
+     * Use a (blocking) MPI_Alltoallv for the extend-add between
+     * distributed fronts.
+     *
+     * \see enable_async_extend_add()
+     */
+    void disable_async_extend_add() { async_extend_add_ = false; }
+
+    /**
+     * Select the pivoting in the LU factorization of the dense
+     * fronts. With FrontPivoting::REUSE, a refactorization (see
+     * SparseSolver::update_matrix_values) applies the row
+     * permutations from the previous factorization and then factors
+     * without pivot search, as does FrontPivoting::NONE without any
+     * permutation. Without pivot search, the front LU is a blocked
+     * right-looking factorization, with most of the work in trsm and
+     * gemm. Pivots smaller than pivot_threshold() are replaced when
+     * replace_tiny_pivots() is enabled, so this should be combined
+     * with matching and iterative refinement. This is only used for
+     * the dense fronts, not for compressed fronts.
+     *
+     * \see front_pivoting(), enable_replace_tiny_pivots()
+     */
+    void set_front_pivoting(FrontPivoting p) { front_pivoting_ = p; }
+
+    /**
+     * Set the maximum accumulated rank of the low-rank updates
+     * registered with SparseSolver::add_low_rank_update. Up to this
+     * rank, the updates are applied in the solve using the Woodbury
+     * formula. When the accumulated rank grows larger, the updates
+     * are added to the sparse matrix and the matrix is refactored.
+     *
+     * \param r maximum rank, should be >= 0
+     * \see low_rank_update_max_rank()
+     */
+    void set_low_rank_update_max_rank(int r) {
+      assert(r >= 0); low_rank_update_max_rank_ = r;
+    }
+
+    /**
+     * Record a timeline of the work on the fronts, the assembly,
+     * extend-add, factorization, compression and solve, and write it
+     * as a Chrome trace-event JSON file when the solver is destroyed.
+     * With MPI, the rank is added to the file name. An empty name
+     * (the default) disables tracing. The recording is shared by all
+     * solvers, so when several solvers trace at the same time, the
+     * file also has the events of the others, recorded so far.
+     *
+     * \param fname name of the trace file, for instance trace.json
+     * \see trace_file()
+     */
+    void set_trace_file(const std::string& fname) { trace_file_ = fname; }
+
     /**
      * Print statistics, about ranks, memory etc, for the root front
      * only.
@@ -746,6 +932,20 @@ namespace strumpack {
      */
     int nd_param() const { return nd_param_; }
 
+    /**
+     * Check whether inertial bisection is used in the coordinate
+     * based nested dissection.
+     * \see enable_inertial_bisection()
+     */
+    bool inertial_bisection() const { return inertial_bisection_; }
+
+    /**
+     * Get the fraction of explicit zeros allowed in the amalgamation
+     * of small fronts, 0 if disabled.
+     * \see set_amalgamation_fraction()
+     */
+    double amalgamation_fraction() const { return amalgamation_fraction_; }
+
     /**
      * Get the specified nx mesh dimension.
      * \see set_nx()
@@ -1002,6 +1202,62 @@ namespace strumpack {
      */
     int lossy_precision() const { return lossy_precision_; }
 
+    /**
+     * Check whether level batching of small fronts is enabled.
+     *
+     * \see enable_level_batching()
+     */
+    bool level_batching() const { return level_batching_; }
+
+    /**
+     * Maximum front dimension for the level batched factorization.
+     *
+     * \see set_level_batching_max_size()
+     */
+    int level_batching_max_size() const { return level_batching_max_size_; }
+
+    /**
+     * Get the factorization type used for the dense frontal
+     * matrices.
+     *
+     * \see set_factorization_type()
+     */
+    FactorizationType factorization_type() const
+    { return factorization_type_; }
+
+    /**
+     * Check whether the non-blocking distributed extend-add is
+     * enabled.
+     *
+     * \see enable_async_extend_add()
+     */
+    bool async_extend_add() const { return async_extend_add_; }
+
+    /**
+     * Get the pivoting used in the LU factorization of the dense
+     * fronts.
+     *
+     * \see set_front_pivoting()
+     */
+    FrontPivoting front_pivoting() const { return front_pivoting_; }
+
+    /**
+     * Get the maximum accumulated rank of the low-rank updates
+     * applied using the Woodbury formula.
+     *
+     * \see set_low_rank_update_max_rank()
+     */
+    int low_rank_update_max_rank() const {
+      return low_rank_update_max_rank_;
+    }
+
+    /**
+     * Get the name of the trace file, empty if tracing is disabled.
+     *
+     * \see set_trace_file()
+     */
+    const std::string& trace_file() const { return trace_file_; }
+
     /**
      * Info about the stats of the root front will be printed to
      * std::cout
@@ -1083,6 +1339,8 @@ namespace strumpack {
     /** Reordering options */
     ReorderingStrategy reordering_method_ = ReorderingStrategy::METIS;
     int nd_param_ = 8;
+    bool inertial_bisection_ = false;
+    double amalgamation_fraction_ = 0.;
     int nx_ = 1;
     int ny_ = 1;
     int nz_ = 1;
@@ -1127,6 +1385,15 @@ namespace strumpack {
     int lossy_min_sep_size_ = 8;
     int lossy_precision_ = 16;
 
+    /** level batching of small fronts */
+    bool level_batching_ = false;
+    int level_batching_max_size_ = 32;
+    FactorizationType factorization_type_ = FactorizationType::LU;
+    bool async_extend_add_ = false;
+    FrontPivoting front_pivoting_ = FrontPivoting::PARTIAL;
+    int low_rank_update_max_rank_ = 32;
+    std::string trace_file_;
+
     int argc_ = 0;
     const char* const* argv_ = nullptr;
   };
@@ -50,35 +50,33 @@ namespace strumpack {
     int task_recursion_cutoff_level = 0;
 #endif
 
-    std::atomic<long long int> flops(0);
-    std::atomic<long long int> bytes_moved(0);
-    std::atomic<long long int> memory(0);
-    std::atomic<long long int> peak_memory(0);
-    std::atomic<long long int> device_memory(0);
-    std::atomic<long long int> peak_device_memory(0);
+    Counter flops;
+    Counter bytes_moved;
+    MemoryCounter memory;
+    MemoryCounter device_memory;
 
-    std::atomic<long long int> CB_sample_flops(0);
-    std::atomic<long long int> sparse_sample_flops(0);
-    std::atomic<long long int> extraction_flops(0);
-    std::atomic<long long int> ULV_factor_flops(0);
-    std::atomic<long long int> schur_flops(0);
-    std::atomic<long long int> full_rank_flops(0);
-    std::atomic<long long int> random_flops(0);
-    std::atomic<long long int> ID_flops(0);
-    std::atomic<long long int> QR_flops(0);
-    std::atomic<long long int> ortho_flops(0);
-    std::atomic<long long int> reduce_sample_flops(0);
-    std::atomic<long long int> update_sample_flops(0);
-    std::atomic<long long int> hss_solve_flops(0);
+    Counter CB_sample_flops;
+    Counter sparse_sample_flops;
+    Counter extraction_flops;
+    Counter ULV_factor_flops;
+    Counter schur_flops;
+    Counter full_rank_flops;
+    Counter random_flops;
+    Counter ID_flops;
+    Counter QR_flops;
+    Counter ortho_flops;
+    Counter reduce_sample_flops;
+    Counter update_sample_flops;
+    Counter hss_solve_flops;
 
-    std::atomic<long long int> f11_fill_flops(0);
-    std::atomic<long long int> f12_fill_flops(0);
-    std::atomic<long long int> f21_fill_flops(0);
-    std::atomic<long long int> f22_fill_flops(0);
+    Counter f11_fill_flops;
+    Counter f12_fill_flops;
+    Counter f21_fill_flops;
+    Counter f22_fill_flops;
 
-    std::atomic<long long int> f21_mult_flops(0);
-    std::atomic<long long int> invf11_mult_flops(0);
-    std::atomic<long long int> f12_mult_flops(0);
+    Counter f21_mult_flops;
+    Counter invf11_mult_flops;
+    Counter f12_mult_flops;
 
   } // end namespace params
 } // end namespace strumpack
@@ -32,6 +32,7 @@
 #ifndef STRUMPACK_PARAMETERS_HPP
 #define STRUMPACK_PARAMETERS_HPP
 #include <atomic>
+#include <algorithm>
 #include <string>
 #include <cmath>
 #include <iostream>
@@ -60,7 +61,12 @@ namespace strumpack { // these are all global variables
   enum class ReturnCode {
     SUCCESS,          /*!< Operation completed successfully. */
     MATRIX_NOT_SET,   /*!< The input matrix was not set.     */
-    REORDERING_ERROR  /*!< The matrix reordering failed.     */
+    REORDERING_ERROR, /*!< The matrix reordering failed.     */
+    FILE_ERROR,       /*!< Reading or writing a file failed. */
+    NOT_SUPPORTED,    /*!< Not supported with the current
+                           solver configuration.             */
+    INVALID_ARGUMENT  /*!< An argument is invalid, or the
+                           call is out of sequence.          */
   };
 
   namespace params {
@@ -70,35 +76,127 @@ namespace strumpack { // these are all global variables
     extern int num_threads;
     extern int task_recursion_cutoff_level;
 
-    extern std::atomic<long long int> flops;
-    extern std::atomic<long long int> bytes_moved;
-    extern std::atomic<long long int> memory;
-    extern std::atomic<long long int> peak_memory;
-    extern std::atomic<long long int> device_memory;
-    extern std::atomic<long long int> peak_device_memory;
-
-    extern std::atomic<long long int> CB_sample_flops;
-    extern std::atomic<long long int> sparse_sample_flops;
-    extern std::atomic<long long int> extraction_flops;
-    extern std::atomic<long long int> ULV_factor_flops;
-    extern std::atomic<long long int> schur_flops;
-    extern std::atomic<long long int> full_rank_flops;
-    extern std::atomic<long long int> random_flops;
-    extern std::atomic<long long int> ID_flops;
-    extern std::atomic<long long int> ortho_flops;
-    extern std::atomic<long long int> QR_flops;
-    extern std::atomic<long long int> reduce_sample_flops;
-    extern std::atomic<long long int> update_sample_flops;
-    extern std::atomic<long long int> hss_solve_flops;
-
-    extern std::atomic<long long int> f11_fill_flops;
-    extern std::atomic<long long int> f12_fill_flops;
-    extern std::atomic<long long int> f21_fill_flops;
-    extern std::atomic<long long int> f22_fill_flops;
-
-    extern std::atomic<long long int> f21_mult_flops;
-    extern std::atomic<long long int> invf11_mult_flops;
-    extern std::atomic<long long int> f12_mult_flops;
+    /**
+     * Number of per-thread slots in the counters below. Threads are
+     * assigned a slot round-robin, the first time they update a
+     * counter, so with more threads slots are shared, which is still
+     * correct, just slower.
+     */
+    const int counter_slots = 128;
+
+    inline int counter_slot() {
+      static std::atomic<int> nthreads(0);
+      thread_local int slot = nthreads++ % counter_slots;
+      return slot;
+    }
+
+    /**
+     * Counter for flops and bytes, updated from many threads
+     * concurrently. Each thread adds to its own slot, on a separate
+     * cache line, to avoid the contention of a single shared atomic,
+     * and the slots are only summed when the value is read, which
+     * should be rare. Setting the counter is not thread safe with
+     * respect to concurrent updates.
+     */
+    class Counter {
+    public:
+      Counter& operator+=(long long int n) {
+        s_[counter_slot()].v.fetch_add(n, std::memory_order_relaxed);
+        return *this;
+      }
+      Counter& operator-=(long long int n) { return *this += -n; }
+      Counter& operator=(long long int n) {
+        for (auto& s : s_) s.v.store(0, std::memory_order_relaxed);
+        s_[0].v.store(n, std::memory_order_relaxed);
+        return *this;
+      }
+      long long int load() const {
+        long long int n = 0;
+        for (auto& s : s_) n += s.v.load(std::memory_order_relaxed);
+        return n;
+      }
+      operator long long int() const { return load(); }
+
+    private:
+      struct alignas(64) Slot { std::atomic<long long int> v{0}; };
+      Slot s_[counter_slots];
+    };
+
+    /**
+     * Counter for the current and peak memory usage. Allocations are
+     * added directly to the shared total. Each thread accumulates its
+     * deallocations in its own slot, and only adds them to the total
+     * when they exceed granularity bytes, so the total can be too
+     * high, but never too low. Hence, when an allocation brings the
+     * total above the peak, all slots are first flushed to the total,
+     * which then gives the exact peak.
+     */
+    class MemoryCounter {
+    public:
+      static const long long int granularity = 1 << 20;
+
+      MemoryCounter& operator+=(long long int n) {
+        auto t = total_.fetch_add(n) + n;
+        if (t > peak_.load(std::memory_order_relaxed)) update_peak();
+        return *this;
+      }
+      MemoryCounter& operator-=(long long int n) {
+        auto& s = s_[counter_slot()].v;
+        if (s.fetch_add(-n, std::memory_order_relaxed) - n <= -granularity)
+          total_.fetch_add(s.exchange(0, std::memory_order_relaxed));
+        return *this;
+      }
+      long long int load() const {
+        auto n = total_.load();
+        for (auto& s : s_) n += s.v.load(std::memory_order_relaxed);
+        return n;
+      }
+      operator long long int() const { return load(); }
+      long long int peak() const { return peak_.load(); }
+
+    private:
+      struct alignas(64) Slot { std::atomic<long long int> v{0}; };
+      Slot s_[counter_slots];
+      alignas(64) std::atomic<long long int> total_{0};
+      std::atomic<long long int> peak_{0};
+
+      void update_peak() {
+        for (auto& s : s_)
+          if (s.v.load(std::memory_order_relaxed))
+            total_.fetch_add(s.v.exchange(0, std::memory_order_relaxed));
+        auto t = total_.load();
+        auto p = peak_.load();
+        while (t > p && !peak_.compare_exchange_weak(p, t)) { }
+      }
+    };
+
+    extern Counter flops;
+    extern Counter bytes_moved;
+    extern MemoryCounter memory;
+    extern MemoryCounter device_memory;
+
+    extern Counter CB_sample_flops;
+    extern Counter sparse_sample_flops;
+    extern Counter extraction_flops;
+    extern Counter ULV_factor_flops;
+    extern Counter schur_flops;
+    extern Counter full_rank_flops;
+    extern Counter random_flops;
+    extern Counter ID_flops;
+    extern Counter ortho_flops;
+    extern Counter QR_flops;
+    extern Counter reduce_sample_flops;
+    extern Counter update_sample_flops;
+    extern Counter hss_solve_flops;
+
+    extern Counter f11_fill_flops;
+    extern Counter f12_fill_flops;
+    extern Counter f21_fill_flops;
+    extern Counter f22_fill_flops;
+
+    extern Counter f21_mult_flops;
+    extern Counter invf11_mult_flops;
+    extern Counter f12_mult_flops;
 
 #endif //DOXYGEN_SHOULD_SKIP_THIS
 
@@ -153,24 +251,10 @@ namespace strumpack { // these are all global variables
 #define STRUMPACK_HODLR_F12_MULT_FLOPS(n)       \
   strumpack::params::f12_mult_flops += n
 
-#define STRUMPACK_ADD_MEMORY(n) {                                       \
-    strumpack::params::memory += n;                                     \
-    auto new_peak_ = std::max(strumpack::params::memory.load(),         \
-                              strumpack::params::peak_memory.load());   \
-    auto old_peak_ = strumpack::params::peak_memory.load();             \
-    while (new_peak_ > old_peak_ &&                                     \
-           !strumpack::params::peak_memory.compare_exchange_weak        \
-           (old_peak_, new_peak_)) { }                                  \
-  }
-#define STRUMPACK_ADD_DEVICE_MEMORY(n) {                                \
-    strumpack::params::device_memory += n;                              \
-    auto new_peak_ = std::max(strumpack::params::device_memory.load(),  \
-                              strumpack::params::peak_device_memory.load()); \
-    auto old_peak_ = strumpack::params::peak_device_memory.load();      \
-    while (new_peak_ > old_peak_ &&                                     \
-           !strumpack::params::peak_device_memory.compare_exchange_weak \
-           (old_peak_, new_peak_)) { }                                  \
-  }
+#define STRUMPACK_ADD_MEMORY(n)                 \
+  strumpack::params::memory += n;
+#define STRUMPACK_ADD_DEVICE_MEMORY(n)          \
+  strumpack::params::device_memory += n;
 
 #define STRUMPACK_SUB_MEMORY(n)                 \
   strumpack::params::memory -= n;
@@ -100,7 +100,8 @@ typedef enum
    STRUMPACK_SCOTCH=3,
    STRUMPACK_PTSCOTCH=4,
    STRUMPACK_RCM=5,
-   STRUMPACK_GEOMETRIC=6
+   STRUMPACK_GEOMETRIC=6,
+   STRUMPACK_ND=7
   } STRUMPACK_REORDERING_STRATEGY;
 
 typedef enum
@@ -136,7 +137,10 @@ typedef enum
   {
    STRUMPACK_SUCCESS=0,
    STRUMPACK_MATRIX_NOT_SET=1,
-   STRUMPACK_REORDERING_ERROR=2
+   STRUMPACK_REORDERING_ERROR=2,
+   STRUMPACK_FILE_ERROR=3,
+   STRUMPACK_NOT_SUPPORTED=4,
+   STRUMPACK_INVALID_ARGUMENT=5
   } STRUMPACK_RETURN_CODE;
 
 
@@ -199,6 +203,9 @@ extern "C" {
   STRUMPACK_RETURN_CODE STRUMPACK_reorder_regular
   (STRUMPACK_SparseSolver S, int nx, int ny, int nz);
 
+  STRUMPACK_RETURN_CODE STRUMPACK_reorder_coordinates
+  (STRUMPACK_SparseSolver S, const double* coords, int d, int components);
+
   STRUMPACK_RETURN_CODE STRUMPACK_factor(STRUMPACK_SparseSolver S);
 
   void STRUMPACK_move_to_gpu(STRUMPACK_SparseSolver S);
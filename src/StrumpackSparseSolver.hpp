@@ -79,6 +79,7 @@ namespace strumpack {
     using Reord_t = MatrixReordering<scalar_t,integer_t>;
     using DenseM_t = DenseMatrix<scalar_t>;
     using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
 
   public:
 
@@ -136,7 +137,8 @@ namespace strumpack {
      * \param N number of rows and columns of the CSR input matrix.
      * \param row_ptr indices in col_ind and values for the start of
      * each row. Nonzeros for row r are in [row_ptr[r],row_ptr[r+1])
-     * \param col_ind column indices of each nonzero
+     * \param col_ind column indices of each nonzero, these do not
+     * need to be sorted within a row
      * \param values nonzero values
      * \param symmetric_pattern denotes whether the sparsity
      * __pattern__ of the input matrix is symmetric, does not require
@@ -203,12 +205,143 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    /**
+     * Solve a linear system with a sparse right-hand side, and/or
+     * compute only some entries of the solution. The multifrontal
+     * forward solve only visits the fronts on the paths from the
+     * fronts containing the nonzero rows of b to the root, the
+     * backward solve only the fronts on the paths from the root to
+     * the fronts containing the requested entries of x. This is much
+     * cheaper than a full solve when the number of nonzeros in b, or
+     * the number of requested entries, is small, for instance to
+     * compute some entries of the inverse. This always uses a direct
+     * solve, the Krylov solver set in the options is ignored.
+     *
+     * \param b input, will not be modified. DenseMatrix containing
+     * the right-hand side(s), zero except for the rows in b_nz.
+     * \param x output, on return contains the requested entries of
+     * the solution, the other entries are not computed. Should be the
+     * correct size.
+     * \param b_nz (0-based) indices of the rows of b which can be
+     * nonzero, for all columns of b. If empty, b is treated as dense.
+     * \param x_idx (0-based) indices of the rows of x to compute. If
+     * empty, the full solution is computed.
+     *
+     * \see solve
+     */
+    ReturnCode solve_sparse(const DenseM_t& b, DenseM_t& x,
+                            const std::vector<integer_t>& b_nz,
+                            const std::vector<integer_t>& x_idx);
+
+    /**
+     * Register a low-rank correction to the matrix, so that the
+     * following solves are with A + U V^T, where A is the matrix
+     * associated with this solver, without refactoring A. The solve
+     * applies the Woodbury formula
+     *   (A + U V^T)^{-1} = A^{-1} - A^{-1} U K^{-1} V^T A^{-1},
+     * with the capacitance matrix K = I + V^T A^{-1} U. This routine
+     * computes A^{-1} U, with one (block) solve, and the LU
+     * factorization of K, the solve then requires one extra multiply
+     * with V^T and with A^{-1} U. Subsequent calls accumulate, the
+     * total rank is the sum of the number of columns of all updates.
+     * Modifying a set of rows I of A can be done with U the columns
+     * I of the identity matrix, and the rows of V^T the changes to
+     * the rows of A.
+     *
+     * When the accumulated rank exceeds
+     * SPOptions::low_rank_update_max_rank(), the updates are added to
+     * the (permuted and scaled) sparse matrix, and the matrix is
+     * refactored. This is only possible for the LU factorization, and
+     * when all nonzeros of U V^T are in the sparsity pattern of A (as
+     * for the row updates), otherwise the Woodbury formula is used
+     * for any rank. The updates are discarded by set_matrix and
+     * update_matrix_values. Transposed solves are not supported with
+     * a low-rank update, and an initial guess passed to solve is
+     * ignored (the Woodbury formula is applied to the solution with
+     * A). When the capacitance matrix is singular, this returns
+     * ReturnCode::INVALID_ARGUMENT and the update is not applied,
+     * the earlier updates are kept.
+     *
+     * \param U N x r matrix
+     * \param V N x r matrix
+     *
+     * \see clear_low_rank_update, low_rank_update_rank,
+     * SPOptions::set_low_rank_update_max_rank
+     */
+    ReturnCode add_low_rank_update(const DenseM_t& U, const DenseM_t& V);
+
+    /**
+     * Discard all low-rank updates registered with
+     * add_low_rank_update, that have not yet been added to the sparse
+     * matrix.
+     */
+    void clear_low_rank_update();
+
+    /**
+     * Return the accumulated rank of the low-rank updates which are
+     * currently applied in the solve with the Woodbury formula.
+     */
+    std::size_t low_rank_update_rank() const { return lr_U_.cols(); }
+
+    /**
+     * Set the interface variables for a partial factorization. The
+     * reordering puts these in the root separator, and the
+     * factorization only eliminates the other (interior) variables,
+     * after which the Schur complement A_SS - A_SI A_II^{-1} A_IS on
+     * the interface S can be obtained with Schur_complement. The
+     * interior can be solved for with Schur_forward_solve and
+     * Schur_backward_solve. This disables the matching, and the
+     * regular solve routines return ReturnCode::NOT_SUPPORTED until
+     * this is reset with an empty S.
+     *
+     * \param S (0-based) indices of the interface variables, the
+     * Schur complement is returned in this order.
+     *
+     * \see Schur_complement, Schur_forward_solve, Schur_backward_solve
+     */
+    void set_Schur_indices(const std::vector<integer_t>& S);
+
+    /**
+     * Return the Schur complement on the interface set with
+     * set_Schur_indices, as a dense matrix. This will call reorder
+     * and factor if needed.
+     *
+     * \param S output, the Schur complement, will be resized.
+     */
+    ReturnCode Schur_complement(DenseM_t& S);
+
+    /**
+     * Eliminate the interior from the right-hand side b, computing
+     * the condensed right-hand side g = b_S - A_SI A_II^{-1} b_I for
+     * the Schur complement system. x is used to hold the
+     * intermediate result for the interior, it should be passed
+     * unmodified to Schur_backward_solve.
+     *
+     * \param b input, right-hand side(s), size N x nrhs
+     * \param x output, intermediate result, size N x nrhs
+     * \param g output, condensed right-hand side, will be resized
+     * to |S| x nrhs
+     */
+    ReturnCode Schur_forward_solve(const DenseM_t& b, DenseM_t& x,
+                                   DenseM_t& g);
+
+    /**
+     * Given the solution xS of the Schur complement system, compute
+     * the solution of the interior, x_I = A_II^{-1} (b_I - A_IS xS).
+     *
+     * \param xS input, solution on the interface, size |S| x nrhs
+     * \param x input, as returned by Schur_forward_solve, on output
+     * the full solution, including xS
+     */
+    ReturnCode Schur_backward_solve(const DenseM_t& xS, DenseM_t& x);
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base,
                            int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const double* coords, int d) override;
     void separator_reordering() override;
 
     SpMat_t* matrix() override { return mat_.get(); }
@@ -224,12 +357,35 @@ namespace strumpack {
     (const scalar_t* b, scalar_t* x, bool use_initial_guess=false) override;
     ReturnCode solve_internal
     (const DenseM_t& b, DenseM_t& x, bool use_initial_guess=false) override;
+    ReturnCode solve_transposed_internal
+    (Trans op, const scalar_t* b, scalar_t* x,
+     bool use_initial_guess) override;
+    ReturnCode solve_transposed_internal
+    (Trans op, const DenseM_t& b, DenseM_t& x,
+     bool use_initial_guess) override;
+    ReturnCode solve_op
+    (Trans op, const DenseM_t& b, DenseM_t& x, bool use_initial_guess);
+    ReturnCode solve_low_rank_update
+    (const DenseM_t& b, DenseM_t& x, bool use_initial_guess);
+    bool add_low_rank_update_to_matrix(const DenseM_t& U, const DenseM_t& V);
+    ReturnCode no_Schur_indices() const;
 
     void delete_factors_internal() override;
 
+    bool write_factors(std::ofstream& os) const override;
+    bool read_factors(std::ifstream& is,
+                      std::unique_ptr<io::MappedFile> f) override;
+
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>> mat_;
     std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd_;
     std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree_;
+    std::vector<integer_t> Schur_idx_;
+    // low-rank update U V^T, with W = A^{-1} U, and K = I + V^T W,
+    // stored in its LU factors
+    DenseM_t lr_U_, lr_V_, lr_W_, lr_K_;
+    std::vector<int> lr_piv_;
+
+    void scaling(std::vector<real_t>& R, std::vector<real_t>& C) const;
 
     using SPBase_t = SparseSolverBase<scalar_t,integer_t>;
     using SPBase_t::opts_;
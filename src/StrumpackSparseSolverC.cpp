@@ -316,6 +316,12 @@ extern "C" {
     switch_precision_return_as(reorder(nx, ny, nz), STRUMPACK_RETURN_CODE);
   }
 
+  STRUMPACK_RETURN_CODE STRUMPACK_reorder_coordinates
+  (STRUMPACK_SparseSolver S, const double* coords, int d, int components) {
+    switch_precision_return_as
+      (reorder(coords, d, components), STRUMPACK_RETURN_CODE);
+  }
+
   STRUMPACK_RETURN_CODE STRUMPACK_factor(STRUMPACK_SparseSolver S) {
     switch_precision_return_as(factor(), STRUMPACK_RETURN_CODE);
   }
@@ -306,11 +306,13 @@ namespace strumpack {
     void setup_tree() override;
     void setup_reordering() override;
     int compute_reordering(const int* p, int base, int nx, int ny, int nz,
-                           int components, int width) override;
+                           int components, int width,
+                           const double* coords, int d) override;
     void separator_reordering() override;
 
     void perf_counters_stop(const std::string& s) override;
     void synchronize() override { comm_.barrier(); }
+    bool symmetric_factorization_supported() const override { return false; }
     void reduce_flop_counters() const override;
 
     void redistribute_values();
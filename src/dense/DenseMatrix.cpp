@@ -168,9 +168,32 @@ namespace strumpack {
   (random::RandomGeneratorBase<typename RealType<scalar_t>::
    value_type>& rgen) {
     TIMER_TIME(TaskType::RANDOM_GENERATE, 1, t_gen);
-    for (std::size_t j=0; j<cols(); j++)
-      for (std::size_t i=0; i<rows(); i++)
-        operator()(i,j) = rgen.get();
+    if (rgen.counter_based()) {
+      // element (i,j) is element j*rows()+i of the random sequence,
+      // so columns can be generated independently, in blocks
+      const std::size_t m = rows(), n = cols();
+      const random::RandomGeneratorBase<real_t>& crgen = rgen;
+#if defined(_OPENMP) && defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+#pragma omp taskloop default(shared)
+#endif
+      for (std::size_t j=0; j<n; j++) {
+        const std::size_t B = 64;
+        real_t r[B];
+        for (std::size_t i=0; i<m; i+=B) {
+          auto nb = std::min(B, m-i);
+          crgen.fill(std::uint64_t(j)*m+i, nb, r);
+          for (std::size_t k=0; k<nb; k++)
+            operator()(i+k,j) = r[k];
+        }
+      }
+      rgen.discard(std::uint64_t(m)*n);
+    } else {
+      for (std::size_t j=0; j<cols(); j++)
+        for (std::size_t i=0; i<rows(); i++)
+          operator()(i,j) = rgen.get();
+    }
     STRUMPACK_FLOPS(rgen.flops_per_prng()*cols()*rows());
   }
 
@@ -861,9 +884,14 @@ namespace strumpack {
     int v[3];
     get_version(v[0], v[1], v[2]);
     os.write((const char*)v, sizeof(v));
-    os.write((const char*)(&D), sizeof(DenseMatrix<scalar_t>));
-      os.write((const char*)(D.data()), sizeof(scalar_t)*D.rows()*D.cols());
-      return os;
+    // write the dimensions, not the object itself, which contains
+    // pointers (vtable and data) that are not valid in another run
+    std::size_t m = D.rows(), n = D.cols();
+    os.write((const char*)&m, sizeof(m));
+    os.write((const char*)&n, sizeof(n));
+    for (std::size_t j=0; j<n; j++)
+      os.write((const char*)(D.ptr(0, j)), sizeof(scalar_t)*m);
+    return os;
   }
   template std::ofstream& operator<<(std::ofstream& os, const DenseMatrix<float>& D);
   template std::ofstream& operator<<(std::ofstream& os, const DenseMatrix<double>& D);
@@ -883,9 +911,12 @@ namespace strumpack {
                 << v[0] << "." << v[1] << "." << v[2]
                 << ")" << std::endl;
     }
-    is.read((char*)&D, sizeof(DenseMatrix<scalar_t>));
-    D.data_ = new scalar_t[D.rows()*D.cols()];
-    is.read((char*)D.data(), sizeof(scalar_t)*D.rows()*D.cols());
+    std::size_t m = 0, n = 0;
+    is.read((char*)&m, sizeof(m));
+    is.read((char*)&n, sizeof(n));
+    if (!is) return is;
+    D = DenseMatrix<scalar_t>(m, n);
+    is.read((char*)D.data(), sizeof(scalar_t)*m*n);
     return is;
   }
   template std::ifstream& operator>>(std::ifstream& os, DenseMatrix<float>& D);
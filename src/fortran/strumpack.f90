@@ -97,10 +97,11 @@ module strumpack
   enumerator :: STRUMPACK_PTSCOTCH = 4
   enumerator :: STRUMPACK_RCM = 5
   enumerator :: STRUMPACK_GEOMETRIC = 6
+  enumerator :: STRUMPACK_ND = 7
  end enum
  integer, parameter, public :: STRUMPACK_REORDERING_STRATEGY = kind(STRUMPACK_NATURAL)
  public :: STRUMPACK_NATURAL, STRUMPACK_METIS, STRUMPACK_PARMETIS, STRUMPACK_SCOTCH, STRUMPACK_PTSCOTCH, STRUMPACK_RCM, &
-    STRUMPACK_GEOMETRIC
+    STRUMPACK_GEOMETRIC, STRUMPACK_ND
  ! typedef enum STRUMPACK_GRAM_SCHMIDT_TYPE
  enum, bind(c)
   enumerator :: STRUMPACK_CLASSICAL = 0
@@ -140,9 +141,13 @@ module strumpack
   enumerator :: STRUMPACK_SUCCESS = 0
   enumerator :: STRUMPACK_MATRIX_NOT_SET = 1
   enumerator :: STRUMPACK_REORDERING_ERROR = 2
+  enumerator :: STRUMPACK_FILE_ERROR = 3
+  enumerator :: STRUMPACK_NOT_SUPPORTED = 4
+  enumerator :: STRUMPACK_INVALID_ARGUMENT = 5
  end enum
  integer, parameter, public :: STRUMPACK_RETURN_CODE = kind(STRUMPACK_SUCCESS)
- public :: STRUMPACK_SUCCESS, STRUMPACK_MATRIX_NOT_SET, STRUMPACK_REORDERING_ERROR
+ public :: STRUMPACK_SUCCESS, STRUMPACK_MATRIX_NOT_SET, STRUMPACK_REORDERING_ERROR, &
+    STRUMPACK_FILE_ERROR, STRUMPACK_NOT_SUPPORTED, STRUMPACK_INVALID_ARGUMENT
  public :: STRUMPACK_init_mt
  public :: STRUMPACK_destroy
  public :: STRUMPACK_set_csr_matrix
@@ -151,6 +156,7 @@ module strumpack
  public :: STRUMPACK_set_from_options
  public :: STRUMPACK_reorder
  public :: STRUMPACK_reorder_regular
+ public :: STRUMPACK_reorder_coordinates
  public :: STRUMPACK_factor
  public :: STRUMPACK_move_to_gpu
  public :: STRUMPACK_remove_from_gpu
@@ -299,6 +305,18 @@ integer(C_INT), intent(in), value :: nz
 integer(C_INT) :: fresult
 end function
 
+function STRUMPACK_reorder_coordinates(s, coords, d, components) &
+bind(C, name="STRUMPACK_reorder_coordinates") &
+result(fresult)
+use, intrinsic :: ISO_C_BINDING
+import :: strumpack_sparsesolver
+type(STRUMPACK_SparseSolver), intent(in), value :: s
+type(C_PTR), value :: coords
+integer(C_INT), intent(in), value :: d
+integer(C_INT), intent(in), value :: components
+integer(C_INT) :: fresult
+end function
+
 function STRUMPACK_factor(s) &
 bind(C, name="STRUMPACK_factor") &
 result(fresult)
@@ -0,0 +1,196 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ */
+/*! \file BinaryIO.hpp
+ * \brief Helper routines for the binary (factorization) file format.
+ */
+#ifndef STRUMPACK_BINARY_IO_HPP
+#define STRUMPACK_BINARY_IO_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define STRUMPACK_HAVE_MMAP
+#endif
+
+namespace strumpack {
+  namespace io {
+
+    /**
+     * Blocks of numerical data in binary files are aligned to this
+     * many bytes, so they can be used directly from a memory mapping
+     * of the file.
+     */
+    const std::size_t alignment = 64;
+
+    /**
+     * Number of bytes left to read in the input stream, used to
+     * bound sizes read from a (possibly truncated or corrupt) file
+     * before allocating memory.
+     */
+    inline std::uint64_t remaining(std::ifstream& is) {
+      auto pos = is.tellg();
+      if (pos < 0) return 0;
+      is.seekg(0, std::ios::end);
+      auto end = is.tellg();
+      is.seekg(pos);
+      return end > pos ? std::uint64_t(end - pos) : 0;
+    }
+
+    template<typename T> void
+    write_binary(std::ofstream& os, const T& v) {
+      os.write((const char*)&v, sizeof(T));
+    }
+    template<typename T> void
+    read_binary(std::ifstream& is, T& v) {
+      is.read((char*)&v, sizeof(T));
+    }
+
+    template<typename T> void
+    write_binary(std::ofstream& os, const std::vector<T>& v) {
+      std::uint64_t n = v.size();
+      os.write((const char*)&n, sizeof(n));
+      os.write((const char*)v.data(), sizeof(T)*n);
+    }
+    template<typename T> void
+    read_binary(std::ifstream& is, std::vector<T>& v) {
+      std::uint64_t n = 0;
+      is.read((char*)&n, sizeof(n));
+      if (!is) return;
+      if (n > remaining(is) / sizeof(T)) {
+        is.setstate(std::ios::failbit);
+        return;
+      }
+      v.resize(n);
+      is.read((char*)v.data(), sizeof(T)*n);
+    }
+
+    inline void write_binary(std::ofstream& os, const std::string& s) {
+      std::uint64_t n = s.size();
+      os.write((const char*)&n, sizeof(n));
+      os.write(s.data(), n);
+    }
+    inline void read_binary(std::ifstream& is, std::string& s) {
+      std::uint64_t n = 0;
+      is.read((char*)&n, sizeof(n));
+      if (!is || n > (1 << 16)) { is.setstate(std::ios::failbit); return; }
+      s.resize(n);
+      is.read(&s[0], n);
+    }
+
+    /**
+     * Pad the output with zeros up to the next multiple of
+     * io::alignment bytes.
+     */
+    inline void align(std::ofstream& os) {
+      auto pad = (alignment - std::size_t(os.tellp()) % alignment)
+        % alignment;
+      const char zeros[alignment] = {0};
+      os.write(zeros, pad);
+    }
+    /**
+     * Skip the padding written by align(std::ofstream&).
+     */
+    inline void align(std::ifstream& is) {
+      auto pad = (alignment - std::size_t(is.tellg()) % alignment)
+        % alignment;
+      is.seekg(pad, std::ios::cur);
+    }
+
+    /**
+     * \class MappedFile
+     * \brief Read-only view of an entire file.
+     *
+     * The file is memory mapped (private, copy-on-write) where
+     * supported, so pages are only loaded when they are accessed,
+     * otherwise it is read into memory.
+     */
+    class MappedFile {
+    public:
+      MappedFile(const std::string& fname) {
+#if defined(STRUMPACK_HAVE_MMAP)
+        int fd = ::open(fname.c_str(), O_RDONLY);
+        if (fd == -1) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+          void* p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+          if (p != MAP_FAILED) {
+            data_ = static_cast<char*>(p);
+            size_ = st.st_size;
+          }
+        }
+        ::close(fd);
+#else
+        std::ifstream f(fname, std::ios::binary | std::ios::ate);
+        if (!f) return;
+        size_ = f.tellg();
+        buf_.reset(new char[size_]);
+        f.seekg(0);
+        f.read(buf_.get(), size_);
+        data_ = buf_.get();
+#endif
+      }
+      ~MappedFile() {
+#if defined(STRUMPACK_HAVE_MMAP)
+        if (data_) munmap(data_, size_);
+#endif
+      }
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      bool good() const { return data_ != nullptr; }
+      std::size_t size() const { return size_; }
+
+      /**
+       * Pointer to byte offset in the file, or nullptr when the data
+       * [offset, offset+bytes) is not in the file.
+       */
+      template<typename T> T* data(std::size_t offset, std::size_t bytes) {
+        if (!data_ || offset + bytes > size_) return nullptr;
+        return reinterpret_cast<T*>(data_ + offset);
+      }
+
+    private:
+      char* data_ = nullptr;
+      std::size_t size_ = 0;
+#if !defined(STRUMPACK_HAVE_MMAP)
+      std::unique_ptr<char[]> buf_;
+#endif
+    };
+
+  } // end namespace io
+} // end namespace strumpack
+
+#endif // STRUMPACK_BINARY_IO_HPP
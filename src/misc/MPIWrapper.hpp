@@ -636,11 +636,17 @@ namespace strumpack {
      * received from different ranks start
      * \param Ttype MPI_Datatype corresponding to the template
      * parameter T
+     * \param rs if not null, the number of elements received from
+     * each rank. When this is already of size this->size(), for
+     * instance from an earlier call with the same communication
+     * pattern, the exchange of the sizes is skipped, otherwise it is
+     * filled in.
      * \see all_to_all_v
      */
     template<typename T, typename A=std::allocator<T>> void
     all_to_all_v(std::vector<std::vector<T>>& sbuf, std::vector<T,A>& rbuf,
-                 std::vector<T*>& pbuf, const MPI_Datatype Ttype) const {
+                 std::vector<T*>& pbuf, const MPI_Datatype Ttype,
+                 std::vector<int>* rs=nullptr) const {
       assert(sbuf.size() == std::size_t(size()));
       auto P = size();
       std::unique_ptr<int[]> iwork(new int[4*P]);
@@ -657,8 +663,13 @@ namespace strumpack {
         }
         ssizes[p] = sbuf[p].size();
       }
-      MPI_Alltoall
-        (ssizes, 1, mpi_type<int>(), rsizes, 1, mpi_type<int>(), comm_);
+      if (rs && rs->size() == std::size_t(P))
+        std::copy(rs->begin(), rs->end(), rsizes);
+      else {
+        MPI_Alltoall
+          (ssizes, 1, mpi_type<int>(), rsizes, 1, mpi_type<int>(), comm_);
+        if (rs) rs->assign(rsizes, rsizes+P);
+      }
       std::size_t totssize = std::accumulate(ssizes, ssizes+P, std::size_t(0)),
         totrsize = std::accumulate(rsizes, rsizes+P, std::size_t(0));
       if (totrsize >
@@ -36,6 +36,9 @@
 #include <memory>
 #include <random>
 #include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 
 namespace strumpack {
 
@@ -51,7 +54,9 @@ namespace strumpack {
      */
     enum class RandomEngine {
       LINEAR,   /*!< The C++11 std::minstd_rand random number generator. */
-      MERSENNE  /*!< The C++11 std::mt19937 random number generator.     */
+      MERSENNE, /*!< The C++11 std::mt19937 random number generator.     */
+      PHILOX    /*!< Counter based Philox4x32-10 generator, see
+                  PhiloxRandomGenerator.                              */
     };
 
     /**
@@ -63,6 +68,7 @@ namespace strumpack {
       switch (e) {
       case RandomEngine::LINEAR: return "minstd_rand"; break;
       case RandomEngine::MERSENNE: return "mt19937"; break;
+      case RandomEngine::PHILOX: return "philox4x32-10"; break;
       }
       return "unknown";
     }
@@ -111,6 +117,37 @@ namespace strumpack {
       virtual real_t get() = 0;
       virtual real_t get(std::uint32_t i, std::uint32_t j) = 0;
       virtual int flops_per_prng() = 0;
+
+      /**
+       * Fill x with the next n elements of the random sequence.
+       */
+      virtual void fill(std::size_t n, real_t* x) {
+        for (std::size_t i=0; i<n; i++) x[i] = get();
+      }
+
+      /**
+       * Check whether this is a counter based generator. For a
+       * counter based generator, any element of the sequence can be
+       * computed directly, in constant time, using
+       * fill(std::uint64_t, std::size_t, real_t*).
+       */
+      virtual bool counter_based() const { return false; }
+
+      /**
+       * Compute elements k, k+1, ..., k+n-1 of the random sequence
+       * (relative to the current position), without changing the
+       * state of the generator, so this can be called concurrently
+       * from multiple threads. Unless the generator is counter_based,
+       * this takes O(k+n) time.
+       */
+      virtual void fill(std::uint64_t k, std::size_t n, real_t* x) const = 0;
+
+      /**
+       * Advance the random sequence by n elements.
+       */
+      virtual void discard(std::uint64_t n) {
+        for (std::uint64_t i=0; i<n; i++) get();
+      }
     };
 
     /**
@@ -172,6 +209,18 @@ namespace strumpack {
         return get();
       };
 
+      /**
+       * Elements k, ..., k+n-1 of the sequence, generated with copies
+       * of the engine and the distribution.
+       */
+      void fill(std::uint64_t k, std::size_t n, real_t* x) const {
+        E ec(e);
+        D dc(d);
+        for (std::uint64_t i=0; i<k; i++) dc(ec);
+        for (std::size_t i=0; i<n; i++) x[i] = dc(ec);
+      }
+      using RandomGeneratorBase<real_t>::fill;
+
       /**
        * Return the (approximate) number of flops required to generate
        * a random number.
@@ -190,6 +239,193 @@ namespace strumpack {
       D d;
     };
 
+    /**
+     * \class PhiloxRandomGenerator
+     * \brief Counter based random number generator.
+     *
+     * Uses the Philox4x32-10 bijection from Salmon et al., "Parallel
+     * random numbers: as easy as 1, 2, 3", SC'11. Element k of the
+     * sequence is a function of the key (the seed), the stream (set
+     * with seed(i,j)) and k only, so there is no need to reseed an
+     * engine for every (i,j) pair, elements can be generated in any
+     * order, by multiple threads, and in blocks, with simple loops
+     * over independent counters that the compiler can vectorize.
+     *
+     * Each 128 bit Philox output gives 4 single precision or 2 double
+     * precision uniform numbers, normal numbers are obtained with the
+     * Box-Muller transform.
+     *
+     * \tparam real_t float or double
+     * \tparam D RandomDistribution::NORMAL or RandomDistribution::UNIFORM
+     *
+     * \see RandomGeneratorBase
+     */
+    template<typename real_t, RandomDistribution D>
+    class PhiloxRandomGenerator : public RandomGeneratorBase<real_t> {
+      // number of real_t values obtained from one 4x32 bit block
+      static const int P = (sizeof(real_t) == 4) ? 4 : 2;
+      // counters per batch in fill
+      static const int B = 16;
+
+    public:
+      PhiloxRandomGenerator() { seed(std::size_t(0)); }
+      PhiloxRandomGenerator(std::size_t s) { seed(s); }
+
+      void seed(std::size_t s) {
+        key_[0] = std::uint32_t(s);
+        key_[1] = std::uint32_t(std::uint64_t(s) >> 32);
+        stream_[0] = stream_[1] = 0;
+        pos_ = 0;
+      }
+
+      void seed(std::seed_seq& s) {
+        std::uint32_t k[2];
+        s.generate(k, k+2);
+        seed(std::size_t(k[0]) | (std::size_t(k[1]) << 32));
+      }
+
+      /**
+       * Select the stream (i,j), and restart at the first element of
+       * that stream. This does not change the key.
+       */
+      void seed(std::uint32_t i, std::uint32_t j) {
+        stream_[0] = i;
+        stream_[1] = j;
+        pos_ = 0;
+      }
+
+      real_t get() {
+        if (pos_ % P == 0) block(pos_ / P, cur_);
+        return cur_[pos_++ % P];
+      }
+
+      real_t get(std::uint32_t i, std::uint32_t j) {
+        seed(i, j);
+        return get();
+      }
+
+      int flops_per_prng() {
+        return (D == RandomDistribution::NORMAL) ? 23 : 7;
+      }
+
+      void fill(std::size_t n, real_t* x) {
+        std::size_t i = 0;
+        for (; i<n && pos_ % P; i++) x[i] = get();
+        if (i == n) return;
+        fill(0, n-i, x+i);
+        discard(n-i);
+      }
+
+      bool counter_based() const { return true; }
+
+      void fill(std::uint64_t k, std::size_t n, real_t* x) const {
+        k += pos_;
+        std::size_t i = 0;
+        // leading partial block
+        for (; i<n && (k+i) % P; i++) {
+          real_t r[P];
+          block((k+i) / P, r);
+          x[i] = r[(k+i) % P];
+        }
+        // full batches of B blocks
+        real_t r[B*P];
+        for (; i+B*P<=n; i+=B*P) {
+          batch<B>((k+i) / P, r);
+          std::copy(r, r+B*P, x+i);
+        }
+        // remaining elements, one block at a time
+        for (; i<n; i+=P) {
+          block((k+i) / P, r);
+          std::copy(r, r+std::min(std::size_t(P), n-i), x+i);
+        }
+      }
+
+      void discard(std::uint64_t n) {
+        // cur_ holds block pos_ / P only if pos_ % P != 0
+        auto p = pos_ + n;
+        if (p % P && (pos_ % P == 0 || pos_ / P != p / P))
+          block(p / P, cur_);
+        pos_ = p;
+      }
+
+    private:
+      std::uint32_t key_[2], stream_[2];
+      std::uint64_t pos_;
+      real_t cur_[P];
+
+      /**
+       * Philox4x32-10 applied to N consecutive counters, starting at
+       * c, then converted to N*P numbers with distribution D.
+       */
+      template<int N> void batch(std::uint64_t c, real_t* r) const {
+        const std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57,
+          W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+        std::uint32_t x0[N], x1[N], x2[N], x3[N];
+        for (int b=0; b<N; b++) {
+          x0[b] = std::uint32_t(c + b);
+          x1[b] = std::uint32_t((c + b) >> 32);
+          x2[b] = stream_[0];
+          x3[b] = stream_[1];
+        }
+        std::uint32_t k0 = key_[0], k1 = key_[1];
+        for (int round=0; round<10; round++) {
+          for (int b=0; b<N; b++) {
+            std::uint64_t p0 = std::uint64_t(M0) * x0[b];
+            std::uint64_t p1 = std::uint64_t(M1) * x2[b];
+            std::uint32_t y0 = std::uint32_t(p1 >> 32) ^ x1[b] ^ k0;
+            std::uint32_t y2 = std::uint32_t(p0 >> 32) ^ x3[b] ^ k1;
+            x1[b] = std::uint32_t(p1);
+            x3[b] = std::uint32_t(p0);
+            x0[b] = y0;
+            x2[b] = y2;
+          }
+          k0 += W0;
+          k1 += W1;
+        }
+        for (int b=0; b<N; b++)
+          to_real(x0[b], x1[b], x2[b], x3[b], r+b*P);
+      }
+
+      void block(std::uint64_t c, real_t* r) const { batch<1>(c, r); }
+
+      // 24 random bits per float, uniform in [0,1)
+      static void
+      uniform(std::uint32_t x0, std::uint32_t x1,
+              std::uint32_t x2, std::uint32_t x3, float* u) {
+        const float s = 1.f / 16777216.f;
+        u[0] = float(x0 >> 8) * s;
+        u[1] = float(x1 >> 8) * s;
+        u[2] = float(x2 >> 8) * s;
+        u[3] = float(x3 >> 8) * s;
+      }
+      // 53 random bits per double, uniform in [0,1)
+      static void
+      uniform(std::uint32_t x0, std::uint32_t x1,
+              std::uint32_t x2, std::uint32_t x3, double* u) {
+        const double s = 1. / 9007199254740992.;
+        u[0] = double(((std::uint64_t(x0) << 32) | x1) >> 11) * s;
+        u[1] = double(((std::uint64_t(x2) << 32) | x3) >> 11) * s;
+      }
+
+      static void
+      to_real(std::uint32_t x0, std::uint32_t x1,
+              std::uint32_t x2, std::uint32_t x3, real_t* r) {
+        real_t u[P];
+        uniform(x0, x1, x2, x3, u);
+        if (D == RandomDistribution::NORMAL) {
+          // Box-Muller, 1-u is in (0,1]
+          const real_t twopi = real_t(6.283185307179586);
+          for (int i=0; i<P; i+=2) {
+            real_t rad = std::sqrt(real_t(-2.) * std::log(real_t(1.)-u[i]));
+            real_t theta = twopi * u[i+1];
+            r[i] = rad * std::cos(theta);
+            r[i+1] = rad * std::sin(theta);
+          }
+        } else
+          for (int i=0; i<P; i++) r[i] = u[i];
+      }
+    };
+
     /**
      * Factory method to construct a RandomGeneratorBase with a
      * specified random engine and random distribution, with seed s.
@@ -221,6 +457,15 @@ namespace strumpack {
           return std::unique_ptr<RandomGeneratorBase<real_t>>
             (new RandomGenerator<real_t,std::mt19937,
              std::uniform_real_distribution<real_t>>(seed));
+      } else if (e == RandomEngine::PHILOX) {
+        if (d == RandomDistribution::NORMAL)
+          return std::unique_ptr<RandomGeneratorBase<real_t>>
+            (new PhiloxRandomGenerator<real_t,RandomDistribution::NORMAL>
+             (seed));
+        else if (d == RandomDistribution::UNIFORM)
+          return std::unique_ptr<RandomGeneratorBase<real_t>>
+            (new PhiloxRandomGenerator<real_t,RandomDistribution::UNIFORM>
+             (seed));
       }
       return NULL;
     }
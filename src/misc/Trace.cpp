@@ -0,0 +1,198 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "Trace.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include <mpi.h>
+#endif
+
+namespace strumpack {
+  namespace trace {
+
+    std::atomic<bool> active{false};
+
+    namespace {
+      struct Record {
+        double begin, end;
+        long long front, dsep, dupd;
+        int level, rank;
+        Event e;
+      };
+      // one ring per thread, only written by that thread
+      struct Ring {
+        Ring(int t, std::size_t cap) : tid(t), ev(cap) {}
+        int tid;
+        std::atomic<std::size_t> head{0};
+        std::vector<Record> ev;
+      };
+      struct Rings {
+        Rings(std::size_t c, long long g) : cap(c), gen(g) {}
+        std::size_t cap;
+        // distinguishes these rings from earlier ones, which might
+        // have been allocated at the same address
+        long long gen;
+        // only locked when a thread records its first event
+        std::mutex mtx;
+        std::vector<std::unique_ptr<Ring>> r;
+      };
+      std::atomic<Rings*> rings{nullptr};
+      // number of calls to record or write in progress, disable waits
+      // for these before deleting the rings
+      std::atomic<int> busy{0};
+      long long generation = 0;
+      // number of calls to enable not yet matched by disable
+      int users = 0;
+      std::mutex users_mtx;
+
+      // unique id of the calling thread
+      int thread_id() {
+        static std::atomic<int> next{0};
+        thread_local int id = next++;
+        return id;
+      }
+
+      // the ring of the calling thread in rs, created on first use
+      Ring& thread_ring(Rings& rs) {
+        thread_local long long gen = -1;
+        thread_local Ring* ring = nullptr;
+        if (gen != rs.gen) {
+          std::lock_guard<std::mutex> lock(rs.mtx);
+          rs.r.emplace_back(new Ring(thread_id(), rs.cap));
+          ring = rs.r.back().get();
+          gen = rs.gen;
+        }
+        return *ring;
+      }
+
+      // keeps the rings alive while in scope
+      struct Use {
+        Use() { busy++; rs = rings.load(); }
+        ~Use() { busy--; }
+        Rings* rs;
+      };
+    }
+
+    std::string get_name(Event e) {
+      switch (e) {
+      case Event::ASSEMBLY: return "assembly";
+      case Event::EXTEND_ADD: return "extend_add";
+      case Event::FACTOR: return "factor";
+      case Event::COMPRESS: return "compress";
+      case Event::FORWARD_SOLVE: return "forward_solve";
+      case Event::BACKWARD_SOLVE: return "backward_solve";
+      }
+      return "UNKNOWN";
+    }
+
+    void enable(std::size_t capacity) {
+      std::lock_guard<std::mutex> lock(users_mtx);
+      if (users++) return;
+      rings.store(new Rings(capacity, generation++));
+      active = true;
+    }
+
+    void disable() {
+      std::lock_guard<std::mutex> lock(users_mtx);
+      if (!users || --users) return;
+      active = false;
+      auto rs = rings.exchange(nullptr);
+      while (busy.load()) std::this_thread::yield();
+      delete rs;
+    }
+
+    void record(Event e, double begin, double end, long long front,
+                int level, long long dim_sep, long long dim_upd,
+                int rank) {
+      Use u;
+      if (!u.rs) return;
+      auto& r = thread_ring(*u.rs);
+      auto cap = u.rs->cap;
+      auto i = r.head.load(std::memory_order_relaxed);
+      r.ev[i % cap] = Record{begin, end, front, dim_sep, dim_upd,
+                             level, rank, e};
+      r.head.store(i+1, std::memory_order_release);
+    }
+
+    void write(const std::string& fname) {
+      Use u;
+      auto rs = u.rs;
+      if (!rs) return;
+      auto cap = rs->cap;
+      int pid = 0;
+      std::string f(fname);
+#if defined(STRUMPACK_USE_MPI)
+      int init = 0, fin = 0;
+      MPI_Initialized(&init);
+      MPI_Finalized(&fin);
+      if (init && !fin) {
+        MPI_Comm_rank(MPI_COMM_WORLD, &pid);
+        auto dot = f.rfind(".json");
+        if (dot == std::string::npos) dot = f.size();
+        f.insert(dot, "_" + std::to_string(pid));
+      }
+#endif
+      std::ofstream os(f);
+      if (!os) {
+        std::cerr << "# ERROR: could not open trace file "
+                  << f << std::endl;
+        return;
+      }
+      os << std::fixed << std::setprecision(3)
+         << "{\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+         << ",\"args\":{\"name\":\"rank " << pid << "\"}}";
+      std::lock_guard<std::mutex> lock(rs->mtx);
+      for (auto& pr : rs->r) {
+        auto& r = *pr;
+        std::size_t n = r.head.load(std::memory_order_acquire);
+        for (std::size_t i=(n > cap ? n-cap : 0); i<n; i++) {
+          auto& ev = r.ev[i % cap];
+          os << ",\n{\"name\":\"" << get_name(ev.e)
+             << "\",\"cat\":\"front\",\"ph\":\"X\",\"ts\":" << ev.begin
+             << ",\"dur\":" << ev.end - ev.begin
+             << ",\"pid\":" << pid << ",\"tid\":" << r.tid
+             << ",\"args\":{\"front\":" << ev.front
+             << ",\"level\":" << ev.level
+             << ",\"dim_sep\":" << ev.dsep << ",\"dim_upd\":" << ev.dupd;
+          if (ev.rank >= 0) os << ",\"rank\":" << ev.rank;
+          os << "}}";
+        }
+      }
+      os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    }
+
+  } // end namespace trace
+} // end namespace strumpack
@@ -0,0 +1,140 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*! \file Trace.hpp
+ * \brief Recording of a timeline of the work on the fronts, written
+ * as a Chrome trace file.
+ */
+#ifndef STRUMPACK_TRACE_HPP
+#define STRUMPACK_TRACE_HPP
+
+#include <string>
+#include <chrono>
+#include <atomic>
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t> class FrontalMatrix;
+
+  /**
+   * A timeline of the work on each front, the assembly, extend-add,
+   * factorization, compression and solve, with for each event the
+   * front, its etree level and dimensions, the rank (for compressed
+   * fronts), the thread and the MPI rank. Events are stored in a ring
+   * buffer per thread, without locking (except when a thread records
+   * its first event), and are written at the end as a Chrome
+   * trace-event JSON file, which can be viewed in chrome://tracing or
+   * https://ui.perfetto.dev. This is enabled from
+   * the solver with SPOptions::set_trace_file.
+   */
+  namespace trace {
+
+    enum class Event : int {
+      ASSEMBLY, EXTEND_ADD, FACTOR, COMPRESS, FORWARD_SOLVE, BACKWARD_SOLVE
+    };
+
+    std::string get_name(Event e);
+
+    /**
+     * Start recording, or, if already enabled, register one more
+     * user, for instance another solver. Every call should be matched
+     * by a call to disable. When a thread records more than capacity
+     * events, the oldest are overwritten. The capacity is set by the
+     * first user.
+     */
+    void enable(std::size_t capacity=1 << 16);
+
+    /**
+     * Remove a user registered with enable. When there are no users
+     * left, stop recording and discard all events. An event which is
+     * still being recorded, by a Region created before, is dropped.
+     */
+    void disable();
+
+    extern std::atomic<bool> active;
+    inline bool enabled() {
+      return active.load(std::memory_order_relaxed);
+    }
+
+    inline double now() {
+      return std::chrono::duration<double,std::micro>
+        (std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(Event e, double begin, double end, long long front,
+                int level, long long dim_sep, long long dim_upd, int rank);
+
+    /**
+     * Write all events recorded so far, by all users, as Chrome
+     * trace-event JSON. When MPI
+     * is initialized, each process writes its own file, with the MPI
+     * rank added to the file name, using the rank as process id, so
+     * timestamps line up (within a node).
+     */
+    void write(const std::string& fname);
+
+    /**
+     * Records the time between construction and destruction of this
+     * object as an event, if tracing is enabled.
+     */
+    class Region {
+    public:
+      Region(Event e, long long front, int level,
+             long long dim_sep, long long dim_upd)
+        : on_(enabled()), e_(e), front_(front), level_(level),
+          dsep_(dim_sep), dupd_(dim_upd) {
+        if (on_) begin_ = now();
+      }
+      /**
+       * Event for the front f, at etree level level.
+       */
+      template<typename scalar_t,typename integer_t>
+      Region(Event e, const FrontalMatrix<scalar_t,integer_t>& f, int level)
+        : Region(e, f.sep(), level, f.dim_sep(), f.dim_upd()) {}
+      Region(const Region&) = delete;
+      Region& operator=(const Region&) = delete;
+      ~Region() {
+        if (on_)
+          record(e_, begin_, now(), front_, level_, dsep_, dupd_, rank_);
+      }
+      void set_rank(int r) { rank_ = r; }
+
+    private:
+      bool on_;
+      Event e_;
+      long long front_;
+      int level_;
+      long long dsep_, dupd_;
+      int rank_ = -1;
+      double begin_ = 0.;
+    };
+
+  } // end namespace trace
+} // end namespace strumpack
+
+#endif // STRUMPACK_TRACE_HPP
@@ -170,6 +170,7 @@ namespace strumpack {
               << ", nnz=" << number_format_with_commas(nnz_)
               << std::endl;
     symm_sparse_ = false;
+    this->clear_transpose();
     ptr_.resize(n_+1);
     ind_.resize(nnz_);
     val_.resize(nnz_);
@@ -228,45 +229,84 @@ namespace strumpack {
     STRUMPACK_BYTES(this->spmv_bytes());
   }
 
+  /**
+   * y(:,0:NB) = A x(:,0:NB), with A given by ptr, ind and the value
+   * of nonzero j as val(j). The NB vectors are handled in a single
+   * traversal of the rows.
+   */
+  template<int NB, typename scalar_t, typename integer_t, typename VAL>
+  void spmm_block(integer_t n, const integer_t* ptr, const integer_t* ind,
+                  const VAL& val, const scalar_t* x, std::size_t ldx,
+                  scalar_t* y, std::size_t ldy) {
+#pragma omp parallel for
+    for (integer_t r=0; r<n; r++) {
+      scalar_t yr[NB];
+      for (int c=0; c<NB; c++) yr[c] = scalar_t(0.);
+      const auto hij = ptr[r+1];
+      for (integer_t j=ptr[r]; j<hij; j++) {
+        const scalar_t v = val(j);
+        const scalar_t* xj = x + ind[j];
+        for (int c=0; c<NB; c++)
+          yr[c] += v * xj[c*ldx];
+      }
+      for (int c=0; c<NB; c++)
+        y[r+c*ldy] = yr[c];
+    }
+  }
+
+  template<typename scalar_t, typename integer_t, typename VAL> void
+  spmm(integer_t n, const integer_t* ptr, const integer_t* ind,
+       const VAL& val, const DenseMatrix<scalar_t>& x,
+       DenseMatrix<scalar_t>& y) {
+    std::size_t c = 0;
+    const auto nrhs = x.cols();
+    for (; c+8<=nrhs; c+=8)
+      spmm_block<8>(n, ptr, ind, val, x.ptr(0,c), x.ld(), y.ptr(0,c), y.ld());
+    if (c+4<=nrhs) {
+      spmm_block<4>(n, ptr, ind, val, x.ptr(0,c), x.ld(), y.ptr(0,c), y.ld());
+      c += 4;
+    }
+    if (c+2<=nrhs) {
+      spmm_block<2>(n, ptr, ind, val, x.ptr(0,c), x.ld(), y.ptr(0,c), y.ld());
+      c += 2;
+    }
+    if (c<nrhs)
+      spmm_block<1>(n, ptr, ind, val, x.ptr(0,c), x.ld(), y.ptr(0,c), y.ld());
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (const DenseM_t& x, DenseM_t& y) const {
     // assert(x.cols() == y.cols());
     // assert(x.rows() == std::size_t(n_));
     // assert(y.rows() == std::size_t(n_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    if (x.cols() == 1) {
+      spmv(x.data(), y.data());
+      return;
+    }
+    auto val = [this](integer_t j) { return val_[j]; };
+    spmm(n_, ptr_.data(), ind_.data(), val, x, y);
+    STRUMPACK_FLOPS(x.cols()*this->spmv_flops());
+    STRUMPACK_BYTES(x.cols()*this->spmv_bytes());
   }
 
-  // TODO use MKL routines for better performance
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (Trans op, const DenseM_t& x, DenseM_t& y) const {
-    if (op != Trans::N) y.zero();
-    for (std::size_t c=0; c<x.cols(); c++) {
-      auto px = x.ptr(0, c);
-      auto py = y.ptr(0, c);
-      if (op == Trans::N) {
-        for (integer_t r=0; r<n_; r++) {
-          const auto hij = ptr_[r+1];
-          scalar_t yr(0);
-          for (integer_t j=ptr_[r]; j<hij; j++)
-            yr += val_[j] * px[ind_[j]];
-          py[r] = yr;
-        }
-      } else if (op == Trans::T) {
-        for (integer_t r=0; r<n_; r++) {
-          const auto hij = ptr_[r+1];
-          for (integer_t j=ptr_[r]; j<hij; j++)
-            py[ind_[j]] += val_[j] * px[r];
-        }
-      } else if (op == Trans::C) {
-        for (integer_t r=0; r<n_; r++) {
-          const auto hij = ptr_[r+1];
-          for (integer_t j=ptr_[r]; j<hij; j++)
-            py[ind_[j]] += blas::my_conj(val_[j]) * px[r];
-        }
-      }
+    if (op == Trans::N) {
+      spmv(x, y);
+      return;
+    }
+    // the rows of the transpose are traversed in parallel, so no
+    // atomic updates are needed
+    this->build_transpose();
+    if (op == Trans::T) {
+      auto val = [this](integer_t j) { return val_[tpos_[j]]; };
+      spmm(n_, tptr_.data(), tind_.data(), val, x, y);
+    } else {
+      auto val = [this](integer_t j) {
+        return blas::my_conj(val_[tpos_[j]]); };
+      spmm(n_, tptr_.data(), tind_.data(), val, x, y);
     }
     STRUMPACK_FLOPS(x.cols()*this->spmv_flops());
     STRUMPACK_BYTES(x.cols()*this->spmv_bytes());
@@ -464,6 +504,45 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  CSRMatrix<scalar_t,integer_t>::push_front_positions
+  (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+   std::vector<Triplet<integer_t,integer_t>>& e11,
+   std::vector<Triplet<integer_t,integer_t>>& e12,
+   std::vector<Triplet<integer_t,integer_t>>& e21) const {
+    integer_t ds = shi - slo, du = upd.size();
+    for (integer_t row=0; row<ds; row++) { // separator rows
+      integer_t upd_ptr = 0;
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            e11.emplace_back(row, col-slo, j);
+          else {
+            while (upd_ptr<du && upd[upd_ptr]<col) upd_ptr++;
+            if (upd_ptr == du) break;
+            if (upd[upd_ptr] == col)
+              e12.emplace_back(row, upd_ptr, j);
+          }
+        }
+      }
+    }
+    for (integer_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            e21.emplace_back(i, col-slo, j);
+          else break;
+        }
+      }
+    }
+    return true;
+  }
+
 
   // TODO parallel -> will be hard to do efficiently
   // assume F11, F12 and F21 are set to zero
@@ -481,6 +560,7 @@ namespace strumpack {
           if (col < shi)
             F11(row, col-slo) = val_[j];
           else {
+            if (!F12.cols()) break; // F12 not stored (symmetric)
             while (upd_ptr<du && upd[upd_ptr]<col)
               upd_ptr++;
             if (upd_ptr == du) break;
@@ -788,6 +868,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::permute_columns
   (const std::vector<integer_t>& perm) {
+    this->clear_transpose();
     std::unique_ptr<integer_t[]> iperm(new integer_t[n_]);
     for (integer_t i=0; i<n_; i++) iperm[perm[i]] = i;
 #pragma omp parallel for
@@ -802,33 +883,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   CSRMatrix<scalar_t,integer_t>::read_matrix_market
   (const std::string& filename) {
-    using Triplet = std::tuple<integer_t,integer_t,scalar_t>;
-    std::vector<Triplet> A;
-    try {
-      A = this->read_matrix_market_entries(filename);
-    } catch (...) { return 1; }
-    std::sort
-      (A.begin(), A.end(),
-       [](const Triplet& a, const Triplet& b) -> bool {
-         // sort based on the row,column indices
-         return std::make_tuple(std::get<0>(a),std::get<1>(a)) <
-           std::make_tuple(std::get<0>(b), std::get<1>(b));
-       });
-    ptr_.resize(n_+1);
-    ind_.resize(nnz_);
-    val_.resize(nnz_);
-    integer_t row = -1;
-    for (integer_t i=0; i<nnz_; i++) {
-      val_[i] = std::get<2>(A[i]);
-      ind_[i] = std::get<1>(A[i]);
-      auto new_row = std::get<0>(A[i]);
-      if (new_row != row) {
-        for (int j=row+1; j<=new_row; j++) ptr_[j] = i;
-        row = new_row;
-      }
-    }
-    for (int j=row+1; j<=n_; j++) ptr_[j] = nnz_;
-    return 0;
+    return this->read_matrix_market_rows(filename);
   }
 
   template<typename scalar_t,typename integer_t> typename
@@ -73,6 +73,15 @@ namespace strumpack {
     void spmv(const DenseM_t& x, DenseM_t& y) const override;
     void spmv(const scalar_t* x, scalar_t* y) const override;
 
+    /**
+     * Compute y = op(A) x, for a block of vectors x. The vectors are
+     * processed in blocks, with a single traversal of the sparse
+     * matrix per block. For op = Trans::T or Trans::C, the sparsity
+     * pattern of the transpose is constructed on first use, and kept
+     * until the sparsity pattern is changed by one of the member
+     * functions of this class. It is not updated when the pattern is
+     * modified through the ptr() or ind() pointers.
+     */
     void spmv(Trans op, const DenseM_t& x, DenseM_t& y) const;
 
     Equil_t equilibration() const override;
@@ -122,6 +131,11 @@ namespace strumpack {
      std::vector<Triplet<scalar_t>>&,
      std::vector<Triplet<scalar_t>>&,
      std::vector<Triplet<scalar_t>>&) const override;
+    bool push_front_positions
+    (integer_t, integer_t, const std::vector<integer_t>&,
+     std::vector<Triplet<integer_t,integer_t>>&,
+     std::vector<Triplet<integer_t,integer_t>>&,
+     std::vector<Triplet<integer_t,integer_t>>&) const override;
 
     void front_multiply_F11
     (Trans op, integer_t slo, integer_t shi,
@@ -174,6 +188,9 @@ namespace strumpack {
     using CSM_t::ind_;
     using CSM_t::val_;
     using CSM_t::symm_sparse_;
+    using CSM_t::tptr_;
+    using CSM_t::tind_;
+    using CSM_t::tpos_;
   };
 
   /**
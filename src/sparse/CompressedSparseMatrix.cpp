@@ -31,10 +31,17 @@
 #include <tuple>
 #include <cstdio>
 #include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <sstream>
 #include <exception>
+#include <functional>
 
 #include "CompressedSparseMatrix.hpp"
 #include "misc/Tools.hpp"
+#include "misc/TaskTimer.hpp"
+#include "misc/BinaryIO.hpp"
+#include "StrumpackParameters.hpp"
 #include "CSRGraph.hpp"
 #include "StrumpackConfig.hpp"
 #include "dense/DenseMatrix.hpp"
@@ -68,10 +75,11 @@ namespace strumpack {
       ind_(nnz_), val_(nnz_), symm_sparse_(symm_sparsity) {
     if (row_ptr)
       std::copy(row_ptr, row_ptr+n_+1, ptr());
-    if (col_ind)
-      std::copy(col_ind, col_ind+nnz_, ind());
-    if (values)
-      std::copy(values, values+nnz_, val());
+#pragma omp parallel for
+    for (integer_t i=0; i<nnz_; i++) {
+      if (col_ind) ind_[i] = col_ind[i];
+      if (values) val_[i] = values[i];
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -130,6 +138,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CompressedSparseMatrix<scalar_t,integer_t>::symmetrize_sparsity() {
     if (symm_sparse_) return;
+    clear_transpose();
     std::vector<integer_t> a2_ctr(n_);
 #pragma omp parallel for
     for (integer_t i=0; i<n_; i++)
@@ -195,129 +204,291 @@ namespace strumpack {
     return std::complex<float>(vr, vi);
   }
 
-  template<typename scalar_t,typename integer_t>
-  std::vector<std::tuple<integer_t,integer_t,scalar_t>>
-  CompressedSparseMatrix<scalar_t,integer_t>::read_matrix_market_entries
+  /**
+   * Parse one line "row col value" (or "row col re im") of a matrix
+   * market file, in [p, end). Every field has to be on this line:
+   * leading white space is skipped here, not by strtol/strtod, since
+   * those would skip the newline and continue on the next line (or
+   * read past the end of the file). end should point to a newline or
+   * a null character, which terminates the last number.
+   */
+  inline bool skip_matrix_market_space(const char*& p, const char* end) {
+    while (p < end && *p != '\n' &&
+           std::isspace(static_cast<unsigned char>(*p))) p++;
+    return p < end && *p != '\n';
+  }
+
+  /**
+   * Parse only the row and column index of a line of a matrix market
+   * file, see parse_matrix_market_entry. On success, p is moved past
+   * the column index.
+   */
+  inline bool
+  parse_matrix_market_indices(const char*& p, const char* end,
+                              long long& r, long long& c) {
+    char* e;
+    if (!skip_matrix_market_space(p, end)) return false;
+    r = std::strtoll(p, &e, 10); if (e == p || e > end) return false; p = e;
+    if (!skip_matrix_market_space(p, end)) return false;
+    c = std::strtoll(p, &e, 10); if (e == p || e > end) return false; p = e;
+    return true;
+  }
+
+  template<typename scalar_t> bool
+  parse_matrix_market_entry(const char* p, const char* end,
+                            long long& r, long long& c, scalar_t& v) {
+    char* e;
+    auto next = [&p, end]() { return skip_matrix_market_space(p, end); };
+    if (!parse_matrix_market_indices(p, end, r, c)) return false;
+    if (!next()) return false;
+    double vr = std::strtod(p, &e); if (e == p || e > end) return false;
+    p = e;
+    double vi = 0.;
+    if (is_complex<scalar_t>()) {
+      if (!next()) return false;
+      vi = std::strtod(p, &e); if (e == p || e > end) return false;
+    }
+    v = get_scalar<scalar_t>(vr, vi);
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  CompressedSparseMatrix<scalar_t,integer_t>::read_matrix_market_rows
   (const std::string& filename) {
     std::cout << "# opening file \'" << filename << "\'" << std::endl;
-    FILE *fp = fopen(filename.c_str(), "r");
-    if (fp == NULL) {
-      std::cerr << "ERROR: could not read file";
-      exit(1);
-    }
-    const int max_cline = 256;
-    char cline[max_cline];
-    if (fgets(cline, max_cline, fp) == NULL) {
-      std::cerr << "ERROR: could not read from file" << std::endl;
-      exit(1);
+    TaskTimer t("read_matrix_market");
+    t.start();
+    io::MappedFile f(filename);
+    if (!f.good()) {
+      std::cerr << "ERROR: could not read file " << filename << std::endl;
+      return 1;
     }
-    printf("# %s", cline);
-    if (strstr(cline, "pattern")) {
+    clear_transpose();
+    const char *fbegin = f.data<char>(0, f.size()),
+      *fend = fbegin + f.size();
+    auto next_line = [fend](const char* p) {
+      auto eol = static_cast<const char*>(std::memchr(p, '\n', fend-p));
+      return eol ? eol+1 : fend;
+    };
+    const char* p = fbegin;
+    std::string banner(p, next_line(p));
+    std::cout << "# " << banner;
+    if (banner.find("pattern") != std::string::npos) {
       std::cerr << "ERROR: This is not a matrix,"
                 << " but just a sparsity pattern" << std::endl;
-      exit(1);
+      return 1;
     }
-    else if (strstr(cline, "complex")) {
-      if (!is_complex<scalar_t>()) {
-        fclose(fp);
-        throw "ERROR: Complex matrix";
-      }
+    if (banner.find("complex") != std::string::npos &&
+        !is_complex<scalar_t>()) {
+      std::cerr << "ERROR: This is a complex matrix, it cannot be read"
+                << " into a real matrix" << std::endl;
+      return 1;
     }
     MMsym s = GENERAL;
-    if (strstr(cline, "skew-symmetric")) {
-      s = SKEWSYMMETRIC;
-      symm_sparse_ = true;
-    } else if (strstr(cline, "symmetric")) {
-      s = SYMMETRIC;
-      symm_sparse_ = true;
-    } else if (strstr(cline, "hermitian")) {
-      s = HERMITIAN;
-      symm_sparse_ = true;
+    if (banner.find("skew-symmetric") != std::string::npos) s = SKEWSYMMETRIC;
+    else if (banner.find("symmetric") != std::string::npos) s = SYMMETRIC;
+    else if (banner.find("hermitian") != std::string::npos) s = HERMITIAN;
+    symm_sparse_ = (s != GENERAL);
+    long long m = 0, n = 0, innz = 0;
+    for (p = next_line(p); p < fend; p = next_line(p)) {
+      if (*p == '%') continue;
+      // first line should be: m n nnz
+      std::istringstream iss(std::string(p, next_line(p)));
+      iss >> m >> n >> innz;
+      p = next_line(p);
+      break;
+    }
+    std::cout << "# reading " << number_format_with_commas(m) << " by "
+              << number_format_with_commas(n) << " matrix with "
+              << number_format_with_commas(innz) << " nnz's from "
+              << filename << std::endl;
+    if (m != n) {
+      std::cerr << "ERROR: matrix is not square!" << std::endl;
+      return 1;
     }
+    n_ = n;
 
-    while (fgets(cline, max_cline, fp)) {
-      if (cline[0] != '%') { // first line should be: m n nnz
-        int m, in, innz;
-        sscanf(cline, "%d %d %d", &m, &in, &innz);
-        nnz_ = static_cast<integer_t>(innz);
-        n_ = static_cast<integer_t>(in);
-        std::cout << "# reading " << number_format_with_commas(m) << " by "
-                  << number_format_with_commas(n_) << " matrix with "
-                  << number_format_with_commas(nnz_) << " nnz's from "
-                  << filename << std::endl;
-        if (s != GENERAL) nnz_ = 2 * nnz_;
-        if (m != n_) {
-          std::cerr << "ERROR: matrix is not square!" << std::endl;
-          exit(1);
+    // Split the entries in chunks, at line boundaries. The chunks are
+    // parsed in parallel, twice: first only the indices, to count the
+    // entries per row for each chunk, then the entries are parsed
+    // again and put directly in place, so the entries are never
+    // stored as triplets. Within a row, the entries of a chunk come
+    // before those of the next chunk, and are in the order of the
+    // file, as in a sequential counting sort.
+    const int nchunks = std::max(1, params::num_threads);
+    std::vector<const char*> cb(nchunks+1, fend);
+    cb[0] = p;
+    for (int i=1; i<nchunks; i++)
+      cb[i] = std::max
+        (cb[i-1], next_line(p + (fend - p) / nchunks * i - 1));
+    // call f(line, line_end) for every non comment line in chunk i,
+    // stop when f returns false
+    auto for_each_line = [&](int i, const std::function
+                             <bool(const char*, const char*)>& f) {
+      std::string last;
+      for (auto q=cb[i]; q<cb[i+1]; q=next_line(q)) {
+        if (*q == '%') continue;
+        auto eol = next_line(q);
+        auto line = q, line_end = eol;
+        if (eol == fend && fend[-1] != '\n') {
+          // last line without newline, make a null terminated copy
+          last.assign(q, eol);
+          line = last.c_str();
+          line_end = line + last.size();
         }
-        break;
+        if (!f(line, line_end)) return;
       }
-    }
-    std::vector<std::tuple<integer_t,integer_t,scalar_t>> A;
-    A.reserve(nnz_);
-    bool zero_based = false;
-    if (!is_complex<scalar_t>()) {
-      int ir, ic;
-      double dv;
-      while (fscanf(fp, "%d %d %lf\n", &ir, &ic, &dv) != EOF) {
-        scalar_t v = static_cast<scalar_t>(dv);
-        integer_t r = static_cast<integer_t>(ir);
-        integer_t c = static_cast<integer_t>(ic);
-        if (r==0 || c==0) zero_based = true;
-        A.push_back(std::make_tuple(r, c, v));
-        if (r != c) {
-          switch (s) {
-          case SKEWSYMMETRIC:
-            A.push_back(std::make_tuple(c, r, -v));
-            break;
-          case SYMMETRIC:
-            A.push_back(std::make_tuple(c, r, v));
-            break;
-          case HERMITIAN:
-            A.push_back(std::make_tuple(c, r, blas::my_conj(v)));
-            break;
-          default: break;
+    };
+    // only allow empty lines, a line with missing fields is an error
+    auto blank = [](const char* q, const char* e) {
+      return std::find_if(q, e, [](char ch) {
+          return !std::isspace(ch); }) == e;
+    };
+    // cnt[i][r] is the number of entries in row r (as in the file,
+    // so 0 based or 1 based) from chunk i, later the position of the
+    // first of those in ind_ and val_
+    std::vector<std::vector<integer_t>> cnt(nchunks);
+    bool zero_based = false, err = false;
+    long long maxidx = 0;
+#pragma omp parallel for schedule(static,1) \
+  reduction(||:zero_based,err) reduction(max:maxidx)
+    for (int i=0; i<nchunks; i++) {
+      cnt[i].assign(n+1, 0);
+      for_each_line(i, [&](const char* q, const char* e) {
+          long long r, c;
+          auto l = q;
+          if (!parse_matrix_market_indices(l, e, r, c)) {
+            if (!blank(q, e)) err = true;
+            return !err;
           }
-        }
-      }
-    } else {
-      double vr=0, vi=0;
-      int ir, ic;
-      while (fscanf(fp, "%d %d %lf %lf\n", &ir, &ic, &vr, &vi) != EOF) {
-        scalar_t v = get_scalar<scalar_t>(vr, vi);
-        integer_t r = static_cast<integer_t>(ir),
-          c = static_cast<integer_t>(ic);
-        if (r==0 || c==0) zero_based = true;
-        A.push_back(std::make_tuple(r, c, v));
-        if (r != c) {
-          switch (s) {
-          case SKEWSYMMETRIC:
-            A.push_back(std::make_tuple(c, r, -v));
-            break;
-          case SYMMETRIC:
-            A.push_back(std::make_tuple(c, r, v));
-            break;
-          case HERMITIAN:
-            A.push_back(std::make_tuple(c, r, blas::my_conj(v)));
-            break;
-          default: break;
+          if (r < 0 || c < 0 || r > n || c > n) {
+            err = true;
+            return false;
           }
-        }
+          if (r == 0 || c == 0) zero_based = true;
+          maxidx = std::max(maxidx, std::max(r, c));
+          cnt[i][r]++;
+          if (r != c && s != GENERAL) cnt[i][c]++;
+          return true;
+        });
+    }
+    if (!err && zero_based && maxidx >= n) {
+      std::cerr << "ERROR: index out of range in matrix market file"
+                << std::endl;
+      return 1;
+    }
+    if (err) {
+      std::cerr << "ERROR: could not parse matrix market entries"
+                << std::endl;
+      return 1;
+    }
+    const integer_t base = zero_based ? 0 : 1;
+    ptr_.assign(n_+1, 0);
+#pragma omp parallel for
+    for (integer_t r=0; r<n_; r++)
+      for (int i=0; i<nchunks; i++)
+        ptr_[r+1] += cnt[i][r+base];
+    for (integer_t r=0; r<n_; r++)
+      ptr_[r+1] += ptr_[r];
+    nnz_ = ptr_[n_];
+#pragma omp parallel for
+    for (integer_t r=0; r<n_; r++) {
+      auto o = ptr_[r];
+      for (int i=0; i<nchunks; i++) {
+        auto c = cnt[i][r+base];
+        cnt[i][r+base] = o;
+        o += c;
       }
     }
-    nnz_ = A.size();
-    fclose(fp);
-    if (!zero_based)
-      for (auto& t : A) {
-        std::get<0>(t)--;
-        std::get<1>(t)--;
+    ind_.resize(nnz_);
+    val_.resize(nnz_);
+#pragma omp parallel for schedule(static,1) reduction(||:err)
+    for (int i=0; i<nchunks; i++) {
+      auto& pos = cnt[i];
+      for_each_line(i, [&](const char* q, const char* e) {
+          long long r, c;
+          scalar_t v;
+          if (!parse_matrix_market_entry(q, e, r, c, v)) {
+            if (!blank(q, e)) err = true;
+            return !err;
+          }
+          auto j = pos[r]++;
+          ind_[j] = c - base;
+          val_[j] = v;
+          if (r != c && s != GENERAL) {
+            j = pos[c]++;
+            ind_[j] = r - base;
+            val_[j] = (s == SKEWSYMMETRIC ? -v :
+                       (s == HERMITIAN ? blas::my_conj(v) : v));
+          }
+          return true;
+        });
+      std::vector<integer_t>().swap(pos);
+    }
+    if (err) {
+      std::cerr << "ERROR: could not parse matrix market entries"
+                << std::endl;
+      return 1;
+    }
+    sort_indices();
+    auto time = t.elapsed();
+    std::cout << "# read " << f.size() / 1.e6 << " MB in " << time
+              << " sec (" << f.size() / 1.e6 / time << " MB/s)"
+              << std::endl;
+    return 0;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::build_transpose() const {
+    // this is called from const member functions, which can run
+    // concurrently, only one should build the transpose, the others
+    // wait for it
+    if (tlock_.built.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> lock(tlock_.mtx);
+    if (tlock_.built.load(std::memory_order_relaxed)) return;
+    // counting sort on the (column) indices, traversing the rows in
+    // order keeps the indices of the transpose sorted
+    tptr_.assign(n_+1, 0);
+    tind_.resize(nnz_);
+    tpos_.resize(nnz_);
+    for (integer_t j=0; j<nnz_; j++)
+      tptr_[ind_[j]+1]++;
+    for (integer_t i=0; i<n_; i++)
+      tptr_[i+1] += tptr_[i];
+    std::vector<integer_t> pos(tptr_.begin(), tptr_.end()-1);
+    for (integer_t r=0; r<n_; r++)
+      for (integer_t j=ptr_[r]; j<ptr_[r+1]; j++) {
+        auto k = pos[ind_[j]]++;
+        tind_[k] = r;
+        tpos_[k] = j;
       }
-    return A;
+    tlock_.built.store(true, std::memory_order_release);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::clear_transpose() {
+    tlock_.built = false;
+    tptr_.clear();
+    tind_.clear();
+    tpos_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::sort_indices() {
+    clear_transpose();
+#pragma omp parallel for schedule(dynamic,1024)
+    for (integer_t r=0; r<n_; r++) {
+      const auto lo = ptr_[r], hi = ptr_[r+1];
+      if (!std::is_sorted(ind_.begin()+lo, ind_.begin()+hi))
+        sort_indices_values
+          (ind_.data()+lo, val_.data()+lo, integer_t(0), hi-lo);
+    }
   }
 
   template<typename scalar_t,typename integer_t> void
   CompressedSparseMatrix<scalar_t,integer_t>::permute
   (const integer_t* iorder, const integer_t* order) {
+    clear_transpose();
     std::vector<integer_t> ptr(n_+1), ind(nnz_);
     std::vector<scalar_t> val(nnz_);
     integer_t nnz = 0;
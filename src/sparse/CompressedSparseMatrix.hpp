@@ -37,6 +37,8 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <atomic>
+#include <mutex>
 
 #include "misc/Tools.hpp"
 #include "misc/Triplet.hpp"
@@ -360,6 +362,13 @@ namespace strumpack {
 
     virtual void symmetrize_sparsity();
 
+    /**
+     * Sort the indices (and corresponding values) of each row (or
+     * column) in increasing order, in parallel. Rows that are already
+     * sorted are not touched.
+     */
+    void sort_indices();
+
     virtual void print() const;
     virtual void print_dense(const std::string& name) const {
       std::cerr << "print_dense not implemented for this matrix type"
@@ -401,6 +410,19 @@ namespace strumpack {
     (integer_t, integer_t, const std::vector<integer_t>&,
      std::vector<Triplet<scalar_t>>&, std::vector<Triplet<scalar_t>>&,
      std::vector<Triplet<scalar_t>>&) const = 0;
+    /**
+     * Like push_front_elements, but instead of the values, store the
+     * position in the nonzero array (val()) of each element of the
+     * front. This is used to build scatter maps for the numerical
+     * assembly of the fronts, which can then be reused as long as
+     * the sparsity pattern does not change. Returns false if this is
+     * not supported by the matrix format.
+     */
+    virtual bool push_front_positions
+    (integer_t, integer_t, const std::vector<integer_t>&,
+     std::vector<Triplet<integer_t,integer_t>>&,
+     std::vector<Triplet<integer_t,integer_t>>&,
+     std::vector<Triplet<integer_t,integer_t>>&) const { return false; }
 
     virtual void front_multiply
     (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
@@ -457,8 +479,36 @@ namespace strumpack {
     (integer_t n, const integer_t* row_ptr, const integer_t* col_ind,
      const scalar_t* values, bool symm_sparsity);
 
-    std::vector<std::tuple<integer_t,integer_t,scalar_t>>
-    read_matrix_market_entries(const std::string& filename);
+    /**
+     * Read a matrix market file directly into ptr_, ind_ and val_,
+     * with ptr_ indexed by the row. The file is memory mapped and
+     * parsed by multiple threads, after which the entries are put in
+     * place using a counting sort on the row index, and the column
+     * indices are sorted per row.
+     *
+     * \return 0 on success
+     */
+    int read_matrix_market_rows(const std::string& filename);
+
+    // Sparsity pattern of the transpose, tptr_ and tind_, with tpos_
+    // the position in val_ of each of its nonzeros. This is built on
+    // first use, and cleared by the member functions which modify the
+    // sparsity pattern. Once built, using it only requires reading
+    // the flag in tlock_, the lock is only taken while building.
+    mutable std::vector<integer_t> tptr_, tind_, tpos_;
+    struct TransposeLock {
+      std::atomic<bool> built{false};
+      std::mutex mtx;
+      TransposeLock() = default;
+      TransposeLock(const TransposeLock& o) : built(o.built.load()) {}
+      TransposeLock& operator=(const TransposeLock& o) {
+        built = o.built.load();
+        return *this;
+      }
+    };
+    mutable TransposeLock tlock_;
+    void build_transpose() const;
+    void clear_transpose();
 
     virtual int strumpack_mc64(MatchingJob, Match_t&) { return 0; }
 
@@ -28,6 +28,8 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <functional>
+#include <numeric>
 
 #include "EliminationTree.hpp"
 #include "fronts/FrontFactory.hpp"
@@ -39,11 +41,14 @@ namespace strumpack {
   EliminationTree<scalar_t,integer_t>::EliminationTree
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
    SeparatorTree<integer_t>& sep_tree) {
-    std::vector<std::vector<integer_t>> upd(sep_tree.separators());
-#pragma omp parallel default(shared)
-#pragma omp single
-    symbolic_factorization(A, sep_tree, sep_tree.root(), upd);
-    root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), true, 0);
+    std::vector<std::size_t> uptr;
+    std::vector<integer_t> uind;
+    symbolic_factorization(sep_tree, A.ptr(), A.ind(), 0, uptr, uind);
+    if (opts.amalgamation_fraction() > 0)
+      amalgamate(opts.amalgamation_fraction(), sep_tree, uptr, uind);
+    root_ = setup_tree
+      (opts, A, sep_tree, uptr, uind, sep_tree.root(), true, 0);
+    root_->order_children();
   }
 
   template<typename scalar_t,typename integer_t>
@@ -63,62 +68,162 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::symbolic_factorization
-  (const SpMat_t& A, const SeparatorTree<integer_t>& sep_tree,
-   integer_t sep, std::vector<std::vector<integer_t>>& upd, int depth) const {
-    auto chl = sep_tree.lch(sep);
-    auto chr = sep_tree.rch(sep);
+  (const SeparatorTree<integer_t>& tree, const integer_t* ptr,
+   const integer_t* ind, integer_t lo, std::vector<std::size_t>& uptr,
+   std::vector<integer_t>& uind) {
+    integer_t nsep = tree.separators();
+    uptr.assign(nsep+1, 0);
+    uind.clear();
+    if (!nsep) return;
+    integer_t n = tree.sizes(nsep);
+    std::vector<integer_t> snode(n);
+    std::vector<RowSubtreeNode> nodes(nsep);
+    for (integer_t s=0; s<nsep; s++) {
+      std::fill(snode.begin()+tree.sizes(s),
+                snode.begin()+tree.sizes(s+1), s);
+      // empty (dummy) separators pass all indices on to their parent
+      bool empty = tree.sizes(s) == tree.sizes(s+1) && tree.pa(s) != -1;
+      nodes[s] = {empty ? 0 : tree.sizes(s+1), tree.pa(s), -1};
+    }
+    // entries (j,s) with j outside of the tree, these are in the
+    // update sets of s and all its ancestors
+    std::vector<std::pair<integer_t,integer_t>> out;
+    for (integer_t i=0; i<n; i++)
+      for (integer_t j=ptr[i+1]-1; j>=ptr[i] && ind[j]>=lo+n; j--)
+        out.emplace_back(ind[j]-lo, snode[i]);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    // first pass counts, second pass writes the indices, in
+    // increasing order since rows are visited in postorder
+    std::vector<std::size_t> cnt(nsep, 0);
+    for (int pass=0; pass<2; pass++) {
+      auto u = pass ? uind.data() : nullptr;
+#pragma omp parallel default(shared)
+#pragma omp single
+      row_subtrees(tree, ptr, ind, lo, snode, nodes, cnt, u, tree.root(), 0);
+      for (auto& o : out)
+        for (auto s=o.second; s!=-1 && nodes[s].mark!=o.first;
+             s=nodes[s].pa) {
+          nodes[s].mark = o.first;
+          if (u) u[cnt[s]++] = o.first + lo;
+          else cnt[s]++;
+        }
+      if (!pass) {
+        for (integer_t s=0; s<nsep; s++) {
+          uptr[s+1] = uptr[s] + cnt[s];
+          nodes[s].mark = -1;
+        }
+        uind.resize(uptr[nsep]);
+        std::copy(uptr.begin(), uptr.end()-1, cnt.begin());
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::row_subtrees
+  (const SeparatorTree<integer_t>& tree, const integer_t* ptr,
+   const integer_t* ind, integer_t lo, const std::vector<integer_t>& snode,
+   std::vector<RowSubtreeNode>& nodes, std::vector<std::size_t>& cnt,
+   integer_t* uind, integer_t sep, int depth) {
+    auto chl = tree.lch(sep);
+    auto chr = tree.rch(sep);
     if (depth < params::task_recursion_cutoff_level) {
       if (chl != -1)
 #pragma omp task untied default(shared)                                 \
   final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization(A, sep_tree, chl, upd, depth+1);
+        row_subtrees(tree, ptr, ind, lo, snode, nodes, cnt, uind,
+                     chl, depth+1);
       if (chr != -1)
 #pragma omp task untied default(shared)                                 \
   final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization(A, sep_tree, chr, upd, depth+1);
+        row_subtrees(tree, ptr, ind, lo, snode, nodes, cnt, uind,
+                     chr, depth+1);
 #pragma omp taskwait
     } else {
-      if (chl != -1) symbolic_factorization(A, sep_tree, chl, upd, depth);
-      if (chr != -1) symbolic_factorization(A, sep_tree, chr, upd, depth);
+      if (chl != -1)
+        row_subtrees(tree, ptr, ind, lo, snode, nodes, cnt, uind, chl, depth);
+      if (chr != -1)
+        row_subtrees(tree, ptr, ind, lo, snode, nodes, cnt, uind, chr, depth);
     }
-    auto sep_begin = sep_tree.sizes(sep);
-    auto sep_end = sep_tree.sizes(sep+1);
-    if (sep != sep_tree.root()) { // not necessary for the root
-      for (integer_t c=sep_begin; c<sep_end; c++) {
-        auto ice = A.ind()+A.ptr(c+1);
-        auto icb = std::lower_bound
-          (A.ind()+A.ptr(c), ice, sep_end);
-        auto mid = upd[sep].size();
-        std::copy(icb, ice, std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
+    // The row subtree of i lies in the subtree of sep, since the
+    // separators separate, so it is not touched by any other task.
+    for (integer_t i=tree.sizes(sep); i<tree.sizes(sep+1); i++)
+      for (integer_t j=ptr[i]; j<ptr[i+1]; j++) {
+        auto c = ind[j] - lo;
+        if (c >= i) break;
+        if (c < 0) continue;
+        for (auto s=snode[c]; s!=-1 && nodes[s].mark!=i &&
+               nodes[s].end <= i; s=nodes[s].pa) {
+          nodes[s].mark = i;
+          if (uind) uind[cnt[s]++] = i + lo;
+          else cnt[s]++;
+        }
       }
-      auto dim_sep = sep_end - sep_begin;
-      if (chl != -1) {
-        auto icb = dim_sep ?
-          std::lower_bound(upd[chl].begin(), upd[chl].end(), sep_end) :
-          upd[chl].begin();
-        auto mid = upd[sep].size();
-        std::copy(icb, upd[chl].end(), std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
-      }
-      if (chr != -1) {
-        auto icb = dim_sep ?
-          std::lower_bound(upd[chr].begin(), upd[chr].end(), sep_end) :
-          upd[chr].begin();
-        auto mid = upd[sep].size();
-        std::copy(icb, upd[chr].end(), std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::amalgamate
+  (double fraction, SeparatorTree<integer_t>& sep_tree,
+   std::vector<std::size_t>& uptr, std::vector<integer_t>& uind) {
+    integer_t nsep = sep_tree.separators();
+    auto dense_nnz = [](long long dsep, long long dupd) {
+      return dsep * (dsep + 2 * dupd);
+    };
+    // dim of the (merged) separator, the nonzeros of the original
+    // fronts merged into it, and whether it is now a leaf
+    std::vector<integer_t> dim(nsep);
+    std::vector<long long> nnz(nsep);
+    std::vector<bool> leaf(nsep, false), merged(nsep, false);
+    for (integer_t s=0; s<nsep; s++) {
+      long long dupd = uptr[s+1] - uptr[s];
+      dim[s] = sep_tree.sizes(s+1) - sep_tree.sizes(s);
+      nnz[s] = dense_nnz(dim[s], dupd);
+      amalg_.nnz_before += nnz[s];
+      auto chl = sep_tree.lch(s), chr = sep_tree.rch(s);
+      if (chl == -1 && chr == -1) { leaf[s] = true; continue; }
+      if (sep_tree.is_root(s) || (chl != -1 && !leaf[chl]) ||
+          (chr != -1 && !leaf[chr])) continue;
+      auto d = dim[s];
+      auto n = nnz[s];
+      for (auto ch : {chl, chr})
+        if (ch != -1) { d += dim[ch]; n += nnz[ch]; }
+      // the merged update set is the update set of s
+      auto m = dense_nnz(d, dupd);
+      if (m - n <= fraction * m) {
+        leaf[s] = merged[s] = true;
+        dim[s] = d;
+        nnz[s] = n;
       }
     }
+    // the descendants of a merged front are removed, they directly
+    // precede it in postorder, so the index ranges stay contiguous
+    std::vector<integer_t> id(nsep, -1);
+    integer_t nnew = 0;
+    for (integer_t s=0; s<nsep; s++)
+      if (sep_tree.is_root(s) || !merged[sep_tree.pa(s)]) id[s] = nnew++;
+    amalg_.fronts_before = nsep;
+    amalg_.fronts_after = nnew;
+    std::vector<Separator<integer_t>> seps;
+    std::vector<std::size_t> nuptr(1, 0);
+    std::vector<integer_t> nuind;
+    seps.reserve(nnew);
+    nuptr.reserve(nnew+1);
+    for (integer_t s=0; s<nsep; s++) {
+      if (id[s] == -1) continue;
+      auto map = [&](integer_t t) { return t == -1 ? t : id[t]; };
+      seps.emplace_back
+        (sep_tree.sizes(s+1), map(sep_tree.pa(s)),
+         merged[s] ? -1 : map(sep_tree.lch(s)),
+         merged[s] ? -1 : map(sep_tree.rch(s)));
+      nuind.insert(nuind.end(), uind.begin()+uptr[s],
+                   uind.begin()+uptr[s+1]);
+      nuptr.push_back(nuind.size());
+      amalg_.nnz_after += dense_nnz(dim[s], uptr[s+1] - uptr[s]);
+    }
+    if (nnew == nsep) return;
+    sep_tree = SeparatorTree<integer_t>(seps);
+    uptr.swap(nuptr);
+    uind.swap(nuind);
   }
 
   template<typename scalar_t,typename integer_t>
@@ -126,7 +231,8 @@ namespace strumpack {
   EliminationTree<scalar_t,integer_t>::setup_tree
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
    SeparatorTree<integer_t>& sep_tree,
-   std::vector<std::vector<integer_t>>& upd, integer_t sep,
+   const std::vector<std::size_t>& uptr,
+   const std::vector<integer_t>& uind, integer_t sep,
    bool hss_parent, int level) {
     auto sep_begin = sep_tree.sizes(sep);
     auto sep_end = sep_tree.sizes(sep+1);
@@ -136,18 +242,18 @@ namespace strumpack {
     // So fix this here!
     if (dim_sep == 0 && sep_tree.lch(sep) != -1)
       sep_begin = sep_end = sep_tree.sizes(sep_tree.rch(sep)+1);
+    std::vector<integer_t> upd
+      (uind.begin()+uptr[sep], uind.begin()+uptr[sep+1]);
+    bool compressed = is_compressed(dim_sep, upd.size(), hss_parent, opts);
     auto front = create_frontal_matrix<scalar_t,integer_t>
-      (opts, sep, sep_begin, sep_end, upd[sep],
-       hss_parent, level, nr_fronts_);
-    bool compressed =
-      is_compressed(dim_sep, upd[sep].size(), hss_parent, opts);
+      (opts, sep, sep_begin, sep_end, upd, hss_parent, level, nr_fronts_);
     if (sep_tree.lch(sep) != -1)
       front->set_lchild
-        (setup_tree(opts, A, sep_tree, upd, sep_tree.lch(sep),
+        (setup_tree(opts, A, sep_tree, uptr, uind, sep_tree.lch(sep),
                     compressed, level+1));
     if (sep_tree.rch(sep) != -1)
       front->set_rchild
-        (setup_tree(opts, A, sep_tree, upd, sep_tree.rch(sep),
+        (setup_tree(opts, A, sep_tree, uptr, uind, sep_tree.rch(sep),
                     compressed, level+1));
     return front;
   }
@@ -155,7 +261,64 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
-    root_->multifrontal_factorization(A, opts);
+    if (!Schur_root_) {
+      root_->multifrontal_factorization(A, opts);
+      return;
+    }
+    // eliminate the children of the root, and assemble the root
+    // separator block of A and the contribution blocks of the
+    // children, without factoring it
+    const std::size_t sb = root_->sep_begin(), dS = root_->dim_sep();
+    for (auto ch : {root_->lchild(), root_->rchild()})
+      if (ch) ch->multifrontal_factorization(A, opts, 1, 0);
+    Schur_ = DenseM_t(dS, dS);
+    Schur_.zero();
+    for (std::size_t r=sb; r<sb+dS; r++)
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+        std::size_t c = A.ind(j);
+        if (c >= sb) Schur_(r-sb, c-sb) += A.val(j);
+      }
+    std::vector<std::size_t> I(dS);
+    std::iota(I.begin(), I.end(), sb);
+    for (auto ch : {root_->lchild(), root_->rchild()})
+      if (ch) {
+#pragma omp parallel
+#pragma omp single nowait
+        ch->extract_CB_sub_matrix(I, I, Schur_, 0);
+        ch->release_work_memory();
+      }
+    // the symmetric factorizations only update the lower triangular
+    // part of the contribution blocks
+    if (opts.factorization_type() != FactorizationType::LU) {
+      bool herm = opts.factorization_type() == FactorizationType::CHOLESKY;
+      for (std::size_t j=0; j<dS; j++)
+        for (std::size_t i=0; i<j; i++)
+          Schur_(i, j) = herm ? blas::my_conj(Schur_(j, i)) : Schur_(j, i);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::forward_Schur_solve
+  (DenseM_t& x) const {
+    std::vector<DenseM_t> CB(root_->levels());
+    for (auto& cb : CB)
+      cb = DenseM_t(root_->max_dim_upd(), x.cols());
+    DenseMW_t bupd(0, x.cols(), CB[0], 0, 0);
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+    root_->fwd_solve_phase1(x, bupd, CB.data(), 0, 0);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::backward_Schur_solve
+  (DenseM_t& x) const {
+    std::vector<DenseM_t> CB(root_->levels());
+    for (auto& cb : CB)
+      cb = DenseM_t(root_->max_dim_upd(), x.cols());
+    DenseMW_t yupd(0, x.cols(), CB[0], 0, 0);
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+    root_->bwd_solve_phase2(x, yupd, CB.data(), 0, 0);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -175,8 +338,53 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::multifrontal_solve
-  (DenseM_t& x) const {
-    root_->multifrontal_solve(x, gpu_factors_.get());
+  (DenseM_t& x, Trans op) const {
+    root_->multifrontal_solve(x, gpu_factors_.get(), op);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::set_solve_pattern
+  (const std::vector<integer_t>& b_nz,
+   const std::vector<integer_t>& x_idx) const {
+    clear_solve_pattern();
+    if (fronts_.empty()) {
+      std::function<integer_t(const F_t*)> postorder =
+        [&](const F_t* F) {
+          integer_t l = -1, r = -1;
+          if (F->lchild()) l = postorder(F->lchild());
+          if (F->rchild()) r = postorder(F->rchild());
+          integer_t f = fronts_.size();
+          fronts_.push_back(F);
+          front_parent_.push_back(-1);
+          if (l != -1) front_parent_[l] = f;
+          if (r != -1) front_parent_[r] = f;
+          return f;
+        };
+      postorder(root_.get());
+    }
+    auto mark = [&](const std::vector<integer_t>& idx, int m) {
+      for (auto i : idx) {
+        // in postorder, the first front with sep_end > i contains i
+        integer_t f = std::upper_bound
+          (fronts_.begin(), fronts_.end(), i,
+           [](integer_t i, const F_t* F) { return i < F->sep_end(); })
+          - fronts_.begin();
+        assert(f < integer_t(fronts_.size()) && fronts_[f]->sep_begin() <= i);
+        // mark the path to the root, until a marked front is found
+        for (; f != -1 && !fronts_[f]->marked_solve(m); f = front_parent_[f]) {
+          fronts_[f]->mark_solve(m);
+          solve_marked_.push_back(fronts_[f]);
+        }
+      }
+    };
+    mark(b_nz, F_t::SOLVE_FWD);
+    mark(x_idx, F_t::SOLVE_BWD);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::clear_solve_pattern() const {
+    for (auto F : solve_marked_) F->unmark_solve();
+    solve_marked_.clear();
   }
 
   template<typename scalar_t,typename integer_t> integer_t
@@ -206,6 +414,11 @@ namespace strumpack {
     return nonzeros;
   }
 
+  template<typename scalar_t,typename integer_t> long long
+  EliminationTree<scalar_t,integer_t>::CB_stack_peak() const {
+    return root_ ? root_->CB_stack_peak() : 0;
+  }
+
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::draw
   (const SpMat_t& A, const std::string& name) const {
@@ -220,6 +433,87 @@ namespace strumpack {
     of.close();
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::write_factors
+  (std::ofstream& os) const {
+    return root_ && write_front(os, root_.get());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::write_front
+  (std::ofstream& os, const F_t* F) {
+    std::int64_t s[3] = {F->sep(), F->sep_begin(), F->sep_end()};
+    char ch = (F->lchild() ? 1 : 0) | (F->rchild() ? 2 : 0);
+    io::write_binary(os, F->type());
+    io::write_binary(os, s);
+    io::write_binary(os, F->upd());
+    io::write_binary(os, ch);
+    if (!F->write_factors(os)) {
+      std::cerr << "# ERROR: writing the factors of "
+                << F->type() << " is not supported" << std::endl;
+      return false;
+    }
+    return (!F->lchild() || write_front(os, F->lchild())) &&
+      (!F->rchild() || write_front(os, F->rchild()));
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::read_factors
+  (std::ifstream& is, std::unique_ptr<io::MappedFile> f, integer_t n) {
+    root_.reset();
+    gpu_factors_.reset();
+    nr_fronts_ = FrontCounter();
+    factor_file_ = std::move(f);
+    root_ = read_front(is, n);
+    return root_ != nullptr;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  std::unique_ptr<FrontalMatrix<scalar_t,integer_t>>
+  EliminationTree<scalar_t,integer_t>::read_front
+  (std::ifstream& is, integer_t n) {
+    std::string type;
+    std::int64_t s[3];
+    std::vector<integer_t> upd;
+    char ch = 0;
+    io::read_binary(is, type);
+    io::read_binary(is, s);
+    io::read_binary(is, upd);
+    io::read_binary(is, ch);
+    if (!is) return nullptr;
+    // the separator [s[1], s[2]) and the (sorted) update indices
+    // should be in the range of the matrix
+    bool valid = s[0] >= 0 && s[1] >= 0 && s[1] <= s[2] && s[2] <= n;
+    for (std::size_t i=0; i<upd.size() && valid; i++)
+      valid = upd[i] >= s[2] && upd[i] < n && (!i || upd[i] > upd[i-1]);
+    if (!valid) {
+      std::cerr << "# ERROR: invalid front in the factor file"
+                << std::endl;
+      return nullptr;
+    }
+    auto F = create_frontal_matrix<scalar_t,integer_t>
+      (type, integer_t(s[0]), integer_t(s[1]), integer_t(s[2]),
+       upd, nr_fronts_);
+    if (!F) {
+      std::cerr << "# ERROR: front type " << type
+                << " not supported" << std::endl;
+      return nullptr;
+    }
+    F->read_factors(is, factor_file_.get());
+    if (ch & 1) {
+      auto c = read_front(is, n);
+      if (!c) return nullptr;
+      F->set_lchild(std::move(c));
+    }
+    if (ch & 2) {
+      auto c = read_front(is, n);
+      if (!c) return nullptr;
+      F->set_rchild(std::move(c));
+    }
+    if (!is) return nullptr;
+    return F;
+  }
+
   // explicit template specializations
   template class EliminationTree<float,int>;
   template class EliminationTree<double,int>;
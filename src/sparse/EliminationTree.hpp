@@ -48,6 +48,7 @@ namespace strumpack {
   class EliminationTree {
     using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
     using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
     using F_t = FrontalMatrix<scalar_t,integer_t>;
 
   public:
@@ -65,36 +66,170 @@ namespace strumpack {
     virtual void remove_from_gpu();
     virtual void delete_factors();
 
-    virtual void multifrontal_solve(DenseM_t& x) const;
+    /**
+     * Solve with the factors, op = Trans::T or Trans::C solves with
+     * the (conjugate) transpose of the factored (permuted, scaled)
+     * matrix.
+     */
+    virtual void multifrontal_solve(DenseM_t& x, Trans op=Trans::N) const;
+
+    /**
+     * Restrict the following calls to multifrontal_solve to the
+     * fronts required for a right-hand side which is zero except for
+     * the (permuted) rows in b_nz, and/or to compute only the
+     * (permuted) entries x_idx of the solution. An empty b_nz means
+     * the right-hand side is dense, an empty x_idx means the whole
+     * solution is required. The forward solve only visits the
+     * ancestors of the fronts containing b_nz, the backward solve
+     * only the ancestors of the fronts containing x_idx. Entries of
+     * the solution outside x_idx are then not computed. Call
+     * clear_solve_pattern to go back to the full solve.
+     */
+    void set_solve_pattern(const std::vector<integer_t>& b_nz,
+                           const std::vector<integer_t>& x_idx) const;
+    void clear_solve_pattern() const;
+
+    /**
+     * With Schur set, multifrontal_factorization only eliminates
+     * the descendants of the root front, and assembles the Schur
+     * complement on the root separator as a dense matrix, which is
+     * returned by Schur_complement. The root separator should have
+     * been set with MatrixReordering::Schur_reordering. The
+     * forward/backward solves then stop/start at the root
+     * separator, see forward_Schur_solve and backward_Schur_solve.
+     */
+    void set_Schur_root(bool Schur) { Schur_root_ = Schur; }
+    const DenseM_t& Schur_complement() const { return Schur_; }
+
+    /**
+     * Forward solve with all fronts except the root, on return the
+     * rows of x corresponding to the root separator contain the
+     * condensed right-hand side, the other rows are the input for
+     * backward_Schur_solve.
+     */
+    void forward_Schur_solve(DenseM_t& x) const;
+
+    /**
+     * Backward solve with all fronts except the root, the rows of x
+     * corresponding to the root separator should contain the
+     * solution of the Schur complement system.
+     */
+    void backward_Schur_solve(DenseM_t& x) const;
     virtual void multifrontal_solve_dist
     (DenseM_t& x, const std::vector<integer_t>& dist) {} // TODO const
 
     virtual integer_t maximum_rank() const;
     virtual long long factor_nonzeros() const;
     virtual long long dense_factor_nonzeros() const;
+    long long CB_stack_peak() const;
     void print_rank_statistics(std::ostream &out) const;
     virtual FrontCounter front_counter() const { return nr_fronts_; }
+
+    /**
+     * Number of fronts and of nonzeros in the dense factors, before
+     * and after the relaxed amalgamation of small fronts. All zero
+     * when no amalgamation was done.
+     * \see SPOptions::set_amalgamation_fraction()
+     */
+    struct Amalgamation {
+      std::size_t fronts_before = 0, fronts_after = 0;
+      long long nnz_before = 0, nnz_after = 0;
+    };
+    const Amalgamation& amalgamation() const { return amalg_; }
     void draw(const SpMat_t& A, const std::string& name) const;
     F_t* root() const;
 
+    /**
+     * Write the structure of the tree and the factors of all fronts
+     * to a binary stream. Returns false if any of the fronts does not
+     * support this.
+     */
+    bool write_factors(std::ofstream& os) const;
+
+    /**
+     * Construct the tree and its factors from a stream written by
+     * write_factors. Dense factors are used in place from the
+     * (memory mapped) file f, which is kept alive by the tree. The
+     * fronts are checked against the matrix size n. Returns false on
+     * failure.
+     */
+    bool read_factors(std::ifstream& is, std::unique_ptr<io::MappedFile> f,
+                      integer_t n);
+
   protected:
     FrontCounter nr_fronts_;
+    // declared before root_, the fronts can point into this mapping
+    std::unique_ptr<io::MappedFile> factor_file_;
     std::unique_ptr<F_t> root_;
     std::unique_ptr<GPUFactors<scalar_t>> gpu_factors_;
 
+    // all fronts in postorder, with the index of their parent, used
+    // for set_solve_pattern, and the fronts marked for the solve
+    mutable std::vector<const F_t*> fronts_;
+    mutable std::vector<integer_t> front_parent_;
+    mutable std::vector<const F_t*> solve_marked_;
+
+    bool Schur_root_ = false;
+    DenseM_t Schur_;
+
+    Amalgamation amalg_;
+
+    /**
+     * Symbolic factorization on the separator tree. The graph
+     * (ptr,ind) has rows 0..n-1, with n = tree.sizes(tree.separators()),
+     * corresponding to the (global) indices lo..lo+n-1, and has a
+     * symmetric pattern in that range. Column indices are global and
+     * sorted per row, those >= lo+n belong to ancestors of the tree
+     * root.
+     *
+     * The update indices of separator s are returned, sorted, in
+     * uind[uptr[s]:uptr[s+1]]. They are computed with row subtrees:
+     * entry (i,c), c < i, adds i to all separators on the path from
+     * the separator holding c up to the one holding i. Marking the
+     * separators visited for row i stops the walk early, so the cost
+     * is linear in the size of the output, instead of the repeated
+     * merges of the update sets of the children.
+     */
+    static void
+    symbolic_factorization(const SeparatorTree<integer_t>& tree,
+                           const integer_t* ptr, const integer_t* ind,
+                           integer_t lo, std::vector<std::size_t>& uptr,
+                           std::vector<integer_t>& uind);
+
   private:
+    /**
+     * Merge fronts with their children, when all children are leaves
+     * (possibly after earlier merges) and the explicit zeros added to
+     * the factors are at most a fraction of the merged front. The
+     * root is never merged. Replaces sep_tree and the update sets
+     * (uptr,uind) from symbolic_factorization.
+     */
+    void amalgamate(double fraction, SeparatorTree<integer_t>& sep_tree,
+                    std::vector<std::size_t>& uptr,
+                    std::vector<integer_t>& uind);
+
     std::unique_ptr<F_t>
     setup_tree(const SPOptions<scalar_t>& opts, const SpMat_t& A,
                SeparatorTree<integer_t>& sep_tree,
-               std::vector<std::vector<integer_t>>& upd, integer_t sep,
+               const std::vector<std::size_t>& uptr,
+               const std::vector<integer_t>& uind, integer_t sep,
                bool hss_parent, int level);
 
-    void
-    symbolic_factorization(const SpMat_t& A,
-                           const SeparatorTree<integer_t>& sep_tree,
-                           integer_t sep,
-                           std::vector<std::vector<integer_t>>& upd,
-                           int depth=0) const;
+    static bool write_front(std::ofstream& os, const F_t* F);
+    std::unique_ptr<F_t> read_front(std::ifstream& is, integer_t n);
+
+    // the separator data used in the row subtree walks, kept
+    // together since each step of a walk needs all of them
+    struct RowSubtreeNode {
+      integer_t end, pa, mark;
+    };
+    static void
+    row_subtrees(const SeparatorTree<integer_t>& tree,
+                 const integer_t* ptr, const integer_t* ind,
+                 integer_t lo, const std::vector<integer_t>& snode,
+                 std::vector<RowSubtreeNode>& nodes,
+                 std::vector<std::size_t>& cnt, integer_t* uind,
+                 integer_t sep, int depth);
   };
 
 } // end namespace strumpack
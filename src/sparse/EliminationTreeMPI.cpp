@@ -55,14 +55,22 @@ namespace strumpack {
     : EliminationTree<scalar_t,integer_t>(),
     comm_(comm), rank_(comm.rank()), P_(comm.size()), active_pfronts_(0) {
     auto& tree = nd.tree();
-    std::vector<std::vector<integer_t>> upd(tree.separators());
+    std::vector<std::size_t> uptr;
+    std::vector<integer_t> uind;
+    this->symbolic_factorization(tree, A.ptr(), A.ind(), 0, uptr, uind);
+    // assume amount of work per front is N^3, work per subtree is
+    // work on front plus children, children come before the parent
     std::vector<float> subtree_work(tree.separators());
-#pragma omp parallel default(shared)
-#pragma omp single
-    symbolic_factorization(A, tree, tree.root(), upd, subtree_work);
+    for (integer_t sep=0; sep<tree.separators(); sep++) {
+      float dim_blk = (tree.sizes(sep+1) - tree.sizes(sep)) +
+        (uptr[sep+1] - uptr[sep]);
+      subtree_work[sep] = dim_blk*dim_blk*dim_blk;
+      for (auto ch : {tree.lch(sep), tree.rch(sep)})
+        if (ch != -1) subtree_work[sep] += subtree_work[ch];
+    }
     local_range_ = {A.size(), 0};
     this->root_ = proportional_mapping
-      (tree, opts, upd, subtree_work, tree.root(),
+      (tree, opts, uptr, uind, subtree_work, tree.root(),
        0, comm_.size(), comm_, true, true, 0);
     subtree_ranges_.resize(P_);
     MPI_Allgather
@@ -138,101 +146,43 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPI<scalar_t,integer_t>::multifrontal_solve
-  (DenseM_t& x) const {
+  (DenseM_t& x, Trans op) const {
+    // transposed solves are rejected by the distributed solvers
+    assert(op == Trans::N);
     auto x_dist = sequential_to_block_cyclic(x);
     this->root_->multifrontal_solve(x, x_dist.get());
     block_cyclic_to_sequential(x, x_dist.get());
   }
 
-  template<typename scalar_t,typename integer_t> void
-  EliminationTreeMPI<scalar_t,integer_t>::symbolic_factorization
-  (const SpMat_t& A, const Tree_t& tree, const integer_t sep,
-   std::vector<std::vector<integer_t>>& upd,
-   std::vector<float>& subtree_work, int depth) const {
-    auto chl = tree.lch(sep);
-    auto chr = tree.rch(sep);
-    if (depth < params::task_recursion_cutoff_level) {
-      if (chl != -1)
-#pragma omp task untied default(shared)                                 \
-  final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization(A, tree, chl, upd, subtree_work, depth+1);
-      if (chr != -1)
-#pragma omp task untied default(shared)                                 \
-  final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization(A, tree, chr, upd, subtree_work, depth+1);
-#pragma omp taskwait
-    } else {
-      if (chl != -1)
-        symbolic_factorization(A, tree, chl, upd, subtree_work, depth);
-      if (chr != -1)
-        symbolic_factorization(A, tree, chr, upd, subtree_work, depth);
-    }
-    auto sep_begin = tree.sizes(sep);
-    auto sep_end = tree.sizes(sep+1);
-    if (sep != tree.separators()-1) { // not necessary for the root
-      for (integer_t c=sep_begin; c<sep_end; c++) {
-        auto ice = A.ind()+A.ptr(c+1);
-        auto icb = std::lower_bound
-          (A.ind()+A.ptr(c), ice, sep_end);
-        auto mid = upd[sep].size();
-        std::copy(icb, ice, std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
-      }
-      if (chl != -1) {
-        auto icb = std::lower_bound
-          (upd[chl].begin(), upd[chl].end(), sep_end);
-        auto mid = upd[sep].size();
-        std::copy(icb, upd[chl].end(), std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
-      }
-      if (chr != -1) {
-        auto icb = std::lower_bound
-          (upd[chr].begin(), upd[chr].end(), sep_end);
-        auto mid = upd[sep].size();
-        std::copy(icb, upd[chr].end(), std::back_inserter(upd[sep]));
-        std::inplace_merge
-          (upd[sep].begin(), upd[sep].begin() + mid, upd[sep].end());
-        upd[sep].erase
-          (std::unique(upd[sep].begin(), upd[sep].end()), upd[sep].end());
-      }
-    }
-    integer_t dim_blk = (sep_end - sep_begin) + upd[sep].size();
-    // assume amount of work per front is N^3, work per subtree is
-    // work on front plus children
-    float wl = (chl != -1) ? subtree_work[chl] : 0.;
-    float wr = (chr != -1) ? subtree_work[chr] : 0.;
-    subtree_work[sep] = (float(dim_blk)*dim_blk*dim_blk) + wl + wr;
-  }
-
   // keep track of [P0_pa, P0_pa+P_pa) -> can be used to stop iso keep_subtree
   template<typename scalar_t,typename integer_t>
   std::unique_ptr<FrontalMatrix<scalar_t,integer_t>>
   EliminationTreeMPI<scalar_t,integer_t>::proportional_mapping
   (Tree_t& tree, const SPOptions<scalar_t>& opts,
-   std::vector<std::vector<integer_t>>& upd, std::vector<float>& subtree_work,
+   const std::vector<std::size_t>& uptr, const std::vector<integer_t>& uind,
+   std::vector<float>& subtree_work,
    integer_t sep, int P0, int P, const MPIComm& fcomm,
    bool keep, bool hss_parent, int level) {
     auto sep_begin = tree.sizes(sep);
     auto sep_end = tree.sizes(sep+1);
     auto dim_sep = sep_end - sep_begin;
+    auto dim_upd = uptr[sep+1] - uptr[sep];
     std::unique_ptr<F_t> front;
     if (P == 1) {
       if (keep) {
+        std::vector<integer_t> upd
+          (uind.begin()+uptr[sep], uind.begin()+uptr[sep+1]);
         front = create_frontal_matrix<scalar_t,integer_t>
-          (opts, sep, sep_begin, sep_end, upd[sep], hss_parent,
+          (opts, sep, sep_begin, sep_end, upd, hss_parent,
            level, this->nr_fronts_, rank_ == P0);
       }
       if (P0 == rank_) update_local_ranges(sep_begin, sep_end);
     } else {
       if (keep) {
+        std::vector<integer_t> upd
+          (uind.begin()+uptr[sep], uind.begin()+uptr[sep+1]);
         front = create_frontal_matrix<scalar_t,integer_t>
-          (opts, active_pfronts_, sep_begin, sep_end, upd[sep],
+          (opts, active_pfronts_, sep_begin, sep_end, upd,
            hss_parent, level, this->nr_fronts_, fcomm, P, rank_ == P0);
         if (rank_ >= P0 && rank_ < P0+P) active_pfronts_++;
       }
@@ -250,26 +200,26 @@ namespace strumpack {
     auto chl = tree.lch(sep);
     auto chr = tree.rch(sep);
     bool use_compression = is_compressed
-      (dim_sep, upd[sep].size(), hss_parent, opts);
+      (dim_sep, dim_upd, hss_parent, opts);
     if (chl != -1) {
       float wl = subtree_work[chl];
       float wr = (chr != -1) ? subtree_work[chr] : 0.;
       int Pl = std::max(1, std::min(int(std::round(P * wl / (wl + wr))), P-1));
       int Pr = std::max(1, P - Pl);
       auto fl = proportional_mapping
-        (tree, opts, upd, subtree_work, chl, P0, Pl,
+        (tree, opts, uptr, uind, subtree_work, chl, P0, Pl,
          fcomm.sub(0, Pl), keep, use_compression, level+1);
       if (front) front->set_lchild(std::move(fl));
       if (chr != -1) {
         auto fr = proportional_mapping
-          (tree, opts, upd, subtree_work, chr, P0+P-Pr, Pr,
+          (tree, opts, uptr, uind, subtree_work, chr, P0+P-Pr, Pr,
            fcomm.sub(P-Pr, Pr), keep, use_compression, level+1);
         if (front) front->set_rchild(std::move(fr));
       }
     } else {
       if (chr != -1) {
         auto fr = proportional_mapping
-          (tree, opts, upd, subtree_work, chr, P0, P,
+          (tree, opts, uptr, uind, subtree_work, chr, P0, P,
            fcomm, keep, use_compression, level+1);
         if (front) front->set_rchild(std::move(fr));
       }
@@ -60,7 +60,7 @@ namespace strumpack {
 
     virtual ~EliminationTreeMPI();
 
-    void multifrontal_solve(DenseM_t& x) const override;
+    void multifrontal_solve(DenseM_t& x, Trans op=Trans::N) const override;
     integer_t maximum_rank() const override;
     long long factor_nonzeros() const override;
     long long dense_factor_nonzeros() const override;
@@ -91,14 +91,10 @@ namespace strumpack {
     std::vector<ParFront> parallel_fronts_;
     integer_t active_pfronts_;
 
-    void symbolic_factorization
-    (const SpMat_t& A, const Tree_t& tree, integer_t sep,
-     std::vector<std::vector<integer_t>>& upd,
-     std::vector<float>& subtree_work, int depth=0) const;
-
     std::unique_ptr<F_t> proportional_mapping
     (Tree_t& tree, const SPOptions<scalar_t>& opts,
-     std::vector<std::vector<integer_t>>& upd,
+     const std::vector<std::size_t>& uptr,
+     const std::vector<integer_t>& uind,
      std::vector<float>& subtree_work,
      integer_t sep, int P0, int P, const MPIComm& fcomm,
      bool keep, bool is_hss, int level=0);
@@ -41,7 +41,8 @@ namespace strumpack {
   (const Opts_t& opts, const CSRMPI_t& A, Reord_t& nd, const MPIComm& comm)
     : EliminationTreeMPI<scalar_t,integer_t>(comm), nd_(nd) {
 
-    std::vector<std::vector<integer_t>> lupd(nd_.local_tree().separators());
+    std::vector<std::size_t> luptr(1, 0);
+    std::vector<integer_t> luind;
     // every process is responsible for 1 distributed separator, so
     // store only 1 dist_upd
     std::vector<integer_t> dist_upd, dleaf_upd;
@@ -51,7 +52,7 @@ namespace strumpack {
     float dsep_work, dleaf_work;
     MPIComm::control_start("symbolic_factorization");
     symbolic_factorization
-      (lupd, ltree_work, dist_upd, dsep_work, dleaf_upd, dleaf_work);
+      (luptr, luind, ltree_work, dist_upd, dsep_work, dleaf_upd, dleaf_work);
     MPIComm::control_stop("symbolic_factorization");
 
     {
@@ -73,8 +74,9 @@ namespace strumpack {
     local_range_ = {A.size(), 0};
     MPIComm::control_start("proportional_mapping");
     this->root_ = proportional_mapping
-      (opts, lupd, ltree_work, dist_upd, dleaf_upd, dtree_work,
+      (opts, luptr, luind, ltree_work, dist_upd, dleaf_upd, dtree_work,
        nd_.tree().root(), 0, P_, 0, 0, comm_, true, 0);
+    if (this->root_) this->root_->order_children();
     MPIComm::control_stop("proportional_mapping");
 
     MPIComm::control_start("block_row_A_to_prop_A");
@@ -104,6 +106,18 @@ namespace strumpack {
       (A, nd_, *this, opts.compression() != CompressionType::NONE);
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTreeMPIDist<scalar_t,integer_t>::update_values
+  (const Opts_t& opts, const CSRMPI_t& A) {
+    // with compression, the separator reordering is redone for the
+    // new values
+    if (opts.compression() != CompressionType::NONE) return false;
+    MPIComm::control_start("block_row_A_to_prop_A");
+    auto ok = Aprop_.update_values(A, comm_);
+    MPIComm::control_stop("block_row_A_to_prop_A");
+    return ok;
+  }
+
   /**
    * Figure out on which processor element i,j of the sparse matrix
    * (after symmetric nested dissection permutation) is mapped.  Since
@@ -349,76 +363,13 @@ namespace strumpack {
       x(sbuf[i].r-lo,sbuf[i].c) = sbuf[i].v;
   }
 
-  template<typename scalar_t,typename integer_t> void
-  EliminationTreeMPIDist<scalar_t,integer_t>::symbolic_factorization_local
-  (integer_t sep, std::vector<std::vector<integer_t>>& upd,
-   std::vector<float>& subtree_work, int depth) {
-    auto chl = nd_.local_tree().lch(sep);
-    auto chr = nd_.local_tree().rch(sep);
-    if (depth < params::task_recursion_cutoff_level) {
-      if (chl != -1)
-#pragma omp task untied default(shared)                                 \
-  final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization_local(chl, upd, subtree_work, depth+1);
-      if (chr != -1)
-#pragma omp task untied default(shared)                                 \
-  final(depth >= params::task_recursion_cutoff_level-1) mergeable
-        symbolic_factorization_local(chr, upd, subtree_work, depth+1);
-#pragma omp taskwait
-    } else {
-      if (chl != -1)
-        symbolic_factorization_local(chl, upd, subtree_work, depth);
-      if (chr != -1)
-        symbolic_factorization_local(chr, upd, subtree_work, depth);
-    }
-    auto sep_begin = nd_.local_tree().sizes(sep) +
-      nd_.sub_graph_range.first;
-    auto sep_end = nd_.local_tree().sizes(sep+1) +
-      nd_.sub_graph_range.first;
-    {
-      auto lor = nd_.local_tree().sizes(sep);
-      auto hir = nd_.local_tree().sizes(sep+1);
-      std::size_t maxest = nd_.my_sub_graph.ptr(hir) -
-        nd_.my_sub_graph.ptr(lor);
-      if (chl != -1) maxest += upd[chl].size();
-      if (chr != -1) maxest += upd[chr].size();
-      upd[sep].reserve(maxest);
-      for (integer_t r=lor; r<hir; r++)
-        merge_if_larger
-          (nd_.my_sub_graph.ind() + nd_.my_sub_graph.ptr(r),
-           nd_.my_sub_graph.ind() + nd_.my_sub_graph.ptr(r+1),
-           upd[sep], sep_end);
-    }
-    if (chl != -1)
-      merge_if_larger(upd[chl].begin(), upd[chl].end(), upd[sep], sep_end);
-    if (chr != -1)
-      merge_if_larger(upd[chr].begin(), upd[chr].end(), upd[sep], sep_end);
-    upd[sep].shrink_to_fit();
-    float d1 = sep_end - sep_begin, d2 = upd[sep].size();
-    //                  getrf            + 2 * trsm     + gemm
-    subtree_work[sep] = 2.0/3.0*d1*d1*d1 + 2.0*d1*d1*d2 + 2.0*d2*d2*d1;
-    if (chl != -1) subtree_work[sep] += subtree_work[chl];
-    if (chr != -1) subtree_work[sep] += subtree_work[chr];
-  }
-
-  template<typename scalar_t,typename integer_t>
-  template<typename It> void
-  EliminationTreeMPIDist<scalar_t,integer_t>::merge_if_larger
-  (const It u0, const It u1, std::vector<integer_t>& out,
-   integer_t s) const {
-    auto b = std::lower_bound(u0, u1, s);
-    auto m = out.size();
-    std::copy(b, u1, std::back_inserter(out));
-    std::inplace_merge(out.begin(), out.begin() + m, out.end());
-    out.erase(std::unique(out.begin(), out.end()), out.end());
-  }
-
   /**
    * Symbolic factorization:
    *   bottom-up merging of upd indices and work estimate for each
    *   subtree
    *     - first do the symbolic factorization for the local subgraph,
-   *        this does not require communication
+   *        this does not require communication, see
+   *        EliminationTree::symbolic_factorization
    *     - then symbolic factorization for the distributed separator
    *        assigned to this process receive upd from left and right
    *        childs, merge with upd for local distributed separator
@@ -430,18 +381,40 @@ namespace strumpack {
    */
   template<typename scalar_t,typename integer_t> void
   EliminationTreeMPIDist<scalar_t,integer_t>::symbolic_factorization
-  (std::vector<std::vector<integer_t>>& local_upd,
+  (std::vector<std::size_t>& local_uptr, std::vector<integer_t>& local_uind,
    std::vector<float>& local_subtree_work,
    std::vector<integer_t>& dist_upd, float& dsep_work,
    std::vector<integer_t>& dleaf_upd, float& dleaf_work) {
     nd_.my_sub_graph.sort_rows();
 
-    if (!nd_.local_tree().is_empty()) {
-#pragma omp parallel
-#pragma omp single
-      symbolic_factorization_local
-        (nd_.local_tree().root(), local_upd, local_subtree_work, 0);
+    auto& ltree = nd_.local_tree();
+    if (!ltree.is_empty()) {
+      EliminationTree<scalar_t,integer_t>::symbolic_factorization
+        (ltree, nd_.my_sub_graph.ptr(), nd_.my_sub_graph.ind(),
+         nd_.sub_graph_range.first, local_uptr, local_uind);
+      // children come before the parent
+      for (integer_t sep=0; sep<ltree.separators(); sep++) {
+        float d1 = ltree.sizes(sep+1) - ltree.sizes(sep),
+          d2 = local_uptr[sep+1] - local_uptr[sep];
+        //        getrf            + 2 * trsm     + gemm
+        float w = 2.0/3.0*d1*d1*d1 + 2.0*d1*d1*d2 + 2.0*d2*d2*d1;
+        for (auto ch : {ltree.lch(sep), ltree.rch(sep)})
+          if (ch != -1) w += local_subtree_work[ch];
+        local_subtree_work[sep] = w;
+      }
     }
+    // append the indices >= s from the sorted rows of g to out
+    auto collect = [](const CSRGraph<integer_t>& g, integer_t rows,
+                      integer_t s, std::vector<integer_t>& out) {
+      for (integer_t r=0; r<rows; r++)
+        out.insert(out.end(), std::lower_bound
+                   (g.ind()+g.ptr(r), g.ind()+g.ptr(r+1), s),
+                   g.ind()+g.ptr(r+1));
+    };
+    auto sort_unique = [](std::vector<integer_t>& v) {
+      std::sort(v.begin(), v.end());
+      v.erase(std::unique(v.begin(), v.end()), v.end());
+    };
 
     dsep_work = dleaf_work = 0.;
     nd_.my_dist_sep.sort_rows();
@@ -457,18 +430,17 @@ namespace strumpack {
       if (nd_.tree().is_leaf(dsep)) {
         // Leaf of distributed tree is local subgraph for process
         // proc_dist_sep[dsep], unless the local_tree is empty.
-        if (!nd_.local_tree().is_empty()) {
-          dleaf_work = local_subtree_work[nd_.local_tree().root()];
-          dleaf_upd = local_upd[nd_.local_tree().root()];
+        if (!ltree.is_empty()) {
+          auto root = ltree.root();
+          dleaf_work = local_subtree_work[root];
+          dleaf_upd.assign(local_uind.begin()+local_uptr[root],
+                           local_uind.begin()+local_uptr[root+1]);
         } else {
           auto sep_begin = nd_.sub_graph_range.first;
           auto sep_end = nd_.sub_graph_range.second;
-          for (integer_t r=0; r<sep_end-sep_begin; r++)
-            merge_if_larger
-              (nd_.my_sub_graph.ind() + nd_.my_sub_graph.ptr(r),
-               nd_.my_sub_graph.ind() + nd_.my_sub_graph.ptr(r+1),
-               dleaf_upd, sep_end);
-          float dim_blk = (sep_end - sep_begin) + dist_upd.size();
+          collect(nd_.my_sub_graph, sep_end-sep_begin, sep_end, dleaf_upd);
+          sort_unique(dleaf_upd);
+          float dim_blk = (sep_end - sep_begin) + dleaf_upd.size();
           dleaf_work = std::pow(dim_blk, 3);
         }
         // do not send to parent if parent is root
@@ -480,21 +452,18 @@ namespace strumpack {
       } else {
         auto sep_begin = nd_.dist_sep_range.first;
         auto sep_end = nd_.dist_sep_range.second;
-        for (integer_t r=0; r<sep_end-sep_begin; r++)
-          merge_if_larger
-            (nd_.my_dist_sep.ind() + nd_.my_dist_sep.ptr(r),
-             nd_.my_dist_sep.ind() + nd_.my_dist_sep.ptr(r+1),
-             dist_upd, sep_end);
-
+        collect(nd_.my_dist_sep, sep_end-sep_begin, sep_end, dist_upd);
         int nr_children = (nd_.tree().is_leaf(dsep) &&
                            nd_.local_tree().is_empty()) ? 0 : 2;
         for (int i=0; i<nr_children; i++) {
           // receive dist_upd from left/right child,
           auto du = comm_.template recv_any_src<integer_t>(1);
-          // then merge elements larger than sep_end
-          merge_if_larger
-            (du.second.begin(), du.second.end(), dist_upd, sep_end);
+          // then add the elements larger than sep_end
+          dist_upd.insert
+            (dist_upd.end(), std::lower_bound
+             (du.second.begin(), du.second.end(), sep_end), du.second.end());
         }
+        sort_unique(dist_upd);
         if (!nd_.tree().is_root(pa)) { // do not send to root
           sreq.emplace_back();     // send dist_upd to parent
           comm_.isend(dist_upd, pa_rank, 1, &sreq.back());
@@ -557,7 +526,8 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t>
   std::unique_ptr<FrontalMatrix<scalar_t,integer_t>>
   EliminationTreeMPIDist<scalar_t,integer_t>::proportional_mapping
-  (const Opts_t& opts, std::vector<std::vector<integer_t>>& local_upd,
+  (const Opts_t& opts, const std::vector<std::size_t>& local_uptr,
+   const std::vector<integer_t>& local_uind,
    std::vector<float>& local_subtree_work,
    std::vector<integer_t>& dist_upd, std::vector<integer_t>& dleaf_upd,
    std::vector<float>& dist_subtree_work, integer_t dsep,
@@ -570,7 +540,7 @@ namespace strumpack {
     if (nd_.tree().is_leaf(dsep)) {
       RedistSubTree<integer_t> sub_tree
         (nd_.local_tree(), nd_.sub_graph_range.first,
-         local_upd, local_subtree_work, P0, P,
+         local_uptr, local_uind, local_subtree_work, P0, P,
          P0_sibling, P_sibling, owner, comm_);
       //if (sub_tree.nr_sep)
       return proportional_mapping_sub_graphs
@@ -628,11 +598,11 @@ namespace strumpack {
     int Pl = std::max(1, std::min(int(std::round(P * wl / (wl + wr))), P-1));
     int Pr = std::max(1, P - Pl);
     auto lch = proportional_mapping
-      (opts, local_upd, local_subtree_work, dist_upd, dleaf_upd,
+      (opts, local_uptr, local_uind, local_subtree_work, dist_upd, dleaf_upd,
        dist_subtree_work, chl, P0, Pl, P0+P-Pr, Pr, fcomm.sub(0, Pl),
        use_compression, level+1);
     auto rch = proportional_mapping
-      (opts, local_upd, local_subtree_work, dist_upd, dleaf_upd,
+      (opts, local_uptr, local_uind, local_subtree_work, dist_upd, dleaf_upd,
        dist_subtree_work, chr, P0+P-Pr, Pr, P0, Pl, fcomm.sub(P-Pr, Pr),
        use_compression, level+1);
     if (front) {
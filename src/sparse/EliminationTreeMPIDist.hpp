@@ -73,6 +73,16 @@ namespace strumpack {
 
     void separator_reordering(const Opts_t& opts, const CSRMPI_t& A);
 
+    /**
+     * Redistribute the values of A, which should have the same
+     * sparsity pattern as the matrix used to construct this tree,
+     * keeping the tree and the proportional mapping. Returns false if
+     * this is not possible, in which case the tree should be
+     * reconstructed. This is collective on the communicator of the
+     * tree.
+     */
+    bool update_values(const Opts_t& opts, const CSRMPI_t& A);
+
   private:
     using EliminationTreeMPI<scalar_t,integer_t>::comm_;
     using EliminationTreeMPI<scalar_t,integer_t>::rank_;
@@ -136,18 +146,14 @@ namespace strumpack {
     std::vector<ParallelFront> all_pfronts_, local_pfronts_;
 
     void symbolic_factorization
-    (std::vector<std::vector<integer_t>>& local_upd,
+    (std::vector<std::size_t>& local_uptr, std::vector<integer_t>& local_uind,
      std::vector<float>& local_subtree_work,
      std::vector<integer_t>& dsep_upd, float& dsep_work,
      std::vector<integer_t>& dleaf_upd, float& dleaf_work);
 
-    void symbolic_factorization_local
-    (integer_t sep, std::vector<std::vector<integer_t>>& upd,
-     std::vector<float>& subtree_work, int depth);
-
     std::unique_ptr<F_t> proportional_mapping
-    (const Opts_t& opts,
-     std::vector<std::vector<integer_t>>& upd, std::vector<float>& subtree_work,
+    (const Opts_t& opts, const std::vector<std::size_t>& uptr,
+     const std::vector<integer_t>& uind, std::vector<float>& subtree_work,
      std::vector<integer_t>& dist_upd, std::vector<integer_t>& dleaf_upd,
      std::vector<float>& dist_subtree_work,
      integer_t dsep, int P0, int P, int P0_sibling, int P_sibling,
@@ -163,9 +169,6 @@ namespace strumpack {
      integer_t& dsep_begin, integer_t& dsep_end,
      std::vector<integer_t>& dupd_recv, int P0, int P,
      int P0_sibling, int P_sibling, int owner);
-
-    template<typename It> void merge_if_larger
-    (const It u0, const It u1, std::vector<integer_t>& out, integer_t s) const;
   };
 
 } // end namespace strumpack
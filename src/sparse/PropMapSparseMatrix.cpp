@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <cmath>
 #include <tuple>
+#include <numeric>
 
 #include "PropMapSparseMatrix.hpp"
 #include "dense/DistributedMatrix.hpp"
@@ -80,8 +81,12 @@ namespace strumpack {
 
     using Triplet = Triplet<scalar_t,integer_t>;
     std::vector<std::vector<Triplet>> sbuf(P);
-    for (int p=0; p<P; p++)
+    std::vector<std::vector<integer_t>> sidx(P);
+    for (int p=0; p<P; p++) {
       sbuf[p].reserve(scnts[p]);
+      sidx[p].reserve(scnts[p]);
+    }
+    plan_skip_.clear();
     for (integer_t r=0; r<Ampi.local_rows(); r++) {
       auto r_perm = nd.perm()[r + Ampi.begin_row()];
       auto hij = Ampi.ptr(r+1) - Ampi.ptr(0);
@@ -91,47 +96,97 @@ namespace strumpack {
           Triplet t = {r_perm, nd.perm()[Ampi.ind(j)], a};
           auto& d = dest[j];
           auto hip = std::get<0>(d) + std::get<1>(d);
-          for (int p=std::get<0>(d); p<hip; p+=std::get<2>(d))
+          for (int p=std::get<0>(d); p<hip; p+=std::get<2>(d)) {
             sbuf[p].push_back(t); // do NOT use emplace
-        }
+            sidx[p].push_back(j);
+          }
+        } else plan_skip_.push_back(j);
       }
     }
-    auto triplets = comm.all_to_all_v(sbuf);
+    plan_sptr_.resize(P+1);
+    plan_sptr_[0] = 0;
+    for (int p=0; p<P; p++)
+      plan_sptr_[p+1] = plan_sptr_[p] + sidx[p].size();
+    plan_src_.resize(plan_sptr_[P]);
+    for (int p=0; p<P; p++) {
+      std::copy(sidx[p].begin(), sidx[p].end(),
+                plan_src_.begin()+plan_sptr_[p]);
+      std::vector<integer_t>().swap(sidx[p]);
+    }
+    std::vector<Triplet> triplets;
+    std::vector<Triplet*> pbuf;
+    plan_rcnts_.clear();
+    comm.all_to_all_v(sbuf, triplets, pbuf, Triplet::mpi_type(), &plan_rcnts_);
 
-    // TODO this sort can be avoided? first make the CSR/CSC
-    // representation, then sort that row per row in parallel
+    // sort according to column, then rows. Sort a permutation, which
+    // is kept to map the received values to val_ in update_values.
+    integer_t lnnz = triplets.size();
+    std::vector<integer_t> order(lnnz);
+    std::iota(order.begin(), order.end(), 0);
     std::sort
-      (triplets.begin(), triplets.end(),
-       [](const Triplet& a, const Triplet& b) {
-         // sort according to column, then rows
+      (order.begin(), order.end(),
+       [&triplets](integer_t i, integer_t j) {
+         const auto& a = triplets[i];
+         const auto& b = triplets[j];
          if (a.c != b.c) return (a.c < b.c);
          return (a.r < b.r);
        });
 
-    integer_t lnnz = triplets.size();
     local_cols_ = lnnz ? 1 : 0;
     for (integer_t t=1; t<lnnz; t++)
-      if (triplets[t].c != triplets[t-1].c) local_cols_++;
+      if (triplets[order[t]].c != triplets[order[t-1]].c) local_cols_++;
     ptr_.resize(local_cols_+1);
     global_col_.resize(local_cols_);
     ind_.resize(lnnz);
     val_.resize(lnnz);
+    plan_dst_.resize(lnnz);
     integer_t col = 0;
     ptr_[col] = 0;
     if (local_cols_) {
       ptr_[1] = 0;
-      global_col_[col] = triplets[0].c;
+      global_col_[col] = triplets[order[0]].c;
     }
     for (integer_t j=0; j<lnnz; j++) {
-      ind_[j] = triplets[j].r;
-      val_[j] = triplets[j].v;
-      if (j > 0 && (triplets[j].c != triplets[j-1].c)) {
+      const auto& t = triplets[order[j]];
+      ind_[j] = t.r;
+      val_[j] = t.v;
+      plan_dst_[order[j]] = j;
+      if (j > 0 && (t.c != triplets[order[j-1]].c)) {
         col++;
         ptr_[col+1] = ptr_[col];
-        global_col_[col] = triplets[j].c;
+        global_col_[col] = t.c;
       }
       ptr_[col+1]++;
     }
+    plan_lnnz_ = Ampi.local_nnz();
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  PropMapSparseMatrix<scalar_t,integer_t>::update_values
+  (const CSRMatrixMPI<scalar_t,integer_t>& Ampi, const MPIComm& comm) {
+    auto eps = blas::lamch<real_t>('E');
+    int ok = (plan_lnnz_ == Ampi.local_nnz());
+    if (ok)
+      for (auto j : plan_skip_)
+        if (std::abs(Ampi.val(j)) > eps) { ok = 0; break; }
+    if (!comm.all_reduce(ok, MPI_MIN)) return false;
+    auto P = comm.size();
+    std::vector<std::vector<scalar_t>> sbuf(P);
+#pragma omp parallel for
+    for (int p=0; p<P; p++) {
+      sbuf[p].resize(plan_sptr_[p+1] - plan_sptr_[p]);
+      for (integer_t k=plan_sptr_[p]; k<plan_sptr_[p+1]; k++)
+        sbuf[p][k-plan_sptr_[p]] = Ampi.val(plan_src_[k]);
+    }
+    std::vector<scalar_t,NoInit<scalar_t>> rbuf;
+    std::vector<scalar_t*> pbuf;
+    comm.all_to_all_v(sbuf, rbuf, pbuf, mpi_type<scalar_t>(), &plan_rcnts_);
+    const std::size_t n = rbuf.size();
+    assert(n == plan_dst_.size());
+#pragma omp parallel for
+    for (std::size_t k=0; k<n; k++)
+      val_[plan_dst_[k]] = rbuf[k];
+    return true;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -76,6 +76,19 @@ namespace strumpack {
      const EliminationTreeMPIDist<scalar_t,integer_t>& et,
      bool duplicate_fronts);
 
+    /**
+     * Redistribute only the values of Ampi, which should have the
+     * same sparsity pattern as the matrix passed to setup, using the
+     * communication plan constructed in setup. This avoids
+     * recomputing the destinations, the exchange of the message
+     * sizes and the sorting. Returns false (on all ranks) if the plan
+     * cannot be used, for instance because the number of nonzeros
+     * changed, or a value that was dropped as (numerically) zero in
+     * setup is now nonzero. This is collective on comm.
+     */
+    bool update_values
+    (const CSRMatrixMPI<scalar_t,integer_t>& Ampi, const MPIComm& comm);
+
     void print_dense(const std::string& name) const override;
 
     void extract_separator
@@ -169,6 +182,15 @@ namespace strumpack {
                                         // gives the global column
                                         // index
 
+    // communication plan for update_values: local nonzeros of Ampi
+    // to send to rank p are plan_src_[plan_sptr_[p]:plan_sptr_[p+1]),
+    // received value k goes to val_[plan_dst_[k]], plan_rcnts_[p]
+    // values are received from rank p, and plan_skip_ are the
+    // nonzeros of Ampi which were dropped
+    std::vector<integer_t> plan_src_, plan_sptr_, plan_dst_, plan_skip_;
+    std::vector<int> plan_rcnts_;
+    integer_t plan_lnnz_ = -1;
+
     integer_t find_global(integer_t c, integer_t clo=0) const {
       // TODO create a loopkup vector
       return std::distance
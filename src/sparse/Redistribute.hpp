@@ -151,7 +151,8 @@ namespace strumpack {
     // owned by owner to [P0,P0+P) send only the root of the sub tree
     // to [P0_brother,P0_brother+P_brother)
     RedistSubTree(const SeparatorTree<integer_t>& tree, integer_t sub_begin,
-                  const std::vector<std::vector<integer_t>>& _upd,
+                  const std::vector<std::size_t>& uptr,
+                  const std::vector<integer_t>& uind,
                   const std::vector<float>& _work,
                   integer_t P0, integer_t P, integer_t P0_sibling,
                   integer_t P_sibling, integer_t owner, const MPIComm& comm) {
@@ -171,9 +172,8 @@ namespace strumpack {
         for (integer_t s=0; s<nbsep+1; s++)
           sbufi.push_back(tree.sizes(s) + sub_begin);
         for (integer_t i=0; i<nbsep; i++)
-          sbufi.push_back(_upd[i].size());
-        for (integer_t i=0; i<nbsep; i++)
-          sbufi.insert(sbufi.end(), _upd[i].begin(), _upd[i].end());
+          sbufi.push_back(uptr[i+1] - uptr[i]);
+        sbufi.insert(sbufi.end(), uind.begin(), uind.end());
         sbuff.reserve(nbsep);
         sbuff.insert(sbuff.end(), _work.begin(), _work.end());
         if (sbufi.size() >=
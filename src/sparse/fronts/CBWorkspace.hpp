@@ -0,0 +1,143 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef CB_WORKSPACE_HPP
+#define CB_WORKSPACE_HPP
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+
+#include "StrumpackParameters.hpp"
+
+namespace strumpack {
+
+  /**
+   * Stack allocator for the contribution blocks (the F22 blocks) of
+   * the fronts in a subtree that is traversed sequentially, in
+   * postorder, by a single thread. This is the classical multifrontal
+   * stack: the contribution blocks of the children are pushed before
+   * the parent, and are popped again after the extend-add into the
+   * parent. The parent contribution block is then moved down to fill
+   * up the space released by the children.
+   *
+   * The memory for the entire stack is allocated at once, when the
+   * stack is activated, using the peak computed from the elimination
+   * tree, see FrontalMatrix::CB_stack_peak. There is one workspace
+   * per thread.
+   */
+  template<typename scalar_t> class CBWorkspace {
+  public:
+    static CBWorkspace<scalar_t>& thread_workspace() {
+      thread_local CBWorkspace<scalar_t> ws;
+      return ws;
+    }
+
+    bool active() const { return active_; }
+
+    void activate(std::size_t size) {
+      assert(!active_);
+      STRUMPACK_ADD_MEMORY(size*sizeof(scalar_t));
+      buf_.reset(new scalar_t[size]);
+      size_ = size;
+      top_ = 0;
+      active_ = true;
+    }
+
+    void deactivate() {
+      assert(blocks_.empty());
+      STRUMPACK_SUB_MEMORY(size_*sizeof(scalar_t));
+      buf_.reset();
+      size_ = top_ = 0;
+      active_ = false;
+    }
+
+    /**
+     * Return a pointer to size scalars on top of the stack, or
+     * nullptr if the stack does not have enough room left.
+     */
+    scalar_t* push(std::size_t size) {
+      if (!active_ || top_ + size > size_) return nullptr;
+      blocks_.push_back({top_, size, false});
+      top_ += size;
+      return buf_.get() + blocks_.back().begin;
+    }
+
+    /**
+     * Release the block starting at p. Blocks do not have to be
+     * released in LIFO order, the memory is only reclaimed once all
+     * blocks above are released as well.
+     */
+    void pop(const scalar_t* p) {
+      if (!active_) return;
+      std::size_t b = p - buf_.get();
+      for (auto blk=blocks_.rbegin(); blk!=blocks_.rend(); blk++)
+        if (blk->begin == b) {
+          blk->free = true;
+          break;
+        }
+      while (!blocks_.empty() && blocks_.back().free) {
+        top_ = blocks_.back().begin;
+        blocks_.pop_back();
+      }
+    }
+
+    /**
+     * Move the block at the top of the stack, which starts at p, down
+     * over the released blocks right below it. Returns the new
+     * location of the block.
+     */
+    scalar_t* compact(scalar_t* p) {
+      assert(!blocks_.empty() && buf_.get() + blocks_.back().begin == p);
+      auto top = blocks_.back();
+      blocks_.pop_back();
+      auto begin = top.begin;
+      while (!blocks_.empty() && blocks_.back().free) {
+        begin = blocks_.back().begin;
+        blocks_.pop_back();
+      }
+      auto dest = buf_.get() + begin;
+      if (begin != top.begin)
+        std::copy(p, p + top.size, dest);
+      blocks_.push_back({begin, top.size, false});
+      top_ = begin + top.size;
+      return dest;
+    }
+
+  private:
+    struct Block { std::size_t begin, size; bool free; };
+    std::unique_ptr<scalar_t[]> buf_;
+    std::size_t size_ = 0, top_ = 0;
+    bool active_ = false;
+    std::vector<Block> blocks_;
+  };
+
+} // end namespace strumpack
+
+#endif // CB_WORKSPACE_HPP
@@ -29,6 +29,9 @@
 #ifndef EXTEND_ADD_HPP
 #define EXTEND_ADD_HPP
 
+#include <limits>
+#include <iostream>
+
 #include "dense/DistributedMatrix.hpp"
 
 
@@ -129,6 +132,129 @@ namespace strumpack {
      const DistM_t& B, std::vector<scalar_t*>& pbuf);
   };
 
+  /**
+   * Non-blocking alternative to MPI_Alltoallv for the extend-add
+   * from the two children of a distributed front to the front
+   * itself. The ranks of the children are given by the disjoint
+   * ranges [lo[i], lo[i]+n[i]), i = 0, 1, of the communicator of the
+   * front. A rank of a child sends a message only to the ranks for
+   * which its part of the contribution block is not empty, using
+   * MPI_Isend, as soon as it has been packed. The parent assembles
+   * the contribution of a child as soon as all messages from that
+   * child have arrived, which can overlap with the factorization of
+   * the other child.
+   *
+   * To know how many messages to expect, the ranks of a child sum
+   * the number of senders per destination over the communicator of
+   * that child, so this does not synchronize with the other
+   * child. Ranks outside of a child receive that count in a single
+   * small message from one of its ranks.
+   *
+   * The messages of a front use the tags tag, tag+1 and tag+2, with
+   * tag passed to the constructor.
+   */
+  template<typename T> class AsyncExtendAdd {
+  public:
+    AsyncExtendAdd(const MPIComm& c, int tag) : c_(c), tag_(tag) {}
+    AsyncExtendAdd(const AsyncExtendAdd&) = delete;
+    AsyncExtendAdd& operator=(const AsyncExtendAdd&) = delete;
+    ~AsyncExtendAdd() { wait(); }
+
+    /**
+     * Called by the ranks of child g, start sending sbuf[p] to each
+     * rank p for which it is not empty. The send buffers are moved
+     * into this object, and kept alive until wait().
+     *
+     * \param chcomm communicator of child g, or nullptr if that
+     * child is on a single rank
+     */
+    void send(std::vector<std::vector<T>>&& sbuf, const MPIComm* chcomm,
+              int g, const int lo[2], const int n[2]) {
+      sbuf_ = std::move(sbuf);
+      const int P = sbuf_.size(), rank = c_.rank();
+      cnt_.resize(P);
+      reqs_.reserve(2*P);
+      for (int p=0; p<P; p++)
+        cnt_[p] = sbuf_[p].empty() ? 0 : 1;
+      if (chcomm) chcomm->all_reduce(cnt_, MPI_SUM);
+      own_ = cnt_[rank];
+      for (int p=0; p<P; p++) {
+        if (sbuf_[p].empty()) continue;
+        if (sbuf_[p].size() >
+            static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+          std::cerr << "# ERROR: 32bit integer overflow in extend-add!!"
+                    << std::endl;
+          MPI_Abort(c_.comm(), 1);
+        }
+        reqs_.emplace_back();
+        MPI_Isend(sbuf_[p].data(), sbuf_[p].size(), mpi_type<T>(),
+                  p, tag_+g, c_.comm(), &reqs_.back());
+      }
+      // the count for rank p outside of this child is sent by
+      // rank lo[g] + p % n[g]
+      for (int p=0; p<P; p++) {
+        if (p >= lo[g] && p < lo[g]+n[g]) continue;
+        if (lo[g] + p % n[g] != rank) continue;
+        reqs_.emplace_back();
+        c_.isend(cnt_[p], p, tag_+2, &reqs_.back());
+      }
+    }
+
+    /**
+     * Receive the contributions of the children, see send. The
+     * contribution of the child this rank belongs to, g, is received
+     * first (g = -1 if this rank is in neither child). As soon as all
+     * messages from child i have been received, call assemble(i,
+     * pbuf), where pbuf[p] points to the data received from rank
+     * lo[i]+p, or is null when that rank did not send anything.
+     */
+    template<typename F> void
+    receive(int g, const int lo[2], const int n[2], const F& assemble) {
+      std::vector<std::vector<T>> rbuf(c_.size());
+      std::vector<T*> pbuf;
+      const int rank = c_.rank();
+      for (int k=0; k<2; k++) {
+        int i = (g == 1) ? 1 - k : k;
+        if (!n[i]) continue;
+        int msgs = (i == g) ? own_ :
+          c_.recv_one<int>(lo[i] + rank % n[i], tag_+2);
+        for (; msgs>0; msgs--) {
+          MPI_Status stat;
+          MPI_Probe(MPI_ANY_SOURCE, tag_+i, c_.comm(), &stat);
+          int src = stat.MPI_SOURCE, cnt = 0;
+          MPI_Get_count(&stat, mpi_type<T>(), &cnt);
+          rbuf[src].resize(cnt);
+          MPI_Recv(rbuf[src].data(), cnt, mpi_type<T>(), src, tag_+i,
+                   c_.comm(), MPI_STATUS_IGNORE);
+        }
+        pbuf.resize(n[i]);
+        for (int p=0; p<n[i]; p++)
+          pbuf[p] = rbuf[lo[i]+p].empty() ? nullptr : rbuf[lo[i]+p].data();
+        assemble(i, pbuf.data());
+        for (int p=0; p<n[i]; p++)
+          std::vector<T>().swap(rbuf[lo[i]+p]);
+      }
+    }
+
+    /**
+     * Wait for the sends to complete and release the send buffers.
+     */
+    void wait() {
+      if (!reqs_.empty())
+        MPI_Waitall(reqs_.size(), reqs_.data(), MPI_STATUSES_IGNORE);
+      reqs_.clear();
+      std::vector<std::vector<T>>().swap(sbuf_);
+    }
+
+  private:
+    const MPIComm& c_;
+    const int tag_;
+    std::vector<std::vector<T>> sbuf_;
+    std::vector<int> cnt_;
+    int own_ = 0;
+    std::vector<MPI_Request> reqs_;
+  };
+
   // forward declaration
   template<typename scalar_t,typename integer_t> class CompressedSparseMatrix;
 
@@ -130,6 +130,33 @@ namespace strumpack {
     return front;
   }
 
+  template<typename scalar_t, typename integer_t>
+  std::unique_ptr<FrontalMatrix<scalar_t,integer_t>> create_frontal_matrix
+  (const std::string& type, integer_t s, integer_t sbegin,
+   integer_t send, std::vector<integer_t>& upd, FrontCounter& fc) {
+    std::unique_ptr<FrontalMatrix<scalar_t,integer_t>> front;
+    if (type == "FrontalMatrixDense") {
+      front.reset
+        (new FrontalMatrixDense<scalar_t,integer_t>(s, sbegin, send, upd));
+      fc.dense++;
+    } else if (type == "FrontalMatrixHSS") {
+      front.reset
+        (new FrontalMatrixHSS<scalar_t,integer_t>(s, sbegin, send, upd));
+      fc.HSS++;
+    } else if (type == "FrontalMatrixBLR") {
+      front.reset
+        (new FrontalMatrixBLR<scalar_t,integer_t>(s, sbegin, send, upd));
+      fc.BLR++;
+    } else if (type == "FrontalMatrixLossy") {
+#if defined(STRUMPACK_USE_ZFP)
+      front.reset
+        (new FrontalMatrixLossy<scalar_t,integer_t>(s, sbegin, send, upd));
+      fc.lossy++;
+#endif
+    }
+    return front;
+  }
+
   // explicit template instantiations
   template std::unique_ptr<FrontalMatrix<float,int>> create_frontal_matrix
   (const SPOptions<float>& opts, int s, int sbegin, int send,
@@ -192,6 +219,56 @@ namespace strumpack {
    long long int sbegin, long long int send, std::vector<long long int>& upd,
    bool compressed_parent, int level, FrontCounter& fc, bool root);
 
+  template std::unique_ptr<FrontalMatrix<float,int>>
+  create_frontal_matrix
+  (const std::string& type, int s, int sbegin, int send,
+   std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<double,int>>
+  create_frontal_matrix
+  (const std::string& type, int s, int sbegin, int send,
+   std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<float>,int>>
+  create_frontal_matrix
+  (const std::string& type, int s, int sbegin, int send,
+   std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<double>,int>>
+  create_frontal_matrix
+  (const std::string& type, int s, int sbegin, int send,
+   std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<float,long int>>
+  create_frontal_matrix
+  (const std::string& type, long int s, long int sbegin, long int send,
+   std::vector<long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<double,long int>>
+  create_frontal_matrix
+  (const std::string& type, long int s, long int sbegin, long int send,
+   std::vector<long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<float>,long int>>
+  create_frontal_matrix
+  (const std::string& type, long int s, long int sbegin, long int send,
+   std::vector<long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<double>,long int>>
+  create_frontal_matrix
+  (const std::string& type, long int s, long int sbegin, long int send,
+   std::vector<long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<float,long long int>>
+  create_frontal_matrix
+  (const std::string& type, long long int s, long long int sbegin, long long int send,
+   std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<double,long long int>>
+  create_frontal_matrix
+  (const std::string& type, long long int s, long long int sbegin, long long int send,
+   std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<float>,long long int>>
+  create_frontal_matrix
+  (const std::string& type, long long int s, long long int sbegin, long long int send,
+   std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<FrontalMatrix<std::complex<double>,long long int>>
+  create_frontal_matrix
+  (const std::string& type, long long int s, long long int sbegin, long long int send,
+   std::vector<long long int>& upd, FrontCounter& fc);
+
+
 
 
 
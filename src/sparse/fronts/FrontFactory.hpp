@@ -30,6 +30,7 @@
 #define FRONT_FACTORY_HPP
 
 #include <array>
+#include <string>
 
 #include "StrumpackConfig.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -120,6 +121,17 @@ namespace strumpack {
    integer_t send, std::vector<integer_t>& upd, bool compressed_parent,
    int level, FrontCounter& fc, bool root=true);
 
+  /**
+   * Create a front of the given type, as returned by
+   * FrontalMatrix::type(), used when reading a factorization from
+   * file. Returns nullptr when the type is not supported (or not
+   * available in this build).
+   */
+  template<typename scalar_t, typename integer_t>
+  std::unique_ptr<FrontalMatrix<scalar_t,integer_t>> create_frontal_matrix
+  (const std::string& type, integer_t s, integer_t sbegin,
+   integer_t send, std::vector<integer_t>& upd, FrontCounter& fc);
+
 
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t, typename integer_t>
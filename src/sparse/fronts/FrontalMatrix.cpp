@@ -189,60 +189,103 @@ namespace strumpack {
     return std::max(r, std::max(rl, rr));
   }
 
+  template<typename scalar_t,typename integer_t> std::size_t
+  FrontalMatrix<scalar_t,integer_t>::CB_stack_peak(bool own_CB) const {
+    std::size_t pl = 0, pr = 0, cbl = 0, cbr = 0,
+      dupd = own_CB ? dim_upd() : 0;
+    if (lchild_) {
+      pl = lchild_->CB_stack_peak();
+      cbl = std::size_t(lchild_->dim_upd()) * lchild_->dim_upd();
+    }
+    if (rchild_) {
+      pr = rchild_->CB_stack_peak();
+      cbr = std::size_t(rchild_->dim_upd()) * rchild_->dim_upd();
+    }
+    // the CB of the first child stays on the stack while the subtree
+    // of the second child is processed, the CB of this front is
+    // pushed on top of the CBs of both children
+    if (rchild_first_)
+      return std::max(std::max(pr, cbr + pl), cbl + cbr + dupd*dupd);
+    return std::max(std::max(pl, cbl + pr), cbl + cbr + dupd*dupd);
+  }
+
+  template<typename scalar_t,typename integer_t> std::size_t
+  FrontalMatrix<scalar_t,integer_t>::order_children() {
+    std::size_t pl = 0, pr = 0, cbl = 0, cbr = 0,
+      dupd = dim_upd();
+    if (lchild_) {
+      pl = lchild_->order_children();
+      cbl = std::size_t(lchild_->dim_upd()) * lchild_->dim_upd();
+    }
+    if (rchild_) {
+      pr = rchild_->order_children();
+      cbr = std::size_t(rchild_->dim_upd()) * rchild_->dim_upd();
+    }
+    auto pcb = cbl + cbr + dupd*dupd;
+    auto peak_l = std::max(std::max(pl, cbl + pr), pcb),
+      peak_r = std::max(std::max(pr, cbr + pl), pcb);
+    rchild_first_ = peak_r < peak_l;
+    return std::min(peak_l, peak_r);
+  }
+
   template<typename scalar_t,typename integer_t> void
-  FrontalMatrix<scalar_t,integer_t>::multifrontal_solve(DenseM_t& b) const {
+  FrontalMatrix<scalar_t,integer_t>::multifrontal_solve
+  (DenseM_t& b, Trans op) const {
     auto max_dupd = max_dim_upd();
     auto lvls = levels();
     std::vector<DenseM_t> CB(lvls);
     for (auto& cb : CB)
       cb = DenseM_t(max_dupd, b.cols());
     TIMER_TIME(TaskType::FORWARD_SOLVE, 0, t_fwd);
-    forward_multifrontal_solve(b, CB.data());
+    forward_multifrontal_solve(b, CB.data(), 0, 0, op);
     TIMER_STOP(t_fwd);
     TIMER_TIME(TaskType::BACKWARD_SOLVE, 0, t_bwd);
-    backward_multifrontal_solve(b, CB.data());
+    backward_multifrontal_solve(b, CB.data(), 0, 0, op);
     TIMER_STOP(t_bwd);
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrix<scalar_t,integer_t>::fwd_solve_phase1
   (DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, Trans op) const {
+    // in a pruned solve, the CB of a skipped child is zero
+    auto lch = skip_solve(lchild(), SOLVE_FWD) ? nullptr : lchild();
+    auto rch = skip_solve(rchild(), SOLVE_FWD) ? nullptr : rchild();
     if (task_depth < params::task_recursion_cutoff_level) {
-      if (lchild_)
+      if (lch)
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
-        lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth+1);
-      if (rchild_)
+        lch->forward_multifrontal_solve
+          (b, work+1, etree_level+1, task_depth+1, op);
+      if (rch)
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
-          std::vector<DenseM_t> work2(rchild_->levels());
+          std::vector<DenseM_t> work2(rch->levels());
           for (auto& cb : work2)
-            cb = DenseM_t(rchild_->max_dim_upd(), b.cols());
-          rchild_->forward_multifrontal_solve
-            (b, work2.data(), etree_level+1, task_depth+1);
-          DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work2[0], 0, 0);
-          rchild_->extend_add_b(b, bupd, CBch, this);
+            cb = DenseM_t(rch->max_dim_upd(), b.cols());
+          rch->forward_multifrontal_solve
+            (b, work2.data(), etree_level+1, task_depth+1, op);
+          DenseMW_t CBch(rch->dim_upd(), b.cols(), work2[0], 0, 0);
+          rch->extend_add_b(b, bupd, CBch, this);
         }
 #pragma omp taskwait
-      if (lchild_) {
-        DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
-        lchild_->extend_add_b(b, bupd, CBch, this);
+      if (lch) {
+        DenseMW_t CBch(lch->dim_upd(), b.cols(), work[1], 0, 0);
+        lch->extend_add_b(b, bupd, CBch, this);
       }
     } else {
-      if (lchild_) {
-        lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
-        DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
-        lchild_->extend_add_b(b, bupd, CBch, this);
+      if (lch) {
+        lch->forward_multifrontal_solve
+          (b, work+1, etree_level+1, task_depth, op);
+        DenseMW_t CBch(lch->dim_upd(), b.cols(), work[1], 0, 0);
+        lch->extend_add_b(b, bupd, CBch, this);
       }
-      if (rchild_) {
-        rchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
-        DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work[1], 0, 0);
-        rchild_->extend_add_b(b, bupd, CBch, this);
+      if (rch) {
+        rch->forward_multifrontal_solve
+          (b, work+1, etree_level+1, task_depth, op);
+        DenseMW_t CBch(rch->dim_upd(), b.cols(), work[1], 0, 0);
+        rch->extend_add_b(b, bupd, CBch, this);
       }
     }
   }
@@ -250,43 +293,47 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   FrontalMatrix<scalar_t,integer_t>::bwd_solve_phase2
   (DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, Trans op) const {
+    // in a pruned solve, skip the children whose solution is not
+    // required
+    auto lch = skip_solve(lchild(), SOLVE_BWD) ? nullptr : lchild();
+    auto rch = skip_solve(rchild(), SOLVE_BWD) ? nullptr : rchild();
     if (task_depth < params::task_recursion_cutoff_level) {
-      if (lchild_) {
+      if (lch) {
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
-          DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
-          lchild_->extract_b(y, yupd, CB, this);
-          lchild_->backward_multifrontal_solve
-            (y, work+1, etree_level+1, task_depth+1);
+          DenseMW_t CB(lch->dim_upd(), y.cols(), work[1], 0, 0);
+          lch->extract_b(y, yupd, CB, this);
+          lch->backward_multifrontal_solve
+            (y, work+1, etree_level+1, task_depth+1, op);
         }
       }
-      if (rchild_)
+      if (rch)
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         {
-          std::vector<DenseM_t> work2(rchild_->levels());
+          std::vector<DenseM_t> work2(rch->levels());
           for (auto& cb : work2)
-            cb = DenseM_t(rchild_->max_dim_upd(), y.cols());
-          DenseMW_t CB(rchild_->dim_upd(), y.cols(), work2[0], 0, 0);
-          rchild_->extract_b(y, yupd, CB, this);
-          rchild_->backward_multifrontal_solve
-            (y, work2.data(), etree_level+1, task_depth+1);
+            cb = DenseM_t(rch->max_dim_upd(), y.cols());
+          DenseMW_t CB(rch->dim_upd(), y.cols(), work2[0], 0, 0);
+          rch->extract_b(y, yupd, CB, this);
+          rch->backward_multifrontal_solve
+            (y, work2.data(), etree_level+1, task_depth+1, op);
         }
 #pragma omp taskwait
     } else {
-      if (lchild_) {
-        DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
-        lchild_->extract_b(y, yupd, CB, this);
-        lchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+      if (lch) {
+        DenseMW_t CB(lch->dim_upd(), y.cols(), work[1], 0, 0);
+        lch->extract_b(y, yupd, CB, this);
+        lch->backward_multifrontal_solve
+          (y, work+1, etree_level+1, task_depth, op);
       }
-      if (rchild_) {
-        DenseMW_t CB(rchild_->dim_upd(), y.cols(), work[1], 0, 0);
-        rchild_->extract_b(y, yupd, CB, this);
-        rchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+      if (rch) {
+        DenseMW_t CB(rch->dim_upd(), y.cols(), work[1], 0, 0);
+        rch->extract_b(y, yupd, CB, this);
+        rch->backward_multifrontal_solve
+          (y, work+1, etree_level+1, task_depth, op);
       }
     }
   }
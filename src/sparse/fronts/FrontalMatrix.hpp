@@ -36,6 +36,7 @@
 
 #include "StrumpackParameters.hpp"
 #include "misc/TaskTimer.hpp"
+#include "misc/BinaryIO.hpp"
 #include "dense/DenseMatrix.hpp"
 #include "sparse/CompressedSparseMatrix.hpp"
 #if defined(_OPENMP)
@@ -84,6 +85,7 @@ namespace strumpack {
      integer_t sep_end, std::vector<integer_t>& upd);
     virtual ~FrontalMatrix() = default;
 
+    integer_t sep() const { return sep_; }
     integer_t sep_begin() const { return sep_begin_; }
     integer_t sep_end() const { return sep_end_; }
     integer_t dim_sep() const { return sep_end_ - sep_begin_; }
@@ -113,24 +115,33 @@ namespace strumpack {
     virtual void delete_factors() {}
 
     virtual void
-    multifrontal_solve(DenseM_t& b, const GPUFactors<scalar_t>*) const {
-      multifrontal_solve(b);
+    multifrontal_solve(DenseM_t& b, const GPUFactors<scalar_t>*,
+                       Trans op=Trans::N) const {
+      multifrontal_solve(b, op);
     }
-    virtual void multifrontal_solve(DenseM_t& b) const;
+    /**
+     * Solve with the factors of this (sub)tree, with op != Trans::N
+     * this solves with the (conjugate) transpose of the factored
+     * matrix, the forward sweep then applies U^T and the backward
+     * sweep L^T and the row permutation.
+     */
+    virtual void multifrontal_solve(DenseM_t& b, Trans op=Trans::N) const;
 
     virtual void
     forward_multifrontal_solve(DenseM_t& b, DenseM_t* work,
-                               int etree_level=0,
-                               int task_depth=0) const {};
+                               int etree_level=0, int task_depth=0,
+                               Trans op=Trans::N) const {};
     virtual void
     backward_multifrontal_solve(DenseM_t& y, DenseM_t* work,
-                                int etree_level=0,
-                                int task_depth=0) const {};
+                                int etree_level=0, int task_depth=0,
+                                Trans op=Trans::N) const {};
 
     void fwd_solve_phase1(DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const;
     void bwd_solve_phase2(DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const;
 
     virtual void
     extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
@@ -204,6 +215,33 @@ namespace strumpack {
 
     void set_lchild(std::unique_ptr<F_t> ch) { lchild_ = std::move(ch); }
     void set_rchild(std::unique_ptr<F_t> ch) { rchild_ = std::move(ch); }
+    F_t* lchild() const { return lchild_.get(); }
+    F_t* rchild() const { return rchild_.get(); }
+
+    /**
+     * Mark this front as part of a pruned solve: with SOLVE_FWD
+     * (SOLVE_BWD), children that are not marked SOLVE_FWD
+     * (SOLVE_BWD) are skipped in the forward (backward) solve. See
+     * EliminationTree::set_solve_pattern.
+     */
+    enum : int { SOLVE_FWD = 1, SOLVE_BWD = 2 };
+    void mark_solve(int m) const { solve_mask_ |= m; }
+    void unmark_solve() const { solve_mask_ = 0; }
+    bool marked_solve(int m) const { return solve_mask_ & m; }
+
+    /**
+     * Write the factors of this front (not of its children) to a
+     * binary stream. Returns false if this type of front does not
+     * support this.
+     */
+    virtual bool write_factors(std::ofstream& os) const { return false; }
+
+    /**
+     * Read the factors written by write_factors. Large blocks of
+     * numerical data can be used in place from f, which is a
+     * mapping of the file behind is, when f is not null.
+     */
+    virtual void read_factors(std::ifstream& is, io::MappedFile* f) {}
 
     // TODO compute this (and levels) once, store it
     // maybe compute it when setting pointers to the children
@@ -215,6 +253,25 @@ namespace strumpack {
       return max_dupd;
     }
 
+    // peak size (nr of scalars) of the contribution block stack for
+    // a sequential postorder traversal of the subtree rooted here,
+    // visiting the children in the order set by order_children(),
+    // with own_CB false if the CB of this front is not on the stack
+    std::size_t CB_stack_peak(bool own_CB=true) const;
+
+    /**
+     * For every front in this subtree, choose the order in which the
+     * children are factored in a sequential traversal, to minimize
+     * the peak of the contribution block stack (Liu's ordering). The
+     * child for which the difference between the peak of its subtree
+     * and its own contribution block is largest goes first. Returns
+     * the resulting CB_stack_peak().
+     */
+    std::size_t order_children();
+
+    // the children are factored rchild first, see order_children()
+    bool rchild_first() const { return rchild_first_; }
+
     virtual int P() const { return 1; }
 
     void get_level_fronts(std::vector<const F_t*>& ldata, int elvl, int l=0) const;
@@ -302,6 +359,13 @@ namespace strumpack {
     integer_t sep_, sep_begin_, sep_end_;
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
+    bool rchild_first_ = false;
+    mutable int solve_mask_ = 0;
+
+    // children which can be skipped in a pruned solve
+    bool skip_solve(const F_t* ch, int m) const {
+      return ch && (solve_mask_ & m) && !(ch->solve_mask_ & m);
+    }
 
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
@@ -36,6 +36,7 @@
 #include <random>
 
 #include "misc/TaskTimer.hpp"
+#include "misc/Trace.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
 #include "sparse/CompressedSparseMatrix.hpp"
 #include "BLR/BLRMatrix.hpp"
@@ -84,10 +85,10 @@ namespace strumpack {
 
     void forward_multifrontal_solve
     (DenseM_t& b, DenseM_t* work, int etree_level=0,
-     int task_depth=0) const override;
+     int task_depth=0, Trans op=Trans::N) const override;
     void backward_multifrontal_solve
     (DenseM_t& y, DenseM_t* work, int etree_level=0,
-     int task_depth=0) const override;
+     int task_depth=0, Trans op=Trans::N) const override;
 
     void extract_CB_sub_matrix
     (const std::vector<std::size_t>& I, const std::vector<std::size_t>& J,
@@ -95,6 +96,16 @@ namespace strumpack {
 
     std::string type() const override { return "FrontalMatrixBLR"; }
 
+    bool write_factors(std::ofstream& os) const override {
+      io::write_binary(os, piv_);
+      os << F11blr_ << F12blr_ << F21blr_;
+      return true;
+    }
+    void read_factors(std::ifstream& is, io::MappedFile* f) override {
+      io::read_binary(is, piv_);
+      is >> F11blr_ >> F12blr_ >> F21blr_;
+    }
+
 #if defined(STRUMPACK_USE_MPI)
     void extend_add_copy_to_buffers
     (std::vector<std::vector<scalar_t>>& sbuf, const FMPI_t* pa)
@@ -129,9 +140,11 @@ namespace strumpack {
     FrontalMatrixBLR& operator=(FrontalMatrixBLR const&) = delete;
 
     void fwd_solve_phase2
-    (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const;
+    (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth,
+     Trans op=Trans::N) const;
     void bwd_solve_phase1
-    (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const;
+    (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth,
+     Trans op=Trans::N) const;
 
     void draw_node(std::ostream& of, bool is_root) const override;
 
@@ -261,21 +274,31 @@ namespace strumpack {
     if (opts.BLR_options().low_rank_algorithm() ==
         BLR::LowRankAlgorithm::RRQR) {
       DenseM_t F11(dsep, dsep), F12(dsep, dupd), F21(dupd, dsep);
-      F11.zero(); F12.zero(); F21.zero();
-      A.extract_front(F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
-      if (dupd) {
-        F22_ = DenseM_t(dupd, dupd);
-        F22_.zero();
+      {
+        trace::Region tr(trace::Event::ASSEMBLY, *this, etree_level);
+        F11.zero(); F12.zero(); F21.zero();
+        A.extract_front
+          (F11, F12, F21, sep_begin_, sep_end_, this->upd_, task_depth);
+        if (dupd) {
+          F22_ = DenseM_t(dupd, dupd);
+          F22_.zero();
+        }
+      }
+      {
+        trace::Region tr(trace::Event::EXTEND_ADD, *this, etree_level);
+        if (lchild_)
+          lchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
+        if (rchild_)
+          rchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
       }
-      if (lchild_)
-        lchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
-      if (rchild_)
-        rchild_->extend_add_to_dense(F11, F12, F21, F22_, this, task_depth);
       if (dsep) {
 #if 1
+        // compression and factorization are interleaved
+        trace::Region tr(trace::Event::FACTOR, *this, etree_level);
         BLRM_t::construct_and_partial_factor
           (F11, F12, F21, F22_, F11blr_, piv_, F12blr_, F21blr_,
            sep_tiles_, upd_tiles_, admissibility_, opts.BLR_options());
+        tr.set_rank(F11blr_.maximum_rank());
 #else
         F11blr_ = BLRM_t
           (F11, sep_tiles_, admissibility_, piv_, opts.BLR_options());
@@ -332,10 +355,13 @@ namespace strumpack {
         if (lchild_) lchild_->extract_CB_sub_matrix(gI, gJ, B, task_depth);
         if (rchild_) rchild_->extract_CB_sub_matrix(gI, gJ, B, task_depth);
       };
+      // assembly, compression and factorization are interleaved
+      trace::Region tr(trace::Event::FACTOR, *this, etree_level);
       BLRM_t::construct_and_partial_factor
         (dsep, dupd, F11elem, F12elem, F21elem, F22elem,
          F11blr_, piv_, F12blr_, F21blr_, F22blr_,
          sep_tiles_, upd_tiles_, admissibility_, opts.BLR_options());
+      tr.set_rank(F11blr_.maximum_rank());
       if (lchild_) lchild_->release_work_memory();
       if (rchild_) rchild_->release_work_memory();
     }
@@ -359,26 +385,38 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
     if (task_depth == 0) {
       // tasking when calling the children
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
-      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
       // no tasking for the root node computations, use system blas threading!
-      fwd_solve_phase2(b, bupd, etree_level, params::task_recursion_cutoff_level);
+      fwd_solve_phase2
+        (b, bupd, etree_level, params::task_recursion_cutoff_level, op);
     } else {
-      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
-      fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
+      fwd_solve_phase2(b, bupd, etree_level, task_depth, op);
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::fwd_solve_phase2
-  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
-    if (dim_sep()) {
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth,
+   Trans op) const {
+    trace::Region tr(trace::Event::FORWARD_SOLVE, *this, etree_level);
+    if (dim_sep() && op != Trans::N) {
+      // A^T = U^T L^T P, the forward sweep solves with U^T
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      trsm(Side::L, UpLo::U, op, Diag::N,
+           scalar_t(1.), F11blr_, bloc, task_depth);
+      if (dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F12blr_, bloc,
+             scalar_t(1.), bupd, task_depth);
+    } else if (dim_sep()) {
       DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(piv_, true);
 #if 1
@@ -402,26 +440,38 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
       bwd_solve_phase1
-        (y, yupd, etree_level, params::task_recursion_cutoff_level);
+        (y, yupd, etree_level, params::task_recursion_cutoff_level, op);
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       // tasking when calling children
-      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
     } else {
-      bwd_solve_phase1(y, yupd, etree_level, task_depth);
-      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
+      bwd_solve_phase1(y, yupd, etree_level, task_depth, op);
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixBLR<scalar_t,integer_t>::bwd_solve_phase1
-  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
-    if (dim_sep()) {
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth,
+   Trans op) const {
+    trace::Region tr(trace::Event::BACKWARD_SOLVE, *this, etree_level);
+    if (dim_sep() && op != Trans::N) {
+      // backward sweep with L^T, followed by the row permutation P^T
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F21blr_, yupd,
+             scalar_t(1.), yloc, task_depth);
+      trsm(Side::L, UpLo::L, op, Diag::U,
+           scalar_t(1.), F11blr_, yloc, task_depth);
+      yloc.laswp(piv_, false);
+    } else if (dim_sep()) {
       DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
 #if 1
       BLRM_t::gemm_trsmUNN(F11blr_, F12blr_, yloc, yupd, task_depth);
@@ -35,6 +35,7 @@
 #include "sparse/CSRGraph.hpp"
 #include "ExtendAdd.hpp"
 #include "BLR/BLRExtendAdd.hpp"
+#include "misc/Trace.hpp"
 
 namespace strumpack {
 
@@ -52,7 +53,8 @@ namespace strumpack {
   }
 
   template<typename scalar_t,typename integer_t> void
-  FrontalMatrixBLRMPI<scalar_t,integer_t>::extend_add() {
+  FrontalMatrixBLRMPI<scalar_t,integer_t>::extend_add
+  (const SPOptions<scalar_t>& opts) {
     if (!lchild_ && !rchild_) return;
     std::vector<std::vector<scalar_t>> sbuf(this->P());
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
@@ -63,6 +65,13 @@ namespace strumpack {
       if (!visit(ch)) continue;
       ch->extadd_blr_copy_to_buffers(sbuf, this);
     }
+    if (this->async_extend_add(opts)) {
+      this->extend_add_async
+        (std::move(sbuf), [&](const F_t* ch, scalar_t** pbuf) {
+          ch->extadd_blr_copy_from_buffers
+            (F11blr_, F12blr_, F21blr_, F22blr_, pbuf, this); });
+      return;
+    }
     std::vector<scalar_t,NoInit<scalar_t>> rbuf;
     std::vector<scalar_t*> pbuf;
     Comm().all_to_all_v(sbuf, rbuf, pbuf);
@@ -149,11 +158,19 @@ namespace strumpack {
     if (visit(rchild_))
       rchild_->multifrontal_factorization
         (A, opts, etree_level+1, task_depth);
-    build_front(A);
-    extend_add();
+    {
+      trace::Region tr(trace::Event::ASSEMBLY, *this, etree_level);
+      build_front(A);
+    }
+    {
+      trace::Region tr(trace::Event::EXTEND_ADD, *this, etree_level);
+      extend_add(opts);
+    }
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
     if (dim_sep() && grid2d().active()) {
+      // compression and factorization are interleaved
+      trace::Region tr(trace::Event::FACTOR, *this, etree_level);
       if (dim_upd())
         piv_ = BLRMPI_t::partial_factor
           (F11blr_, F12blr_, F21blr_, F22blr_, adm_, opts.BLR_options());
@@ -179,6 +196,7 @@ namespace strumpack {
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
     if (dim_sep()) {
+      trace::Region tr(trace::Event::FORWARD_SOLVE, *this, etree_level);
       TIMER_TIME(TaskType::SOLVE_LOWER, 0, t_s);
       std::vector<std::size_t> col_tiles(1, b.cols());
       auto b_blr = BLRMPI_t::from_ScaLAPACK
@@ -207,6 +225,7 @@ namespace strumpack {
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
     if (dim_sep()) {
+      trace::Region tr(trace::Event::BACKWARD_SOLVE, *this, etree_level);
       TIMER_TIME(TaskType::SOLVE_UPPER, 0, t_s);
       std::vector<std::size_t> col_tiles(1, y.cols());
       auto y_blr = BLRMPI_t::from_ScaLAPACK
@@ -56,7 +56,7 @@ namespace strumpack {
     void release_work_memory() override;
     void build_front(const SpMat_t& A);
 
-    void extend_add();
+    void extend_add(const SPOptions<scalar_t>& opts);
     void extend_add_copy_to_buffers
     (std::vector<std::vector<scalar_t>>& sbuf,
      const FMPI_t* pa) const override;
@@ -27,12 +27,15 @@
  *
  */
 
+#include <numeric>
+
 #include "FrontalMatrixDense.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontalMatrixMPI.hpp"
 #include "FrontalMatrixBLRMPI.hpp"
 #endif
+#include "misc/Trace.hpp"
 
 namespace strumpack {
 
@@ -42,34 +45,204 @@ namespace strumpack {
    std::vector<integer_t>& upd)
     : F_t(nullptr, nullptr, sep, sep_begin, sep_end, upd) {}
 
+  template<typename scalar_t,typename integer_t>
+  FrontalMatrixDense<scalar_t,integer_t>::~FrontalMatrixDense() {
+    release_work_memory();
+    release_factor_memory();
+    release_scatter_map();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::set_factorization_type
+  (FactorizationType t) {
+    if (t == ftype_) return;
+    // the size of factor_mem_ depends on the factorization type, and
+    // so do the offsets in the scatter map
+    release_factor_memory();
+    release_scatter_map();
+    ftype_ = t;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::allocate_factors() {
+    const std::size_t dsep = dim_sep(), dupd = dim_upd(),
+      fsize = factor_size();
+    release_factor_memory();
+    STRUMPACK_ADD_MEMORY(fsize*sizeof(scalar_t));
+    factor_mem_.reset(new scalar_t[fsize]);
+    auto fmem = factor_mem_.get();
+    std::fill(fmem, fmem+fsize, scalar_t(0.));
+    F11_ = DenseMW_t(dsep, dsep, fmem, dsep); fmem += dsep*dsep;
+    if (!symmetric()) {
+      F12_ = DenseMW_t(dsep, dupd, fmem, dsep); fmem += dsep*dupd;
+    }
+    F21_ = DenseMW_t(dupd, dsep, fmem, dupd);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::release_factor_memory() {
+    if (factor_mem_) {
+      STRUMPACK_SUB_MEMORY(factor_size()*sizeof(scalar_t));
+      factor_mem_.reset();
+    }
+    F11_.clear();
+    F12_.clear();
+    F21_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::release_scatter_map() {
+    if (sc_nnz_ != -1) {
+      STRUMPACK_SUB_MEMORY(sc_nz_.size()*(sizeof(integer_t)+
+                                          sizeof(std::size_t)));
+      sc_nz_ = std::vector<integer_t>();
+      sc_off_ = std::vector<std::size_t>();
+      sc_nnz_ = -1;
+    }
+  }
+
+  // Copy the elements of the sparse matrix A into F11_, F12_ and
+  // F21_, which are assumed to be zero. The first call stores, for
+  // each element, its position in A and in factor_mem_. Subsequent
+  // calls (refactorization with the same sparsity pattern) only do a
+  // gather, which, unlike extract_front, can be done in parallel.
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::assemble_front
+  (const SpMat_t& A, int task_depth) {
+    if (sc_nnz_ != A.nnz()) {
+      release_scatter_map();
+      using Trip_t = Triplet<integer_t,integer_t>;
+      std::vector<Trip_t> e11, e12, e21;
+      if (!A.push_front_positions
+          (this->sep_begin_, this->sep_end_, this->upd_, e11, e12, e21)) {
+        A.extract_front
+          (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+           this->upd_, task_depth);
+        return;
+      }
+      if (symmetric()) e12.clear(); // F12 is not stored
+      const auto n = e11.size() + e12.size() + e21.size();
+      STRUMPACK_ADD_MEMORY(n*(sizeof(integer_t)+sizeof(std::size_t)));
+      sc_nz_.reserve(n);
+      sc_off_.reserve(n);
+      auto fmem = factor_mem_.get();
+      auto add = [&](const std::vector<Trip_t>& e, DenseMW_t& F) {
+        for (auto& t : e) {
+          sc_nz_.push_back(t.v);
+          sc_off_.push_back(&F(t.r, t.c) - fmem);
+        }
+      };
+      add(e11, F11_);
+      add(e12, F12_);
+      add(e21, F21_);
+      sc_nnz_ = A.nnz();
+    }
+    const auto n = sc_nz_.size();
+    const auto val = A.val();
+    const auto nz = sc_nz_.data();
+    const auto off = sc_off_.data();
+    auto fmem = factor_mem_.get();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t k=0; k<n; k++)
+      fmem[off[k]] = val[nz[k]];
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::allocate_CB
+  (CBWorkspace<scalar_t>* ws) {
+    const std::size_t dupd = dim_upd();
+    if (!dupd) return;
+    scalar_t* CB = ws ? ws->push(dupd*dupd) : nullptr;
+    if (CB) CB_ws_ = ws;
+    else {
+      // not running on a CB stack, or the stack is full
+      STRUMPACK_ADD_MEMORY(dupd*dupd*sizeof(scalar_t));
+      CB_mem_.reset(new scalar_t[dupd*dupd]);
+      CB = CB_mem_.get();
+    }
+    F22_ = DenseMW_t(dupd, dupd, CB, dupd);
+    F22_.zero();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::release_work_memory() {
+    if (CB_mem_) {
+      STRUMPACK_SUB_MEMORY(dim_upd()*dim_upd()*sizeof(scalar_t));
+      CB_mem_.reset();
+    } else if (CB_ws_) {
+      CB_ws_->pop(F22_.data());
+      CB_ws_ = nullptr;
+    }
+    F22_.clear();
+  }
+
+  template<typename scalar_t,typename integer_t>
+  const std::vector<typename FrontalMatrixDense<scalar_t,integer_t>::RelIdxRun>&
+  FrontalMatrixDense<scalar_t,integer_t>::relative_index_runs
+  (const F_t* pa) {
+    const std::size_t dupd = dim_upd();
+    if (rel_runs_.empty() && dupd) {
+      std::size_t upd2sep;
+      auto I = this->upd_to_parent(pa, upd2sep);
+      for (std::size_t r=0; r<dupd; r++) {
+        if (r && r != upd2sep && I[r] == I[r-1]+1)
+          rel_runs_.back().n++;
+        else rel_runs_.push_back({r, I[r], 1});
+      }
+      rel_runs_.shrink_to_fit();
+    }
+    return rel_runs_;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
    const F_t* p, int task_depth) {
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
-    std::size_t upd2sep;
-    auto I = this->upd_to_parent(p, upd2sep);
+    const auto& runs = relative_index_runs(p);
+    const bool sym = symmetric();
+    const std::size_t B = 64;
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
-#pragma omp taskloop default(shared) grainsize(64)      \
+#pragma omp taskloop default(shared) grainsize(1)       \
   if(task_depth < params::task_recursion_cutoff_level)
 #endif
-    for (std::size_t c=0; c<dupd; c++) {
-      auto pc = I[c];
-      if (pc < pdsep) {
-        for (std::size_t r=0; r<upd2sep; r++)
-          paF11(I[r],pc) += F22_(r,c);
-        for (std::size_t r=upd2sep; r<dupd; r++)
-          paF21(I[r]-pdsep,pc) += F22_(r,c);
-      } else {
-        for (std::size_t r=0; r<upd2sep; r++)
-          paF12(I[r],pc-pdsep) += F22_(r, c);
-        for (std::size_t r=upd2sep; r<dupd; r++)
-          paF22(I[r]-pdsep,pc-pdsep) += F22_(r,c);
+    for (std::size_t cb=0; cb<dupd; cb+=B) {
+      // run containing column cb
+      std::size_t k = std::upper_bound
+        (runs.begin(), runs.end(), cb,
+         [](std::size_t c, const RelIdxRun& run) { return c < run.c; })
+        - runs.begin() - 1;
+      for (std::size_t c=cb, ce=std::min(cb+B, dupd); c<ce; c++) {
+        while (c >= runs[k].c + runs[k].n) k++;
+        const auto pc = runs[k].p + c - runs[k].c;
+        // the indices are sorted, so the lower triangle of the CB maps
+        // to the lower triangles of paF11 and paF22, and to paF21
+        const std::size_t r0 = sym ? c : 0;
+        for (auto j=(sym ? k : 0); j<runs.size(); j++) {
+          const auto rb = std::max(runs[j].c, r0),
+            re = runs[j].c + runs[j].n;
+          if (rb >= re) continue;
+          const auto pr = runs[j].p + rb - runs[j].c;
+          scalar_t* d;
+          if (pc < pdsep)
+            d = (pr < pdsep) ? &paF11(pr, pc) : &paF21(pr-pdsep, pc);
+          else
+            d = (pr < pdsep) ? &paF12(pr, pc-pdsep) :
+              &paF22(pr-pdsep, pc-pdsep);
+          const auto s = &F22_(rb, c);
+          for (std::size_t i=0; i<re-rb; i++)
+            d[i] += s[i];
+        }
       }
     }
-    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
-    STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * dupd);
+    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) *
+                    (sym ? dupd * (dupd + 1) / 2 : dupd * dupd));
+    STRUMPACK_FULL_RANK_FLOPS((is_complex<scalar_t>()?2:1) *
+                              (sym ? dupd * (dupd + 1) / 2 : dupd * dupd));
     release_work_memory();
   }
 
@@ -77,6 +250,17 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
+    if (opts.level_batching() &&
+        opts.factorization_type() == FactorizationType::LU &&
+        level_batchable(opts.level_batching_max_size())) {
+      if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+        factor_level_batched(A, opts, etree_level, task_depth);
+      } else
+        factor_level_batched(A, opts, etree_level, task_depth);
+      return;
+    }
     if (task_depth == 0) {
       // use tasking for children and for extend-add parallelism
 #pragma omp parallel if(!omp_in_parallel()) default(shared)
@@ -95,6 +279,21 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::factor_phase1
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
+    // Below the task cutoff level the subtree is traversed
+    // sequentially, by a single thread. The first front to get there
+    // allocates the CB stack for the entire subtree, and keeps its own
+    // CB out of that stack, since it is consumed by the parent,
+    // possibly on a different thread.
+    CBWorkspace<scalar_t>* ws = nullptr;
+    bool ws_root = false;
+    if (task_depth >= params::task_recursion_cutoff_level) {
+      ws = &CBWorkspace<scalar_t>::thread_workspace();
+      if (!ws->active()) {
+        // the CB of this front is not on the stack
+        ws->activate(this->CB_stack_peak(false));
+        ws_root = true;
+      }
+    }
     if (task_depth < params::task_recursion_cutoff_level) {
       if (lchild_)
 #pragma omp task default(shared)                                        \
@@ -108,43 +307,168 @@ namespace strumpack {
           (A, opts, etree_level+1, task_depth+1);
 #pragma omp taskwait
     } else {
+      // in the order which minimizes the peak of the CB stack
+      auto ch0 = this->rchild_first_ ? rchild_.get() : lchild_.get();
+      auto ch1 = this->rchild_first_ ? lchild_.get() : rchild_.get();
+      if (ch0)
+        ch0->multifrontal_factorization(A, opts, etree_level+1, task_depth);
+      if (ch1)
+        ch1->multifrontal_factorization(A, opts, etree_level+1, task_depth);
+    }
+    set_factorization_type(opts.factorization_type());
+    allocate_factors();
+    {
+      trace::Region tr(trace::Event::ASSEMBLY, *this, etree_level);
+      assemble_front(A, task_depth);
+    }
+    allocate_CB(ws_root ? nullptr : ws);
+    {
+      trace::Region tr(trace::Event::EXTEND_ADD, *this, etree_level);
       if (lchild_)
-        lchild_->multifrontal_factorization
-          (A, opts, etree_level+1, task_depth);
+        lchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
       if (rchild_)
-        rchild_->multifrontal_factorization
-          (A, opts, etree_level+1, task_depth);
-    }
-    // TODO can we allocate the memory in one go??
-    const auto dsep = dim_sep();
-    const auto dupd = dim_upd();
-    F11_ = DenseM_t(dsep, dsep); F11_.zero();
-    F12_ = DenseM_t(dsep, dupd); F12_.zero();
-    F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
-    if (dupd) {
-      F22_ = DenseM_t(dupd, dupd);
-      F22_.zero();
-    }
-    if (lchild_)
-      lchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, task_depth);
-    if (rchild_)
-      rchild_->extend_add_to_dense
-        (F11_, F12_, F21_, F22_, this, task_depth);
+        rchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+    }
+    if (CB_ws_) {
+      // the children's CBs have been released, move this CB down
+      const std::size_t dupd = dim_upd();
+      F22_ = DenseMW_t(dupd, dupd, CB_ws_->compact(F22_.data()), dupd);
+    }
+    if (ws_root) ws->deactivate();
     if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
   }
 
+  /**
+   * Schur complement update of only the lower triangular part of
+   * F22, F22 = F22 - F21 * op(B), with op(B) = F21^H (Cholesky) or
+   * op(B) = F11^{-1} F21^T (LDLt). This is done per block of nb
+   * columns, so roughly half the flops of a full gemm are required.
+   */
+  template<typename scalar_t> void
+  lower_Schur_update(const DenseMatrix<scalar_t>& F21, Trans op,
+                     const DenseMatrix<scalar_t>& B,
+                     DenseMatrix<scalar_t>& F22, int task_depth) {
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const std::size_t n = F22.rows(), k = F21.cols(), nb = 128;
+    auto& F21nc = const_cast<DenseMatrix<scalar_t>&>(F21);
+    auto& Bnc = const_cast<DenseMatrix<scalar_t>&>(B);
+    for (std::size_t c=0; c<n; c+=nb) {
+      const std::size_t w = std::min(nb, n-c);
+      DenseMW_t F22c(n-c, w, F22, c, c), F21c(n-c, k, F21nc, c, 0),
+        Bc = (op == Trans::N) ? DenseMW_t(k, w, Bnc, 0, c) :
+        DenseMW_t(w, k, Bnc, c, 0);
+      gemm(Trans::N, op, scalar_t(-1.), F21c, Bc,
+           scalar_t(1.), F22c, task_depth);
+      STRUMPACK_FULL_RANK_FLOPS
+        (gemm_flops(Trans::N, op, scalar_t(-1.), F21c, Bc, scalar_t(1.)));
+    }
+  }
+
+  /**
+   * LU factorization without pivoting, used with static pivoting,
+   * see FrontPivoting. This splits A recursively in 2 x 2 blocks,
+   * such that most of the work is done in trsm and gemm, which are
+   * tasked or use threaded BLAS, unlike the sequential panel pivot
+   * search in getrf. Pivots with magnitude below thresh are replaced
+   * by +-thresh when replace is set. Otherwise, as in getrf, a zero
+   * pivot is only reported: the return value is the (1-based) index
+   * of the first zero pivot, or 0, and the elimination of that
+   * column is skipped.
+   */
+  template<typename scalar_t> int
+  LU_no_pivoting(DenseMatrix<scalar_t>& A,
+                 typename RealType<scalar_t>::value_type thresh,
+                 bool replace, int task_depth) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    const int n = A.rows();
+    int info = 0;
+    if (n <= 32) {
+      for (int k=0; k<n; k++) {
+        auto& Akk = A(k,k);
+        if (replace && std::abs(Akk) < thresh)
+          Akk = (std::real(Akk) < real_t(0.)) ? -thresh : thresh;
+        if (Akk == scalar_t(0.)) {
+          if (!info) info = k + 1;
+          continue;
+        }
+        const scalar_t iAkk = scalar_t(1.) / Akk;
+        for (int i=k+1; i<n; i++)
+          A(i,k) *= iAkk;
+        for (int j=k+1; j<n; j++) {
+          const scalar_t Akj = A(k,j);
+          for (int i=k+1; i<n; i++)
+            A(i,j) -= A(i,k) * Akj;
+        }
+      }
+      return info;
+    }
+    const int n1 = n / 2, n2 = n - n1;
+    DenseMW_t A11(n1, n1, A, 0, 0), A12(n1, n2, A, 0, n1),
+      A21(n2, n1, A, n1, 0), A22(n2, n2, A, n1, n1);
+    info = LU_no_pivoting(A11, thresh, replace, task_depth);
+    trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+         scalar_t(1.), A11, A12, task_depth);
+    trsm(Side::R, UpLo::U, Trans::N, Diag::N,
+         scalar_t(1.), A11, A21, task_depth);
+    gemm(Trans::N, Trans::N, scalar_t(-1.), A21, A12,
+         scalar_t(1.), A22, task_depth);
+    auto info2 = LU_no_pivoting(A22, thresh, replace, task_depth);
+    if (!info && info2) info = n1 + info2;
+    return info;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::factor_phase2
   (const SpMat_t& A, const SPOptions<scalar_t>& opts,
    int etree_level, int task_depth) {
+    trace::Region tr(trace::Event::FACTOR, *this, etree_level);
+    if (dim_sep() && symmetric()) {
+      if (ftype_ == FactorizationType::CHOLESKY) {
+        // F11 = L L^H, F21 = F21 L^-H, F22 = F22 - F21 F21^H
+        F11_.Cholesky(task_depth);
+        STRUMPACK_FULL_RANK_FLOPS(blas::potrf_flops(dim_sep()));
+        if (dim_upd()) {
+          trsm(Side::R, UpLo::L, Trans::C, Diag::N,
+               scalar_t(1.), F11_, F21_, task_depth);
+          STRUMPACK_FULL_RANK_FLOPS
+            (trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
+          lower_Schur_update(F21_, Trans::C, F21_, F22_, task_depth);
+        }
+      } else {
+        // F11 = P L D L^T P^T, F21 is kept, F22 = F22 - F21 F11^-1 F21^T
+        piv = F11_.LDLt(task_depth);
+        STRUMPACK_FULL_RANK_FLOPS(blas::sytrf_flops(dim_sep()));
+        if (dim_upd()) {
+          DenseM_t W(dim_sep(), dim_upd());
+          for (std::size_t j=0; j<W.cols(); j++)
+            for (std::size_t i=0; i<W.rows(); i++)
+              W(i,j) = F21_(j,i);
+          F11_.solve_LDLt_in_place(W, piv, task_depth);
+          STRUMPACK_FULL_RANK_FLOPS
+            (blas::sytrs_flops(dim_sep(), dim_sep(), dim_upd()));
+          lower_Schur_update(F21_, Trans::N, W, F22_, task_depth);
+        }
+      }
+      return;
+    }
     if (dim_sep()) {
       // TaskTimer t("FrontalMatrixDense_factor");
       // if (etree_level == 0 && opts.print_root_front_stats()) t.start();
-      int info = F11_.LU(piv, task_depth);
+      int info = 0;
+      if (static_pivoting(opts)) {
+        // no pivot search, either no pivoting at all, or the pivot
+        // sequence from the previous factorization
+        if (opts.front_pivoting() == FrontPivoting::NONE) {
+          piv.resize(dim_sep());
+          std::iota(piv.begin(), piv.end(), 1);
+        } else F11_.laswp(piv, true);
+        info = LU_no_pivoting
+          (F11_, opts.pivot_threshold(), opts.replace_tiny_pivots(),
+           task_depth);
+      } else info = F11_.LU(piv, task_depth);
       if (info || opts.replace_tiny_pivots()) {
         auto thresh = opts.pivot_threshold();
         for (std::size_t i=0; i<F11_.rows(); i++)
@@ -174,28 +498,269 @@ namespace strumpack {
        trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixDense<scalar_t,integer_t>::static_pivoting
+  (const SPOptions<scalar_t>& opts) const {
+    switch (opts.front_pivoting()) {
+    case FrontPivoting::NONE: return true;
+    case FrontPivoting::REUSE:
+      // the first factorization uses partial pivoting
+      return piv.size() == std::size_t(dim_sep());
+    default: return false;
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixDense<scalar_t,integer_t>::level_batchable(int max_size) const {
+    if (dim_blk() > max_size) return false;
+    // only plain dense fronts, no derived types such as lossy fronts
+    auto batchable = [max_size](const F_t* ch) {
+      if (!ch) return true;
+      if (typeid(*ch) != typeid(FrontalMatrixDense<scalar_t,integer_t>))
+        return false;
+      return static_cast<const FrontalMatrixDense<scalar_t,integer_t>*>
+        (ch)->level_batchable(max_size);
+    };
+    return batchable(lchild_.get()) && batchable(rchild_.get());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::factor_level_batched
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts,
+   int etree_level, int task_depth) {
+    using FD_t = FrontalMatrixDense<scalar_t,integer_t>;
+    const int lvls = this->levels();
+    std::unique_ptr<scalar_t[]> CB, old_CB;
+    std::size_t CB_size = 0;
+    for (int l=lvls-1; l>=0; l--) {
+      std::vector<F_t*> fp;
+      this->get_level_fronts(fp, l);
+      const std::size_t nf = fp.size();
+      if (l > 0) {
+        // all contribution blocks of this level in a single
+        // allocation, which is released after the next level up
+        CB_size = 0;
+        for (auto f : fp)
+          CB_size += std::size_t(f->dim_upd()) * f->dim_upd();
+        STRUMPACK_ADD_MEMORY(CB_size*sizeof(scalar_t));
+        CB.reset(new scalar_t[CB_size]);
+        std::fill(CB.get(), CB.get()+CB_size, scalar_t(0.));
+        auto pCB = CB.get();
+        for (auto f : fp) {
+          const std::size_t dupd = f->dim_upd();
+          static_cast<FD_t*>(f)->F22_ = DenseMW_t(dupd, dupd, pCB, dupd);
+          pCB += dupd*dupd;
+        }
+      } else {
+        // the root of the batch passes its CB on to the parent
+        CB_size = 0;
+        allocate_CB(nullptr);
+      }
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)                    \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+      for (std::size_t f=0; f<nf; f++)
+        static_cast<FD_t*>(fp[f])->factor_small_front
+          (A, opts, etree_level+l);
+      // the CBs of the level below, the children of this level, are
+      // released
+      STRUMPACK_SUB_MEMORY
+        (std::accumulate
+         (fp.begin(), fp.end(), std::size_t(0), [](std::size_t s, F_t* f) {
+           for (auto ch : {f->lchild(), f->rchild()})
+             if (ch) s += std::size_t(ch->dim_upd()) * ch->dim_upd();
+           return s; }) * sizeof(scalar_t));
+      old_CB = std::move(CB);
+    }
+  }
+
+  /**
+   * Partial LU factorization, with row pivoting restricted to F11, of
+   * a front [F11 F12; F21 F22] with dimension n1+n2 <= NT. On exit
+   * this contains the same factors as getrf(F11) followed by the two
+   * triangular solves and the Schur complement update, as in
+   * factor_phase2. The front is first copied to a local NT x NT
+   * array, such that all loops have a fixed leading dimension.
+   * Pivots with magnitude below thresh are replaced by +-thresh when
+   * replace_tiny_pivots is set. Otherwise, on a zero pivot, this
+   * returns its (1-based) index, and the front is not modified, so it
+   * can be factored with factor_phase2 instead, which handles this
+   * the same way as the other fronts.
+   */
+  template<typename scalar_t, int NT> int
+  LU_small_front(DenseMatrix<scalar_t>& F11, DenseMatrix<scalar_t>& F12,
+                 DenseMatrix<scalar_t>& F21, DenseMatrix<scalar_t>& F22,
+                 int* piv, typename RealType<scalar_t>::value_type thresh,
+                 bool replace_tiny_pivots, bool pivot_search) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    const int n1 = F11.rows(), n2 = F22.rows(), n = n1 + n2;
+    assert(n <= NT);
+    scalar_t M[NT*NT];
+    for (int j=0; j<n1; j++) {
+      for (int i=0; i<n1; i++) M[i+j*NT] = F11(i,j);
+      for (int i=0; i<n2; i++) M[n1+i+j*NT] = F21(i,j);
+    }
+    for (int j=0; j<n2; j++) {
+      for (int i=0; i<n1; i++) M[i+(n1+j)*NT] = F12(i,j);
+      for (int i=0; i<n2; i++) M[n1+i+(n1+j)*NT] = F22(i,j);
+    }
+    for (int k=0; k<n1; k++) {
+      int p = k;
+      real_t Mmax = std::abs(M[k+k*NT]);
+      if (pivot_search) {
+        for (int i=k+1; i<n1; i++) {
+          auto Mik = std::abs(M[i+k*NT]);
+          if (Mik > Mmax) { Mmax = Mik; p = i; }
+        }
+        piv[k] = p + 1;
+      } else {
+        p = piv[k] - 1;
+        Mmax = std::abs(M[p+k*NT]);
+      }
+      if (p != k)
+        for (int j=0; j<n; j++)
+          std::swap(M[k+j*NT], M[p+j*NT]);
+      auto& Mkk = M[k+k*NT];
+      if (replace_tiny_pivots && std::abs(Mkk) < thresh)
+        Mkk = (std::real(Mkk) < 0) ? -thresh : thresh;
+      if (Mkk == scalar_t(0.)) return k + 1;
+      const scalar_t iMkk = scalar_t(1.) / Mkk;
+      for (int i=k+1; i<n; i++)
+        M[i+k*NT] *= iMkk;
+      for (int j=k+1; j<n; j++) {
+        const scalar_t Mkj = M[k+j*NT];
+        for (int i=k+1; i<n; i++)
+          M[i+j*NT] -= M[i+k*NT] * Mkj;
+      }
+    }
+    for (int j=0; j<n1; j++) {
+      for (int i=0; i<n1; i++) F11(i,j) = M[i+j*NT];
+      for (int i=0; i<n2; i++) F21(i,j) = M[n1+i+j*NT];
+    }
+    for (int j=0; j<n2; j++) {
+      for (int i=0; i<n1; i++) F12(i,j) = M[i+(n1+j)*NT];
+      for (int i=0; i<n2; i++) F22(i,j) = M[n1+i+(n1+j)*NT];
+    }
+    return 0;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::factor_small_front
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts, int etree_level) {
+    // no tasking, this is called for many fronts in parallel
+    const int task_depth = params::task_recursion_cutoff_level;
+    set_factorization_type(FactorizationType::LU);
+    allocate_factors();
+    {
+      trace::Region tr(trace::Event::ASSEMBLY, *this, etree_level);
+      assemble_front(A, task_depth);
+    }
+    {
+      trace::Region tr(trace::Event::EXTEND_ADD, *this, etree_level);
+      if (lchild_)
+        lchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+      if (rchild_)
+        rchild_->extend_add_to_dense
+          (F11_, F12_, F21_, F22_, this, task_depth);
+    }
+    const int dsep = dim_sep(), n = dim_blk();
+    if (!dsep) return;
+    // the small front kernel is instantiated up to dimension 64,
+    // larger fronts (with a larger level_batching_max_size) use BLAS
+    if (n > std::min(opts.level_batching_max_size(), 64)) {
+      factor_phase2(A, opts, etree_level, task_depth);
+      return;
+    }
+    int info = 0;
+    {
+      trace::Region tr(trace::Event::FACTOR, *this, etree_level);
+      // with static pivoting, piv is the given pivot sequence
+      const bool ps = !static_pivoting(opts);
+      if (ps) piv.resize(dsep);
+      else if (opts.front_pivoting() == FrontPivoting::NONE) {
+        piv.resize(dsep);
+        std::iota(piv.begin(), piv.end(), 1);
+      }
+      auto thresh = opts.pivot_threshold();
+      auto rtp = opts.replace_tiny_pivots();
+      if (n <= 8)
+        info = LU_small_front<scalar_t,8>
+          (F11_, F12_, F21_, F22_, piv.data(), thresh, rtp, ps);
+      else if (n <= 16)
+        info = LU_small_front<scalar_t,16>
+          (F11_, F12_, F21_, F22_, piv.data(), thresh, rtp, ps);
+      else if (n <= 32)
+        info = LU_small_front<scalar_t,32>
+          (F11_, F12_, F21_, F22_, piv.data(), thresh, rtp, ps);
+      else if (n <= 48)
+        info = LU_small_front<scalar_t,48>
+          (F11_, F12_, F21_, F22_, piv.data(), thresh, rtp, ps);
+      else
+        info = LU_small_front<scalar_t,64>
+          (F11_, F12_, F21_, F22_, piv.data(), thresh, rtp, ps);
+    }
+    if (info) {
+      // zero pivot, the front was not modified
+      factor_phase2(A, opts, etree_level, task_depth);
+      return;
+    }
+#if defined(STRUMPACK_COUNT_FLOPS)
+    auto f = LU_flops(F11_) +
+      gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
+      trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
+      trsm_flops(Side::R, scalar_t(1.), F11_, F21_);
+    STRUMPACK_FLOPS(f);
+    STRUMPACK_FULL_RANK_FLOPS(f);
+#endif
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
     if (task_depth == 0) {
       // tasking when calling the children
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
-      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
       // no tasking for the root node computations, use system blas threading!
-      fwd_solve_phase2(b, bupd, etree_level, params::task_recursion_cutoff_level);
+      fwd_solve_phase2
+        (b, bupd, etree_level, params::task_recursion_cutoff_level, op);
     } else {
-      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
-      fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
+      fwd_solve_phase2(b, bupd, etree_level, task_depth, op);
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::fwd_solve_phase2
-  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
-    if (dim_sep()) {
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth,
+   Trans op) const {
+    trace::Region tr(trace::Event::FORWARD_SOLVE, *this, etree_level);
+    // for the symmetric factorizations, the solver maps A^T and A^H
+    // to A or conj(A), so op is only used with LU
+    if (dim_sep() && symmetric()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      if (ftype_ == FactorizationType::CHOLESKY)
+        trsm(Side::L, UpLo::L, Trans::N, Diag::N,
+             scalar_t(1.), F11_, bloc, task_depth);
+      else F11_.solve_LDLt_in_place(bloc, piv, task_depth);
+      if (dim_upd())
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+    } else if (dim_sep() && op != Trans::N) {
+      // A^T = U^T L^T P, the forward sweep solves with U^T
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      trsm(Side::L, UpLo::U, op, Diag::N,
+           scalar_t(1.), F11_, bloc, task_depth);
+      if (dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F12_, bloc,
+             scalar_t(1.), bupd, task_depth);
+    } else if (dim_sep()) {
       DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(piv, true);
       if (b.cols() == 1) {
@@ -215,26 +780,54 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
       bwd_solve_phase1
-        (y, yupd, etree_level, params::task_recursion_cutoff_level);
+        (y, yupd, etree_level, params::task_recursion_cutoff_level, op);
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       // tasking when calling children
-      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
     } else {
-      bwd_solve_phase1(y, yupd, etree_level, task_depth);
-      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
+      bwd_solve_phase1(y, yupd, etree_level, task_depth, op);
+      this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
     }
   }
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::bwd_solve_phase1
-  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
-    if (dim_sep()) {
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth,
+   Trans op) const {
+    trace::Region tr(trace::Event::BACKWARD_SOLVE, *this, etree_level);
+    if (dim_sep() && symmetric()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (ftype_ == FactorizationType::CHOLESKY) {
+        if (dim_upd())
+          gemm(Trans::C, Trans::N, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
+        trsm(Side::L, UpLo::L, Trans::C, Diag::N, scalar_t(1.),
+             F11_, yloc, task_depth);
+      } else if (dim_upd()) {
+        // the forward solve already applied F11^-1 to yloc
+        DenseM_t t(dim_sep(), y.cols());
+        gemm(Trans::T, Trans::N, scalar_t(1.), F21_, yupd,
+             scalar_t(0.), t, task_depth);
+        F11_.solve_LDLt_in_place(t, piv, task_depth);
+        yloc.scaled_add(scalar_t(-1.), t, task_depth);
+      }
+    } else if (dim_sep() && op != Trans::N) {
+      // backward sweep with L^T, followed by the row permutation P^T
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F21_, yupd,
+             scalar_t(1.), yloc, task_depth);
+      trsm(Side::L, UpLo::L, op, Diag::U, scalar_t(1.),
+           F11_, yloc, task_depth);
+      yloc.laswp(piv, false);
+    } else if (dim_sep()) {
       DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
       if (y.cols() == 1) {
         if (dim_upd())
@@ -319,7 +912,7 @@ namespace strumpack {
       for (std::size_t r=0; r<u2s; r++)
         cR(r,c) = R(Ir[r],c);
     DenseM_t cS(u2s, Rcols);
-    DenseMW_t CB11(u2s, u2s, const_cast<DenseM_t&>(F22_), 0, 0);
+    DenseMW_t CB11(u2s, u2s, const_cast<DenseMW_t&>(F22_), 0, 0);
     gemm(op, Trans::N, scalar_t(1.), CB11, cR, scalar_t(0.), cS, task_depth);
     for (std::size_t c=0; c<Rcols; c++)
       for (std::size_t r=0; r<u2s; r++)
@@ -336,7 +929,7 @@ namespace strumpack {
     auto Ir = this->upd_to_parent(pa, u2s);
     auto pds = pa->dim_sep();
     auto Rcols = R.cols();
-    DenseMW_t CB12(u2s, dupd-u2s, const_cast<DenseM_t&>(F22_), 0, u2s);
+    DenseMW_t CB12(u2s, dupd-u2s, const_cast<DenseMW_t&>(F22_), 0, u2s);
     if (op == Trans::N) {
       DenseM_t cR(dupd-u2s, Rcols);
       for (std::size_t c=0; c<Rcols; c++)
@@ -371,7 +964,7 @@ namespace strumpack {
     auto Ir = this->upd_to_parent(pa, u2s);
     auto Rcols = R.cols();
     auto pds = pa->dim_sep();
-    DenseMW_t CB21(dupd-u2s, u2s, const_cast<DenseM_t&>(F22_), u2s, 0);
+    DenseMW_t CB21(dupd-u2s, u2s, const_cast<DenseMW_t&>(F22_), u2s, 0);
     if (op == Trans::N) {
       DenseM_t cR(u2s, Rcols);
       for (std::size_t c=0; c<Rcols; c++)
@@ -411,7 +1004,7 @@ namespace strumpack {
       for (std::size_t r=u2s; r<dupd; r++)
         cR(r-u2s,c) = R(Ir[r]-pds,c);
     DenseM_t cS(dupd-u2s, Rcols);
-    DenseMW_t CB22(dupd-u2s, dupd-u2s, const_cast<DenseM_t&>(F22_), u2s, u2s);
+    DenseMW_t CB22(dupd-u2s, dupd-u2s, const_cast<DenseMW_t&>(F22_), u2s, u2s);
     gemm(op, Trans::N, scalar_t(1.), CB22, cR, scalar_t(0.), cS, task_depth);
     for (std::size_t c=0; c<Rcols; c++)
       for (std::size_t r=u2s; r<dupd; r++)
@@ -423,13 +1016,57 @@ namespace strumpack {
   FrontalMatrixDense<scalar_t,integer_t>::delete_factors() {
     if (lchild_) lchild_->delete_factors();
     if (rchild_) rchild_->delete_factors();
-    F11_ = DenseM_t();
-    F12_ = DenseM_t();
-    F21_ = DenseM_t();
-    F22_ = DenseM_t();
+    release_factor_memory();
+    release_work_memory();
     piv = std::vector<int>();
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixDense<scalar_t,integer_t>::write_factors
+  (std::ofstream& os) const {
+    io::write_binary(os, int(ftype_));
+    io::write_binary(os, piv);
+    // F11, F12 and F21 as one aligned block, as in factor_mem_
+    io::align(os);
+    for (std::size_t j=0; j<F11_.cols(); j++)
+      os.write((const char*)F11_.ptr(0, j), F11_.rows()*sizeof(scalar_t));
+    for (std::size_t j=0; j<F12_.cols(); j++)
+      os.write((const char*)F12_.ptr(0, j), F12_.rows()*sizeof(scalar_t));
+    for (std::size_t j=0; j<F21_.cols(); j++)
+      os.write((const char*)F21_.ptr(0, j), F21_.rows()*sizeof(scalar_t));
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixDense<scalar_t,integer_t>::read_factors
+  (std::ifstream& is, io::MappedFile* f) {
+    int ftype = 0;
+    io::read_binary(is, ftype);
+    set_factorization_type(FactorizationType(ftype));
+    io::read_binary(is, piv);
+    io::align(is);
+    const std::size_t dsep = dim_sep(), dupd = dim_upd(),
+      fbytes = factor_size()*sizeof(scalar_t);
+    auto fmem = f ? f->data<scalar_t>(is.tellg(), fbytes) : nullptr;
+    if (!fmem) {
+      if (!is || fbytes > io::remaining(is)) {
+        is.setstate(std::ios::failbit);
+        return;
+      }
+      allocate_factors();
+      is.read((char*)factor_mem_.get(), fbytes);
+      return;
+    }
+    // use the factors in place, pages are only read when accessed
+    release_factor_memory();
+    F11_ = DenseMW_t(dsep, dsep, fmem, dsep); fmem += dsep*dsep;
+    if (!symmetric()) {
+      F12_ = DenseMW_t(dsep, dupd, fmem, dsep); fmem += dsep*dupd;
+    }
+    F21_ = DenseMW_t(dupd, dsep, fmem, dupd);
+    is.seekg(fbytes, std::ios::cur);
+  }
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDense<scalar_t,integer_t>::extend_add_copy_to_buffers
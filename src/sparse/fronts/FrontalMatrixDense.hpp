@@ -36,6 +36,7 @@
 #include <random>
 
 #include "FrontalMatrix.hpp"
+#include "CBWorkspace.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "FrontalMatrixBLRMPI.hpp"
 #endif
@@ -55,8 +56,9 @@ namespace strumpack {
     FrontalMatrixDense
     (integer_t sep, integer_t sep_begin, integer_t sep_end,
      std::vector<integer_t>& upd);
+    ~FrontalMatrixDense();
 
-    void release_work_memory() override { F22_.clear(); }
+    void release_work_memory() override;
     void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
                              DenseM_t& paF21, DenseM_t& paF22,
                              const F_t* p, int task_depth) override;
@@ -83,10 +85,12 @@ namespace strumpack {
 
     void
     forward_multifrontal_solve(DenseM_t& b, DenseM_t* work, int etree_level=0,
-                               int task_depth=0) const override;
+                               int task_depth=0,
+                               Trans op=Trans::N) const override;
     void
     backward_multifrontal_solve(DenseM_t& y, DenseM_t* work, int etree_level=0,
-                                int task_depth=0) const override;
+                                int task_depth=0,
+                                Trans op=Trans::N) const override;
 
     void
     extract_CB_sub_matrix(const std::vector<std::size_t>& I,
@@ -95,6 +99,9 @@ namespace strumpack {
 
     void delete_factors() override;
 
+    bool write_factors(std::ofstream& os) const override;
+    void read_factors(std::ifstream& is, io::MappedFile* f) override;
+
     std::string type() const override { return "FrontalMatrixDense"; }
 
 #if defined(STRUMPACK_USE_MPI)
@@ -109,8 +116,34 @@ namespace strumpack {
 #endif
 
   protected:
-    DenseM_t F11_, F12_, F21_, F22_;
+    // F11_, F12_ and F21_ are stored in a single allocation,
+    // factor_mem_. F22_ is either taken from the (thread local)
+    // contribution block stack, or stored in CB_mem_. For the
+    // symmetric factorizations, F12_ is empty and only the lower
+    // triangular parts of F11_ and F22_ are referenced.
+    std::unique_ptr<scalar_t[]> factor_mem_, CB_mem_;
+    CBWorkspace<scalar_t>* CB_ws_ = nullptr;
+    DenseMW_t F11_, F12_, F21_, F22_;
     std::vector<int> piv; // regular int because it is passed to BLAS
+    FactorizationType ftype_ = FactorizationType::LU;
+
+    // Scatter map for the assembly of the sparse matrix elements in
+    // the front: element k goes from A.val()[sc_nz_[k]] to
+    // factor_mem_[sc_off_[k]]. Built on the first factorization and
+    // reused as long as the number of nonzeros of A is unchanged.
+    std::vector<integer_t> sc_nz_;
+    std::vector<std::size_t> sc_off_;
+    integer_t sc_nnz_ = -1;
+
+    // Relative indices of the CB in the parent front, run length
+    // encoded: CB rows/columns [c, c+n) map to rows/columns [p, p+n)
+    // of the parent, numbered as [F11 F12; F21 F22]. Runs do not
+    // cross the separator/update boundary of the parent. The front
+    // structure is fixed, so this is computed on the first
+    // extend-add and reused by later factorizations.
+    struct RelIdxRun { std::size_t c, p, n; };
+    std::vector<RelIdxRun> rel_runs_;
+    const std::vector<RelIdxRun>& relative_index_runs(const F_t* pa);
 
     FrontalMatrixDense(const FrontalMatrixDense&) = delete;
     FrontalMatrixDense& operator=(FrontalMatrixDense const&) = delete;
@@ -120,17 +153,46 @@ namespace strumpack {
     void factor_phase2(const SpMat_t& A, const SPOptions<scalar_t>& opts,
                        int etree_level, int task_depth);
 
+    bool symmetric() const { return ftype_ != FactorizationType::LU; }
+    /**
+     * Whether the LU factorization of F11 skips the pivot search,
+     * see FrontPivoting.
+     */
+    bool static_pivoting(const SPOptions<scalar_t>& opts) const;
+    std::size_t factor_size() const {
+      return dim_sep() * (dim_sep() + (symmetric() ? 1 : 2) * dim_upd());
+    }
+    void set_factorization_type(FactorizationType t);
+    void allocate_factors();
+    void release_factor_memory();
+    void allocate_CB(CBWorkspace<scalar_t>* ws);
+    void assemble_front(const SpMat_t& A, int task_depth);
+    void release_scatter_map();
+
+    bool level_batchable(int max_size) const;
+    void factor_level_batched(const SpMat_t& A,
+                              const SPOptions<scalar_t>& opts,
+                              int etree_level, int task_depth);
+    void factor_small_front(const SpMat_t& A,
+                            const SPOptions<scalar_t>& opts,
+                            int etree_level);
+
+    long long node_factor_nonzeros() const override {
+      return factor_size();
+    }
+
     virtual void
     fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd, int etree_level,
-                     int task_depth) const;
+                     int task_depth, Trans op=Trans::N) const;
     virtual void
     bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd, int etree_level,
-                     int task_depth) const;
+                     int task_depth, Trans op=Trans::N) const;
 
     using F_t::lchild_;
     using F_t::rchild_;
     using F_t::dim_sep;
     using F_t::dim_upd;
+    using F_t::dim_blk;
   };
 
 } // end namespace strumpack
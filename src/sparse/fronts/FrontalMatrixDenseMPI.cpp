@@ -32,6 +32,7 @@
 #include "FrontalMatrixBLRMPI.hpp"
 #include "ExtendAdd.hpp"
 #include "BLR/BLRExtendAdd.hpp"
+#include "misc/Trace.hpp"
 
 namespace strumpack {
 
@@ -82,7 +83,8 @@ namespace strumpack {
   }
 
   template<typename scalar_t,typename integer_t> void
-  FrontalMatrixDenseMPI<scalar_t,integer_t>::extend_add() {
+  FrontalMatrixDenseMPI<scalar_t,integer_t>::extend_add
+  (const SPOptions<scalar_t>& opts) {
     if (!lchild_ && !rchild_) return;
     std::vector<std::vector<scalar_t>> sbuf(this->P());
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
@@ -93,9 +95,18 @@ namespace strumpack {
       if (!visit(ch)) continue;
       ch->extend_add_copy_to_buffers(sbuf, this);
     }
+    if (this->async_extend_add(opts)) {
+      this->extend_add_async
+        (std::move(sbuf), [&](const F_t* ch, scalar_t** pbuf) {
+          ch->extend_add_copy_from_buffers
+            (F11_, F12_, F21_, F22_, pbuf, this); });
+      return;
+    }
     std::vector<scalar_t,NoInit<scalar_t>> rbuf;
     std::vector<scalar_t*> pbuf;
-    Comm().all_to_all_v(sbuf, rbuf, pbuf);
+    // the message sizes only depend on the structure, so after the
+    // first factorization they do not need to be communicated
+    Comm().all_to_all_v(sbuf, rbuf, pbuf, mpi_type<scalar_t>(), &ea_rsizes_);
     for (auto& ch : {lchild_.get(), rchild_.get()}) {
       if (!ch) continue;
       ch->extend_add_copy_from_buffers
@@ -105,7 +116,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixDenseMPI<scalar_t,integer_t>::build_front
-  (const SpMat_t& A) {
+  (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
     const auto dupd = this->dim_upd();
     const auto dsep = this->dim_sep();
     if (dsep) {
@@ -125,7 +136,6 @@ namespace strumpack {
       F22_ = DistM_t(grid(), dupd, dupd);
       F22_.zero();
     }
-    extend_add();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -217,7 +227,14 @@ namespace strumpack {
       rchild_->multifrontal_factorization(A, opts, etree_level+1, task_depth);
     TaskTimer t("FrontalMatrixDenseMPI_factor");
     if (etree_level == 0 && opts.print_root_front_stats()) t.start();
-    build_front(A);
+    {
+      trace::Region tr(trace::Event::ASSEMBLY, *this, etree_level);
+      build_front(A, opts);
+    }
+    {
+      trace::Region tr(trace::Event::EXTEND_ADD, *this, etree_level);
+      extend_add(opts);
+    }
     if (etree_level == 0 && opts.write_root_front()) {
       //F11_.print_to_files("Froot");
       auto Fs = F11_.gather();
@@ -233,9 +250,15 @@ namespace strumpack {
     }
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
-    partial_factorization(opts);
+    {
+      trace::Region tr(trace::Event::FACTOR, *this, etree_level);
+      partial_factorization(opts);
+    }
 #if defined(STRUMPACK_USE_ZFP)
-    compress(opts);
+    {
+      trace::Region tr(trace::Event::COMPRESS, *this, etree_level);
+      compress(opts);
+    }
 #endif
     if (etree_level == 0 && opts.print_root_front_stats()) {
       auto time = t.elapsed();
@@ -329,6 +352,7 @@ namespace strumpack {
     bupd = DistM_t(grid(), this->dim_upd(), b.cols());
     bupd.zero();
     this->extend_add_b(b, bupd, CBl, CBr, seqCBl, seqCBr);
+    trace::Region tr(trace::Event::FORWARD_SOLVE, *this, etree_level);
 #if defined(STRUMPACK_USE_ZFP)
     if (compressed_) {
       const auto dupd = this->dim_upd();
@@ -379,17 +403,20 @@ namespace strumpack {
   (DenseM_t& yloc, DistM_t* ydist, DistM_t& yupd, DenseM_t&,
    int etree_level) const {
     DistM_t& y = ydist[this->sep_];
+    {
+      trace::Region tr(trace::Event::BACKWARD_SOLVE, *this, etree_level);
 #if defined(STRUMPACK_USE_ZFP)
-    if (compressed_) {
-      const auto dupd = this->dim_upd();
-      const auto dsep = this->dim_sep();
-      DistM_t F11(grid(), dsep, dsep), F12(grid(), dsep, dupd),
-        F21(grid(), dupd, dsep);
-      decompress(F11, F12, F21);
-      bwd_solve_phase1(F11, F12, F21, y, yupd);
-    } else
+      if (compressed_) {
+        const auto dupd = this->dim_upd();
+        const auto dsep = this->dim_sep();
+        DistM_t F11(grid(), dsep, dsep), F12(grid(), dsep, dupd),
+          F21(grid(), dupd, dsep);
+        decompress(F11, F12, F21);
+        bwd_solve_phase1(F11, F12, F21, y, yupd);
+      } else
 #endif
-      bwd_solve_phase1(F11_, F12_, F21_, y, yupd);
+        bwd_solve_phase1(F11_, F12_, F21_, y, yupd);
+    }
     DistM_t CBl, CBr;
     DenseM_t seqCBl, seqCBr;
     this->extract_b(y, yupd, CBl, CBr, seqCBl, seqCBr);
@@ -67,7 +67,7 @@ namespace strumpack {
 
     void release_work_memory() override;
 
-    void extend_add();
+    void extend_add(const SPOptions<scalar_t>& opts);
     void
     extend_add_copy_to_buffers(std::vector<std::vector<scalar_t>>& sbuf,
                                const FMPI_t* pa) const override;
@@ -113,8 +113,11 @@ namespace strumpack {
   private:
     DistM_t F11_, F12_, F21_, F22_;
     std::vector<int> piv;
+    // number of elements received from each rank in the extend-add,
+    // kept for refactorizations
+    std::vector<int> ea_rsizes_;
 
-    void build_front(const SpMat_t& A);
+    void build_front(const SpMat_t& A, const SPOptions<scalar_t>& opts);
     void partial_factorization(const SPOptions<scalar_t>& opts);
 
     void fwd_solve_phase2(const DistM_t& F11, const DistM_t& F12,
@@ -637,7 +637,9 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixGPU<scalar_t,integer_t>::multifrontal_solve
-  (DenseM_t& b, const GPUFactors<scalar_t>* gpu_factors) const {
+  (DenseM_t& b, const GPUFactors<scalar_t>* gpu_factors, Trans op) const {
+    // transposed solves are rejected by the solver for the GPU fronts
+    assert(op == Trans::N);
 #if 0
     fwd_solve_gpu(b, nullptr, gpu_factors);
     bwd_solve_gpu(b, nullptr, gpu_factors);
@@ -786,13 +788,16 @@ namespace strumpack {
 #if 0
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixGPU<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     fwd_solve_gpu(b, work, nullptr);
   }
 #else
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixGPU<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    assert(op == Trans::N);
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
     if (task_depth == 0) {
@@ -1052,13 +1057,16 @@ namespace strumpack {
 #if 0
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixGPU<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
     bwd_solve_gpu(y, work, nullptr);
   }
 #else
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixGPU<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    assert(op == Trans::N);
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
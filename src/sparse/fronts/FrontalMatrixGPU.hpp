@@ -77,15 +77,15 @@ namespace strumpack {
     std::unique_ptr<GPUFactors<scalar_t>> move_to_gpu() const override;
 
     void multifrontal_solve(DenseM_t& b,
-                            const GPUFactors<scalar_t>* gpu_factors)
-      const override;
+                            const GPUFactors<scalar_t>* gpu_factors,
+                            Trans op=Trans::N) const override;
 
     void forward_multifrontal_solve(DenseM_t& b, DenseM_t* work,
-                                    int etree_level=0, int task_depth=0)
-      const override;
+                                    int etree_level=0, int task_depth=0,
+                                    Trans op=Trans::N) const override;
     void backward_multifrontal_solve(DenseM_t& y, DenseM_t* work,
-                                     int etree_level=0, int task_depth=0)
-      const override;
+                                     int etree_level=0, int task_depth=0,
+                                     Trans op=Trans::N) const override;
 
     void extract_CB_sub_matrix(const std::vector<std::size_t>& I,
                                const std::vector<std::size_t>& J,
@@ -29,6 +29,7 @@
 
 #include "FrontalMatrixHODLR.hpp"
 #include "ExtendAdd.hpp"
+#include "misc/Trace.hpp"
 
 namespace strumpack {
 
@@ -323,15 +324,20 @@ namespace strumpack {
     TaskTimer t("");
     if (/*etree_level == 0 && */opts.print_root_front_stats()) t.start();
     construct_hierarchy(A, opts, task_depth);
-    switch (opts.HODLR_options().compression_algorithm()) {
-    case HODLR::CompressionAlgorithm::RANDOM_SAMPLING:
-      compress_sampling(A, opts, task_depth); break;
-    case HODLR::CompressionAlgorithm::ELEMENT_EXTRACTION: {
-      auto lopts = opts;
-      lopts.HODLR_options().set_rel_tol
-        (lopts.HODLR_options().rel_tol() / (etree_level+1));
-      compress_extraction(A, lopts, task_depth);
-    } break;
+    {
+      // compression of F11, F12, F21 and the Schur complement,
+      // interleaved with the factorization of F11
+      trace::Region tr(trace::Event::COMPRESS, *this, etree_level);
+      switch (opts.HODLR_options().compression_algorithm()) {
+      case HODLR::CompressionAlgorithm::RANDOM_SAMPLING:
+        compress_sampling(A, opts, task_depth); break;
+      case HODLR::CompressionAlgorithm::ELEMENT_EXTRACTION: {
+        auto lopts = opts;
+        lopts.HODLR_options().set_rel_tol
+          (lopts.HODLR_options().rel_tol() / (etree_level+1));
+        compress_extraction(A, lopts, task_depth);
+      } break;
+      }
     }
     if (/*etree_level == 0 && */opts.print_root_front_stats()) {
       auto time = t.elapsed();
@@ -726,7 +732,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHODLR<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    // transposed solves are rejected by the solver for HODLR
+    assert(op == Trans::N);
     DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
     bupd.zero();
     if (lchild_) {
@@ -770,7 +779,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHODLR<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    // transposed solves are rejected by the solver for HODLR
+    assert(op == Trans::N);
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
     if (dim_sep() && dim_upd()) {
       DenseM_t tmp(dim_sep(), y.cols()), tmp2(dim_sep(), y.cols());
@@ -29,6 +29,7 @@
 
 #include "FrontalMatrixHSS.hpp"
 #include "sparse/CSRGraph.hpp"
+#include "misc/Trace.hpp"
 
 namespace strumpack {
 
@@ -50,6 +51,21 @@ namespace strumpack {
     _DUB01.clear();
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixHSS<scalar_t,integer_t>::write_factors
+  (std::ofstream& os) const {
+    _H.write(os);
+    os << _ULV << _Theta << _Phi;
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixHSS<scalar_t,integer_t>::read_factors
+  (std::ifstream& is, io::MappedFile* f) {
+    _H.read(is);
+    is >> _ULV >> _Theta >> _Phi;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHSS<scalar_t,integer_t>::extend_add_to_dense
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
@@ -255,18 +271,17 @@ namespace strumpack {
       auto d0 = opts.HSS_options().d0();
       integer_t d = Rr.cols(), m = Rr.rows();
       if (d0 % dd == 0) {
+        // each row of each block of dd columns is its own stream
+        std::vector<real_t> rv(dd);
         for (integer_t c=0; c<d; c+=dd) {
-          integer_t r = 0, cs = c + _sampled_columns;
-          for (; r<dsep; r++) {
-            rgen->seed(std::uint32_t(r+sep_begin_), std::uint32_t(cs));
-            for (integer_t cc=c; cc<c+dd; cc++)
-              Rr(r,cc) = Rc(r,cc) = rgen->get();
-          }
-          for (; r<m; r++) {
-            rgen->seed(std::uint32_t(this->upd_[r-dsep]),
+          integer_t cs = c + _sampled_columns;
+          for (integer_t r=0; r<m; r++) {
+            rgen->seed(std::uint32_t(r < dsep ? r+sep_begin_ :
+                                     this->upd_[r-dsep]),
                        std::uint32_t(cs));
+            rgen->fill(dd, rv.data());
             for (integer_t cc=c; cc<c+dd; cc++)
-              Rr(r,cc) = Rc(r,cc) = rgen->get();
+              Rr(r,cc) = Rc(r,cc) = rv[cc-c];
           }
         }
       } else {
@@ -378,10 +393,15 @@ namespace strumpack {
     HSSopts.set_d0(std::max(child_samples - HSSopts.dd(), HSSopts.d0()));
     if (opts.indirect_sampling())
       HSSopts.set_user_defined_random(true);
-    _H.compress(mult, elem, HSSopts);
+    {
+      trace::Region tr(trace::Event::COMPRESS, *this, etree_level);
+      _H.compress(mult, elem, HSSopts);
+      tr.set_rank(_H.rank());
+    }
     if (lchild_) lchild_->release_work_memory();
     if (rchild_) rchild_->release_work_memory();
     if (dim_sep()) {
+      trace::Region tr(trace::Event::FACTOR, *this, etree_level);
       if (etree_level > 0) {
         TIMER_TIME(TaskType::HSS_PARTIALLY_FACTOR, 0, t_pfact);
         _ULV = _H.partial_factor();
@@ -430,7 +450,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHSS<scalar_t,integer_t>::forward_multifrontal_solve
-  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    // transposed solves are rejected by the solver for HSS
+    assert(op == Trans::N);
     if (task_depth == 0)
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single
@@ -466,7 +489,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixHSS<scalar_t,integer_t>::backward_multifrontal_solve
-  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth,
+   Trans op) const {
+    // transposed solves are rejected by the solver for HSS
+    assert(op == Trans::N);
     if (task_depth == 0)
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single
@@ -77,16 +77,19 @@ namespace strumpack {
 
     void forward_multifrontal_solve
     (DenseM_t& b, DenseM_t* work, int etree_level=0,
-     int task_depth=0) const override;
+     int task_depth=0, Trans op=Trans::N) const override;
     void backward_multifrontal_solve
     (DenseM_t& y, DenseM_t* work, int etree_level=0,
-     int task_depth=0) const override;
+     int task_depth=0, Trans op=Trans::N) const override;
 
     integer_t front_rank(int task_depth=0) const override;
     void print_rank_statistics(std::ostream &out) const override;
     bool isHSS() const override { return true; };
     std::string type() const override { return "FrontalMatrixHSS"; }
 
+    bool write_factors(std::ofstream& os) const override;
+    void read_factors(std::ifstream& is, io::MappedFile* f) override;
+
     int random_samples() const override { return R1.cols(); };
 
     void partition
@@ -27,6 +27,7 @@
  *
  */
 #include "FrontalMatrixLossy.hpp"
+#include "misc/Trace.hpp"
 #include "zfp.h"
 #include "zfparray2.h"
 
@@ -128,9 +129,7 @@ namespace strumpack {
     F11c_ = LossyMatrix<scalar_t>(this->F11_, prec);
     F12c_ = LossyMatrix<scalar_t>(this->F12_, prec);
     F21c_ = LossyMatrix<scalar_t>(this->F21_, prec);
-    this->F11_.clear();
-    this->F12_.clear();
-    this->F21_.clear();
+    this->release_factor_memory();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -145,16 +144,40 @@ namespace strumpack {
   FrontalMatrixLossy<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const Opts_t& opts, int etree_level, int task_depth) {
     FD_t::multifrontal_factorization(A, opts, etree_level, task_depth);
+    trace::Region tr(trace::Event::COMPRESS, *this, etree_level);
     compress(opts);
   }
 
+  template<typename scalar_t,typename integer_t> bool
+  FrontalMatrixLossy<scalar_t,integer_t>::write_factors
+  (std::ofstream& os) const {
+    io::write_binary(os, this->piv);
+    os << F11c_ << F12c_ << F21c_;
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontalMatrixLossy<scalar_t,integer_t>::read_factors
+  (std::ifstream& is, io::MappedFile* f) {
+    io::read_binary(is, this->piv);
+    is >> F11c_ >> F12c_ >> F21c_;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixLossy<scalar_t,integer_t>::fwd_solve_phase2
-  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth,
+   Trans op) const {
     DenseM_t F11, F12, F21;
     decompress(F11, F12, F21);
     //FD_t::fwd_solve_phase2(b, bupd, etree_level, task_depth);
-    if (this->dim_sep()) {
+    if (this->dim_sep() && op != Trans::N) {
+      DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      trsm(Side::L, UpLo::U, op, Diag::N,
+           scalar_t(1.), F11, bloc, task_depth);
+      if (this->dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F12, bloc,
+             scalar_t(1.), bupd, task_depth);
+    } else if (this->dim_sep()) {
       DenseMW_t bloc(this->dim_sep(), b.cols(), b, this->sep_begin_, 0);
       bloc.laswp(this->piv, true);
       if (b.cols() == 1) {
@@ -174,11 +197,20 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   FrontalMatrixLossy<scalar_t,integer_t>::bwd_solve_phase1
-  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth,
+   Trans op) const {
     DenseM_t F11, F12, F21;
     decompress(F11, F12, F21);
     // FD_t::bwd_solve_phase1(y, yupd, etree_level, task_depth);
-    if (this->dim_sep()) {
+    if (this->dim_sep() && op != Trans::N) {
+      DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (this->dim_upd())
+        gemm(op, Trans::N, scalar_t(-1.), F21, yupd,
+             scalar_t(1.), yloc, task_depth);
+      trsm(Side::L, UpLo::L, op, Diag::U, scalar_t(1.),
+           F11, yloc, task_depth);
+      yloc.laswp(this->piv, false);
+    } else if (this->dim_sep()) {
       DenseMW_t yloc(this->dim_sep(), y.cols(), y, this->sep_begin_, 0);
       if (y.cols() == 1) {
         if (this->dim_upd())
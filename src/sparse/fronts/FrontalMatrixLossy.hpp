@@ -46,6 +46,24 @@ namespace strumpack {
     std::size_t compressed_size() const { return buffer_.size(); }
     std::size_t rows() const { return rows_; }
     std::size_t cols() const { return cols_; }
+
+    friend std::ofstream& operator<<
+    (std::ofstream& os, const LossyMatrix<T>& F) {
+      os.write((const char*)&F.rows_, sizeof(std::size_t));
+      os.write((const char*)&F.cols_, sizeof(std::size_t));
+      os.write((const char*)&F.prec_, sizeof(uint));
+      io::write_binary(os, F.buffer_);
+      return os;
+    }
+    friend std::ifstream& operator>>
+    (std::ifstream& is, LossyMatrix<T>& F) {
+      is.read((char*)&F.rows_, sizeof(std::size_t));
+      is.read((char*)&F.cols_, sizeof(std::size_t));
+      is.read((char*)&F.prec_, sizeof(uint));
+      io::read_binary(is, F.buffer_);
+      return is;
+    }
+
   private:
     std::size_t rows_ = 0, cols_ = 0;
     uint prec_ = 16;
@@ -67,6 +85,18 @@ namespace strumpack {
     }
     std::size_t rows() const { return Freal_.rows(); }
     std::size_t cols() const { return Freal_.cols(); }
+
+    friend std::ofstream& operator<<
+    (std::ofstream& os, const LossyMatrix<std::complex<T>>& F) {
+      os << F.Freal_ << F.Fimag_;
+      return os;
+    }
+    friend std::ifstream& operator>>
+    (std::ifstream& is, LossyMatrix<std::complex<T>>& F) {
+      is >> F.Freal_ >> F.Fimag_;
+      return is;
+    }
+
   private:
     LossyMatrix<T> Freal_, Fimag_;
   };
@@ -93,6 +123,9 @@ namespace strumpack {
 
     std::string type() const override { return "FrontalMatrixLossy"; }
 
+    bool write_factors(std::ofstream& os) const override;
+    void read_factors(std::ifstream& is, io::MappedFile* f) override;
+
     void compress(const Opts_t& opts);
     void decompress(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21) const;
     bool compressible(const Opts_t& opts) const;
@@ -103,9 +136,11 @@ namespace strumpack {
     LossyMatrix<scalar_t> F11c_, F12c_, F21c_;
 
     void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
-                          int etree_level, int task_depth) const override;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const override;
     void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
-                          int etree_level, int task_depth) const override;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const override;
 
     FrontalMatrixLossy(const FrontalMatrixLossy&) = delete;
     FrontalMatrixLossy& operator=(FrontalMatrixLossy const&) = delete;
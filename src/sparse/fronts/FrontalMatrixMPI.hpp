@@ -33,6 +33,7 @@
 
 #include "misc/MPIWrapper.hpp"
 #include "dense/DistributedMatrix.hpp"
+#include "ExtendAdd.hpp"
 
 namespace strumpack {
 
@@ -133,6 +134,53 @@ namespace strumpack {
     int master(const F_t* ch) const;
     int master(const std::unique_ptr<F_t>& ch) const;
 
+    /**
+     * Whether to use the non-blocking extend-add from the children
+     * to this front, see AsyncExtendAdd. This requires that the
+     * children are on disjoint sets of ranks.
+     */
+    bool async_extend_add(const Opts_t& opts) const {
+      return opts.async_extend_add() &&
+        !(lchild_ && rchild_ &&
+          master(lchild_) + lchild_->P() > master(rchild_));
+    }
+
+    /**
+     * Non-blocking extend-add, sbuf[p] is sent to rank p, if not
+     * empty, and assemble(ch, pbuf) is called for each child ch, as
+     * soon as its contribution has been received, with pbuf[p]
+     * pointing to the data from rank master(ch)+p, or null if that
+     * rank did not send anything.
+     */
+    template<typename F> void
+    extend_add_async(std::vector<std::vector<scalar_t>>&& sbuf,
+                     const F& assemble) const {
+      AsyncExtendAdd<scalar_t> ea(Comm(), async_extend_add_tag());
+      const F_t* ch[2] = {lchild_.get(), rchild_.get()};
+      int lo[2], n[2], g = -1;
+      for (int i=0; i<2; i++) {
+        lo[i] = ch[i] ? master(ch[i]) : 0;
+        n[i] = ch[i] ? ch[i]->P() : 0;
+        if (visit(ch[i])) g = i;
+      }
+      if (g != -1)
+        ea.send(std::move(sbuf), ch[g]->isMPI() ?
+                &static_cast<const FMPI_t*>(ch[g])->Comm() : nullptr,
+                g, lo, n);
+      ea.receive(g, lo, n, [&](int i, scalar_t** pbuf) {
+        assemble(ch[i], pbuf); });
+      ea.wait();
+    }
+
+    /**
+     * Base of the 3 tags used by the non-blocking extend-add to this
+     * front. These differ between fronts, so that messages of
+     * different fronts cannot be matched with each other.
+     */
+    int async_extend_add_tag() const {
+      return 100 + 3 * (this->sep_begin_ % 10000);
+    }
+
     MPIComm& Comm() { return grid()->Comm(); }
     const MPIComm& Comm() const { return grid()->Comm(); }
     BLACSGrid* grid() override { return &blacs_grid_; }
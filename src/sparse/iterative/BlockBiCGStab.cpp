@@ -0,0 +1,182 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+
+#include "IterativeSolvers.hpp"
+#include "BlockKrylov.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /**
+     * A. El Guennouni, K. Jbilou, H. Sadok, "A block version of
+     * BiCGSTAB for linear systems with multiple right-hand sides",
+     * ETNA 16, 2003, with right preconditioning.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockBiCGStab
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      const std::size_t n = x.rows(), s = x.cols();
+      totit = 0;
+      if (s == 0) return real_t(0.);
+      std::vector<real_t> bnrm(s), rho(s);
+      for (std::size_t j=0; j<s; j++)
+        bnrm[j] = blas::nrm2(n, b.ptr(0, j), 1);
+      auto norms = [&](const DenseM_t& R) {
+        for (std::size_t j=0; j<s; j++)
+          rho[j] = blas::nrm2(n, R.ptr(0, j), 1);
+      };
+      auto max_rel = [&]() {
+        real_t e(0.);
+        for (std::size_t j=0; j<s; j++)
+          if (bnrm[j] != real_t(0.)) e = std::max(e, rho[j] / bnrm[j]);
+        return e;
+      };
+      DenseM_t R(n, s);
+      if (non_zero_guess) {     // compute initial residual
+        A(x, R);
+        R.scale_and_add(scalar_t(-1.), b);
+      } else {
+        R.copy(b);
+        x.zero();
+      }
+      norms(R);
+      if (verbose) block_print("block BiCGStab", totit, rho, bnrm);
+      if (block_converged(rho, bnrm, rtol, atol)) return max_rel();
+      // Deflate the initial residual, R = Q S, with Q orthonormal and
+      // of full (numerical) rank k, and solve A Y = Q instead, since
+      // block BiCGStab breaks down for linearly dependent right hand
+      // sides. The solution is then x + Y S, with residual R_Y S.
+      // Normalize first, so the rank does not depend on the scaling of
+      // the right hand sides.
+      DenseM_t S0(s, s);
+      for (std::size_t j=0; j<s; j++)
+        if (rho[j] != real_t(0.))
+          blas::scal(n, scalar_t(1./rho[j]), R.ptr(0, j), 1);
+      const auto k = block_qr(DenseM_t(), R, S0, real_t(1.));
+      for (std::size_t j=0; j<s; j++)
+        blas::scal(s, scalar_t(rho[j]), S0.ptr(0, j), 1);
+      DenseMW_t Sk(k, s, S0, 0, 0);
+      DenseM_t Q(n, k), Y(n, k), Rs(n, s);
+      Q.copy(R);
+      R = Q;
+      Y.zero();
+      auto residual_norms = [&](const DenseM_t& Ry) {
+        gemm(Trans::N, Trans::N, scalar_t(1.), Ry, Sk, scalar_t(0.), Rs);
+        norms(Rs);
+      };
+      DenseM_t Rt(R), P(R), Ph(n, k), V(n, k), S(n, k), Sh(n, k), T(n, k),
+        RtV(k, k), alpha(k, k), beta(k, k);
+      std::vector<int> piv;
+      for (totit=1; totit<=maxit; totit++) {
+        Ph.copy(P);                          // Ph = M \ P
+        M(Ph);
+        A(Ph, V);                            // V = A * Ph
+        gemm(Trans::C, Trans::N, scalar_t(1.), Rt, V, scalar_t(0.), RtV);
+        if (RtV.LU(piv)) break;
+        // alpha = (Rt^* V)^{-1} (Rt^* R)
+        gemm(Trans::C, Trans::N, scalar_t(1.), Rt, R, scalar_t(0.), alpha);
+        RtV.solve_LU_in_place(alpha, piv);
+        S.copy(R);                           // S = R - V alpha
+        gemm(Trans::N, Trans::N, scalar_t(-1.), V, alpha, scalar_t(1.), S);
+        residual_norms(S);
+        if (block_converged(rho, bnrm, rtol, atol)) { // early convergence
+          gemm(Trans::N, Trans::N, scalar_t(1.), Ph, alpha, scalar_t(1.), Y);
+          A(Y, R);
+          R.scale_and_add(scalar_t(-1.), Q);
+          residual_norms(R);
+          if (verbose) block_print("block BiCGStab", totit, rho, bnrm);
+          break;
+        }
+        Sh.copy(S);                          // Sh = M \ S
+        M(Sh);
+        A(Sh, T);                            // T = A * Sh
+        // omega = <T,S>_F / <T,T>_F
+        scalar_t ts(0.), tt(0.);
+        for (std::size_t j=0; j<k; j++) {
+          ts += blas::dotc(n, T.ptr(0, j), 1, S.ptr(0, j), 1);
+          tt += blas::dotc(n, T.ptr(0, j), 1, T.ptr(0, j), 1);
+        }
+        if (tt == scalar_t(0.)) break;
+        scalar_t omega = ts / tt;
+        // Y = Y + Ph alpha + omega Sh
+        gemm(Trans::N, Trans::N, scalar_t(1.), Ph, alpha, scalar_t(1.), Y);
+        Y.scaled_add(omega, Sh);
+        R.copy(S);                           // R = S - omega T
+        R.scaled_add(-omega, T);
+        residual_norms(R);
+        if (verbose) block_print("block BiCGStab", totit, rho, bnrm);
+        if (block_converged(rho, bnrm, rtol, atol)) break;
+        if (omega == scalar_t(0.)) break;
+        // beta = -(Rt^* V)^{-1} (Rt^* T)
+        gemm(Trans::C, Trans::N, scalar_t(-1.), Rt, T, scalar_t(0.), beta);
+        RtV.solve_LU_in_place(beta, piv);
+        P.scaled_add(-omega, V);             // P = R + (P - omega V) beta
+        Ph.copy(R);
+        gemm(Trans::N, Trans::N, scalar_t(1.), P, beta, scalar_t(1.), Ph);
+        std::swap(P, Ph);
+      }
+      gemm(Trans::N, Trans::N, scalar_t(1.), Y, Sk, scalar_t(1.), x);
+      return max_rel();
+    }
+
+    // explicit template instantiations
+    template float BlockBiCGStab
+    (const BlockSPMV<float>& A, const BlockPREC<float>& M,
+     DenseMatrix<float>& x, const DenseMatrix<float>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<double>& A, const BlockPREC<double>& M,
+     DenseMatrix<double>& x, const DenseMatrix<double>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template float BlockBiCGStab
+    (const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
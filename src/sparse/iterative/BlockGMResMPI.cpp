@@ -0,0 +1,142 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+
+#include "IterativeSolversMPI.hpp"
+#include "BlockKrylov.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    template<typename scalar_t, typename real_t> real_t BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<scalar_t>& A,
+     const BlockPREC<scalar_t>& M, DenseMatrix<scalar_t>& x,
+     const DenseMatrix<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      const std::size_t n = x.rows(), s = x.cols();
+      totit = 0;
+      if (s == 0) return real_t(0.);
+      if (restart > maxit) restart = maxit;
+      const std::size_t m = std::max(restart, 1);
+      DenseM_t V(n, (m+1)*s), S(s, s), bprec(b);
+      BlockHessenberg<scalar_t> H(m, s);
+      std::vector<real_t> rho(s), rho0(s);
+      const bool reorth = GStype == GramSchmidtType::MODIFIED;
+      M(bprec);
+
+      while (true) {
+        DenseMW_t V0(n, s, V, 0, 0);
+        if (non_zero_guess || totit > 0) {
+          A(x, V0);
+          M(V0);
+          V0.scale_and_add(scalar_t(-1.), bprec);
+        } else {
+          V0.copy(bprec);
+          x.zero();
+        }
+        for (std::size_t j=0; j<s; j++)
+          rho[j] = norm2(n, V0.ptr(0, j), 1, comm);
+        if (totit == 0) rho0 = rho;
+        if (block_converged(rho, rho0, rtol, atol) || totit >= maxit)
+          break;
+        if (verbose) block_print("block GMRES", totit, rho, rho0, true);
+        for (std::size_t j=0; j<s; j++)
+          if (rho[j] != real_t(0.))
+            blas::scal(n, scalar_t(1./rho[j]), V0.ptr(0, j), 1);
+        block_qr_mpi(comm, DenseM_t(), V0, S, real_t(1.));
+        for (std::size_t j=0; j<s; j++)
+          blas::scal(s, scalar_t(rho[j]), S.ptr(0, j), 1);
+        H.reset(S);
+
+        std::size_t nrit = m-1;
+        bool deficient = false;
+        for (std::size_t it=0; it<m; it++) {
+          totit++;
+          DenseMW_t Vi(n, (it+1)*s, V, 0, 0), Vk(n, s, V, 0, it*s),
+            W(n, s, V, 0, (it+1)*s);
+          A(Vk, W);
+          M(W);
+          auto scale = W.normF();
+          scale = std::sqrt(comm.all_reduce(scale*scale, MPI_SUM));
+          auto Hk = H.column(it);
+          block_cgs_mpi(comm, Vi, W, Hk, reorth);
+          auto Rk = H.subdiagonal(it);
+          if (block_qr_mpi(comm, Vi, W, Rk, scale) < s) deficient = true;
+          H.triangularize(it);
+          for (std::size_t j=0; j<s; j++)
+            rho[j] = H.residual(it, j);
+          if (verbose) block_print("block GMRES", totit, rho, rho0);
+          if (block_converged(rho, rho0, rtol, atol) || totit >= maxit) {
+            nrit = it;
+            break;
+          }
+        }
+        H.update(V, x, nrit);
+        if (!deficient &&
+            (block_converged(rho, rho0, rtol, atol) || totit >= maxit))
+          break;
+      }
+      return *std::max_element(rho.begin(), rho.end());
+    }
+
+    // explicit template instantiations
+    template float BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<float>& A,
+     const BlockPREC<float>& M, DenseMatrix<float>& x,
+     const DenseMatrix<float>& b, float rtol, float atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<double>& A,
+     const BlockPREC<double>& M, DenseMatrix<double>& x,
+     const DenseMatrix<double>& b, double rtol, double atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template float BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b, float rtol, float atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+    template double BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b, double rtol, double atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
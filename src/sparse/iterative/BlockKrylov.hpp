@@ -0,0 +1,353 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file BlockKrylov.hpp
+ * \brief Helpers shared by the sequential and distributed block
+ * Krylov solvers. Not installed.
+ */
+#ifndef STRUMPACK_BLOCK_KRYLOV_HPP
+#define STRUMPACK_BLOCK_KRYLOV_HPP
+
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+
+#include "StrumpackConfig.hpp"
+#include "dense/DenseMatrix.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "misc/MPIWrapper.hpp"
+#endif
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /**
+     * Block upper Hessenberg matrix of a block Arnoldi process with
+     * block size s and (at most) m blocks, together with the least
+     * squares right hand sides G. The Hessenberg matrix is reduced to
+     * upper triangular form one block column at a time using Givens
+     * rotations, which are also applied to G.
+     */
+    template<typename scalar_t> class BlockHessenberg {
+      using real_t = typename RealType<scalar_t>::value_type;
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+
+    public:
+      BlockHessenberg(std::size_t m, std::size_t s)
+        : s_(s), H_((m+1)*s, m*s), G_((m+1)*s, s),
+          c_(2*m*s*s), sn_(2*m*s*s) {}
+
+      /**
+       * Start a new cycle, the s x s matrix S holds the coefficients
+       * of the initial residual in the first basis block.
+       */
+      void reset(const DenseM_t& S) {
+        G_.zero();
+        DenseMW_t(s_, s_, G_, 0, 0).copy(S);
+      }
+
+      /** Block column it of H, (it+1)*s x s. */
+      DenseMW_t column(std::size_t it) {
+        return DenseMW_t((it+1)*s_, s_, H_, 0, it*s_);
+      }
+      /** Subdiagonal block (it+1, it) of H, s x s. */
+      DenseMW_t subdiagonal(std::size_t it) {
+        return DenseMW_t(s_, s_, H_, (it+1)*s_, it*s_);
+      }
+
+      /**
+       * Reduce block column it to upper triangular form, given that
+       * all previous block columns have already been reduced.
+       */
+      void triangularize(std::size_t it) {
+        for (std::size_t j=0; j<s_; j++) {
+          auto c = it*s_ + j;
+          // rotations from the previous columns, in the order in
+          // which they were created
+          for (std::size_t k=0; k<c; k++) {
+            auto bot = (k/s_+2)*s_ - 1;
+            for (std::size_t i=bot, r=0; i>k; i--, r++)
+              rotate(c_[k*2*s_+r], sn_[k*2*s_+r], H_(i-1, c), H_(i, c));
+          }
+          auto bot = (it+2)*s_ - 1;
+          for (std::size_t i=bot, r=0; i>c; i--, r++) {
+            auto& cs = c_[c*2*s_+r];
+            auto& sn = sn_[c*2*s_+r];
+            auto a = H_(i-1, c), b = H_(i, c);
+            auto delta = std::sqrt(std::abs(a)*std::abs(a) +
+                                   std::abs(b)*std::abs(b));
+            if (delta == real_t(0.)) {
+              cs = scalar_t(1.);
+              sn = scalar_t(0.);
+            } else {
+              cs = a / delta;
+              sn = b / delta;
+            }
+            rotate(cs, sn, H_(i-1, c), H_(i, c));
+            for (std::size_t l=0; l<s_; l++)
+              rotate(cs, sn, G_(i-1, l), G_(i, l));
+          }
+        }
+      }
+
+      /**
+       * Norm of the least squares residual for right hand side j,
+       * after block iteration it.
+       */
+      real_t residual(std::size_t it, std::size_t j) const {
+        return blas::nrm2(s_, G_.ptr((it+1)*s_, j), 1);
+      }
+
+      /**
+       * Solve the triangular system for the first nrit+1 block
+       * iterations and update x += V Y.
+       */
+      void update(const DenseM_t& V, DenseM_t& x, std::size_t nrit) {
+        auto k = (nrit+1)*s_;
+        DenseMW_t Hk(k, k, H_, 0, 0), Gk(k, s_, G_, 0, 0),
+          Vk(V.rows(), k, const_cast<DenseM_t&>(V), 0, 0);
+        trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.), Hk, Gk);
+        gemm(Trans::N, Trans::N, scalar_t(1.), Vk, Gk, scalar_t(1.), x);
+      }
+
+    private:
+      std::size_t s_;
+      DenseM_t H_, G_;
+      std::vector<scalar_t> c_, sn_;
+
+      static void rotate(scalar_t c, scalar_t s, scalar_t& a, scalar_t& b) {
+        scalar_t t = blas::my_conj(c)*a + blas::my_conj(s)*b;
+        b = -s*a + c*b;
+        a = t;
+      }
+    };
+
+    /**
+     * Numerical rank of the (column pivoted) upper triangular R,
+     * compared to a reference scale.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    std::size_t block_rank(const DenseMatrix<scalar_t>& R, real_t scale) {
+      auto tol = real_t(R.cols()) *
+        std::numeric_limits<real_t>::epsilon() * scale;
+      std::size_t r = 0, rmax = std::min(R.rows(), R.cols());
+      while (r < rmax && std::abs(R(r, r)) > tol) r++;
+      return r;
+    }
+
+    template<typename real_t> bool block_converged
+    (const std::vector<real_t>& rho, const std::vector<real_t>& rho0,
+     real_t rtol, real_t atol) {
+      for (std::size_t j=0; j<rho.size(); j++)
+        if (!(rho[j] < atol || rho[j] <= rtol * rho0[j]))
+          return false;
+      return true;
+    }
+
+    template<typename real_t> void block_print
+    (const std::string& name, int it, const std::vector<real_t>& rho,
+     const std::vector<real_t>& rho0, bool restart=false) {
+      real_t res(0.), rel(0.);
+      for (std::size_t j=0; j<rho.size(); j++) {
+        res = std::max(res, rho[j]);
+        if (rho0[j] != real_t(0.)) rel = std::max(rel, rho[j] / rho0[j]);
+      }
+      std::cout << name << " it. " << it
+                << "\tmax res = " << std::setw(12) << res
+                << "\tmax rel.res = " << std::setw(12) << rel
+                << (restart ? "\t restart!" : "") << std::endl;
+    }
+
+    /*
+     * Orthogonalize the columns of W against the columns of Vi, with
+     * block classical Gram-Schmidt, the coefficients are returned in
+     * C. With reorth a second Gram-Schmidt pass is performed.
+     */
+    template<typename scalar_t> void block_cgs
+    (const DenseMatrix<scalar_t>& Vi, DenseMatrix<scalar_t>& W,
+     DenseMatrix<scalar_t>& C, bool reorth) {
+      gemm(Trans::C, Trans::N, scalar_t(1.), Vi, W, scalar_t(0.), C);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Vi, C, scalar_t(1.), W);
+      if (reorth) {
+        DenseMatrix<scalar_t> C2(C.rows(), C.cols());
+        gemm(Trans::C, Trans::N, scalar_t(1.), Vi, W, scalar_t(0.), C2);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Vi, C2, scalar_t(1.), W);
+        C.add(C2);
+      }
+    }
+
+    /*
+     * Rank revealing QR, W P = Q R, of the n x s block W, which is
+     * already orthogonal to the columns of Vi. W is overwritten with
+     * Q, and S = R P^T. Columns of Q that do not contribute to W are
+     * replaced by random vectors, orthogonal to Vi and to the other
+     * columns of Q, to keep the basis orthonormal. Returns the
+     * numerical rank of W.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    std::size_t block_qr
+    (const DenseMatrix<scalar_t>& Vi, DenseMatrix<scalar_t>& W,
+     DenseMatrix<scalar_t>& S, real_t scale) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      std::size_t n = W.rows(), s = W.cols(), r = std::min(n, s);
+      std::vector<int> piv(s, 0);
+      std::unique_ptr<scalar_t[]> tau(new scalar_t[s]);
+      blas::geqp3(n, s, W.data(), W.ld(), piv.data(), tau.get());
+      auto rank = block_rank(DenseMW_t(r, s, W, 0, 0), scale);
+      S.zero();
+      for (std::size_t j=0; j<s; j++)
+        for (std::size_t i=0; i<std::min(j+1, rank); i++)
+          S(i, piv[j]-1) = W(i, j);
+      blas::xxgqr(n, r, r, W.data(), W.ld(), tau.get());
+      if (rank == s) return rank;
+      DenseMW_t Q1(n, rank, W, 0, 0), Q2(n, s-rank, W, 0, rank);
+      Q2.random();
+      for (int pass=0; pass<2; pass++) {
+        if (Vi.cols()) {
+          DenseM_t C(Vi.cols(), Q2.cols());
+          block_cgs(Vi, Q2, C, false);
+        }
+        if (rank) {
+          DenseM_t C(rank, Q2.cols());
+          block_cgs(Q1, Q2, C, false);
+        }
+      }
+      auto r2 = std::min(n, s-rank);
+      blas::geqrf(n, s-rank, Q2.data(), Q2.ld(), tau.get());
+      blas::xxgqr(n, r2, r2, Q2.data(), Q2.ld(), tau.get());
+      return rank;
+    }
+
+#if defined(STRUMPACK_USE_MPI)
+    /*
+     * Distributed block classical Gram-Schmidt, see block_cgs.
+     */
+    template<typename scalar_t> void block_cgs_mpi
+    (const MPIComm& comm, const DenseMatrix<scalar_t>& Vi,
+     DenseMatrix<scalar_t>& W, DenseMatrix<scalar_t>& C, bool reorth) {
+      DenseMatrix<scalar_t> Ci(C.rows(), C.cols());
+      for (int pass=0; pass<(reorth ? 2 : 1); pass++) {
+        gemm(Trans::C, Trans::N, scalar_t(1.), Vi, W, scalar_t(0.), Ci);
+        comm.all_reduce(Ci.data(), Ci.rows()*Ci.cols(), MPI_SUM);
+        gemm(Trans::N, Trans::N, scalar_t(-1.), Vi, Ci, scalar_t(1.), W);
+        if (pass) C.add(Ci);
+        else C.copy(Ci);
+      }
+    }
+
+    /*
+     * Tall skinny QR of the block W, distributed by rows over comm,
+     * W P = Q R. The local R factors are gathered on all ranks and
+     * stacked, and (redundantly) factored again. W is overwritten by
+     * Q and S = R P^T. With pivot, the QR of the stacked R factors
+     * uses column pivoting, and the numerical rank (compared to scale)
+     * is returned, otherwise W.cols() is returned.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    std::size_t tsqr_mpi
+    (const MPIComm& comm, DenseMatrix<scalar_t>& W,
+     DenseMatrix<scalar_t>& S, bool pivot, real_t scale) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      std::size_t n = W.rows(), s = W.cols(), r = std::min(n, s),
+        P = comm.size(), rank = comm.rank();
+      std::unique_ptr<scalar_t[]> tau(new scalar_t[s]);
+      std::vector<scalar_t> buf(s*s*P);
+      if (n) blas::geqrf(n, s, W.data(), W.ld(), tau.get());
+      for (std::size_t j=0; j<s; j++)
+        for (std::size_t i=0; i<std::min(j+1, r); i++)
+          buf[rank*s*s+i+j*s] = W(i, j);
+      comm.all_gather(buf.data(), s*s);
+      if (n) blas::xxgqr(n, r, r, W.data(), W.ld(), tau.get());
+      DenseM_t R(P*s, s);
+      for (std::size_t p=0; p<P; p++)
+        for (std::size_t j=0; j<s; j++)
+          for (std::size_t i=0; i<s; i++)
+            R(p*s+i, j) = buf[p*s*s+i+j*s];
+      std::vector<int> piv(s);
+      for (std::size_t j=0; j<s; j++) piv[j] = pivot ? 0 : j+1;
+      if (pivot) blas::geqp3(P*s, s, R.data(), R.ld(), piv.data(), tau.get());
+      else blas::geqrf(P*s, s, R.data(), R.ld(), tau.get());
+      auto rk = pivot ? block_rank(DenseMW_t(s, s, R, 0, 0), scale) : s;
+      S.zero();
+      for (std::size_t j=0; j<s; j++)
+        for (std::size_t i=0; i<std::min(j+1, rk); i++)
+          S(i, piv[j]-1) = R(i, j);
+      blas::xxgqr(P*s, s, s, R.data(), R.ld(), tau.get());
+      DenseM_t Q(n, s);
+      gemm(Trans::N, Trans::N, scalar_t(1.), DenseMW_t(n, r, W, 0, 0),
+           DenseMW_t(r, s, R, rank*s, 0), scalar_t(0.), Q);
+      W.copy(Q);
+      return rk;
+    }
+
+    /*
+     * Distributed version of block_qr, using tsqr_mpi.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    std::size_t block_qr_mpi
+    (const MPIComm& comm, const DenseMatrix<scalar_t>& Vi,
+     DenseMatrix<scalar_t>& W, DenseMatrix<scalar_t>& S, real_t scale) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+      std::size_t n = W.rows(), s = W.cols();
+      auto rank = tsqr_mpi(comm, W, S, true, scale);
+      if (rank == s) return rank;
+      DenseMW_t Q1(n, rank, W, 0, 0), Q2(n, s-rank, W, 0, rank);
+      Q2.random();
+      for (int pass=0; pass<2; pass++) {
+        if (Vi.cols()) {
+          DenseM_t C(Vi.cols(), Q2.cols());
+          block_cgs_mpi(comm, Vi, Q2, C, false);
+        }
+        if (rank) {
+          DenseM_t C(rank, Q2.cols());
+          block_cgs_mpi(comm, Q1, Q2, C, false);
+        }
+      }
+      DenseM_t R2(s-rank, s-rank);
+      tsqr_mpi(comm, Q2, R2, false, scale);
+      return rank;
+    }
+
+#endif
+
+  } // end namespace iterative
+} // end namespace strumpack
+
+#endif // STRUMPACK_BLOCK_KRYLOV_HPP
@@ -145,16 +145,18 @@ namespace strumpack {
 
 
 
-    // TODO avoid this duplication
     template<typename scalar_t,typename real_t> void IterativeRefinement
-    (const DMat<scalar_t>& A, const Prec<scalar_t>& M, DMat<scalar_t>& x,
-     const DMat<scalar_t>& b, real_t rtol, real_t atol, int& totit, int maxit,
-     bool non_zero_guess, bool verbose) {
-      DMat<scalar_t> r(b);
-      if (non_zero_guess)
-        gemm(Trans::N, Trans::N, scalar_t(-1.), A, x, scalar_t(1.), r);
-      else
+    (const BlockSPMV<scalar_t>& A, const Prec<scalar_t>& M,
+     DMat<scalar_t>& x, const DMat<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose) {
+      DMat<scalar_t> r(x.rows(), x.cols());
+      if (non_zero_guess) {
+        A(x, r);
+        r.scale_and_add(scalar_t(-1.), b);
+      } else {
+        r = b;
         x.zero();
+      }
       auto res_norm = r.norm();
       auto res0 = res_norm;
       auto rel_res_norm = real_t(1.);
@@ -168,8 +170,8 @@ namespace strumpack {
              totit++ < maxit) {
         M(r);
         x.add(r);
-        r.copy(b);
-        gemm(Trans::N, Trans::N, scalar_t(-1.), A, x, scalar_t(1.), r);
+        A(x, r);
+        r.scale_and_add(scalar_t(-1.), b);
         res_norm = r.norm();
         rel_res_norm = res_norm / res0;
         if (verbose)
@@ -180,6 +182,36 @@ namespace strumpack {
       }
     }
 
+    template void IterativeRefinement
+    (const BlockSPMV<float>& A, const Prec<float>& M, DMat<float>& x,
+     const DMat<float>& b, float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template void IterativeRefinement
+    (const BlockSPMV<double>& A, const Prec<double>& M, DMat<double>& x,
+     const DMat<double>& b, double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template void IterativeRefinement
+    (const BlockSPMV<std::complex<float>>& A,
+     const Prec<std::complex<float>>& M, DMat<std::complex<float>>& x,
+     const DMat<std::complex<float>>& b, float rtol, float atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template void IterativeRefinement
+    (const BlockSPMV<std::complex<double>>& A,
+     const Prec<std::complex<double>>& M, DMat<std::complex<double>>& x,
+     const DMat<std::complex<double>>& b, double rtol, double atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+
+
+    template<typename scalar_t,typename real_t> void IterativeRefinement
+    (const DMat<scalar_t>& A, const Prec<scalar_t>& M, DMat<scalar_t>& x,
+     const DMat<scalar_t>& b, real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose) {
+      IterativeRefinement<scalar_t,real_t>
+        ([&A](const DMat<scalar_t>& v, DMat<scalar_t>& w) {
+          gemm(Trans::N, Trans::N, scalar_t(1.), A, v, scalar_t(0.), w); },
+          M, x, b, rtol, atol, totit, maxit, non_zero_guess, verbose);
+    }
+
     template void IterativeRefinement
     (const DMat<float>& A, const Prec<float>& M, DMat<float>& x,
      const DMat<float>& b, float rtol, float atol, int& totit, int maxit,
@@ -45,6 +45,10 @@ namespace strumpack {
 
     template<typename T> using SPMV = std::function<void(const T*, T*)>;
     template<typename T> using PREC = std::function<void(T*)>;
+    template<typename T> using BlockSPMV =
+      std::function<void(const DenseMatrix<T>&, DenseMatrix<T>&)>;
+    template<typename T> using BlockPREC =
+      std::function<void(DenseMatrix<T>&)>;
 
     /*
      * This is left preconditioned restarted GMRes.
@@ -70,6 +74,84 @@ namespace strumpack {
      scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
      int& totit, int maxit, bool non_zero_guess, bool verbose);
 
+    /**
+     * Left preconditioned restarted block GMRes, for multiple right
+     * hand sides. All right hand sides share a single block Krylov
+     * subspace, so the operator and the preconditioner are always
+     * applied to a block of x.cols() vectors at once.
+     *
+     * Each restart cycle performs (at most) restart block iterations,
+     * and requires storage for a basis of x.rows() x
+     * (restart+1)*x.cols(). When the new block of basis vectors is
+     * (numerically) rank deficient, the dependent directions are
+     * replaced by random vectors, and the residual is recomputed
+     * explicitly at the end of the cycle.
+     *
+     * \tparam scalar_t scalar type
+     * \tparam real_t real type, can be derived from the scalar_t type
+     *
+     * \param A routine to apply the matrix to a block of vectors
+     * \param M routine to apply the preconditioner, in place, to a
+     * block of vectors
+     * \param x on output the solution, on input the initial guess if
+     * non_zero_guess. Should have the same size as b.
+     * \param b the right hand sides
+     * \param rtol relative stopping tolerance, on the preconditioned
+     * residual of each right hand side
+     * \param atol absolute stopping tolerance
+     * \param totit on output the number of block iterations
+     * \param maxit maximum number of block iterations
+     * \param restart number of block iterations per restart cycle
+     * \param GStype CLASSICAL does block classical Gram-Schmidt,
+     * MODIFIED does an additional block reorthogonalization step
+     * \param non_zero_guess use x as an initial guess
+     * \param verbose print the maximum (relative) residual over all
+     * right hand sides in every iteration
+     * \return the largest (estimated) preconditioned residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockGMRes
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+
+    /**
+     * Right preconditioned block BiCGStab, for multiple right hand
+     * sides, see A. El Guennouni, K. Jbilou, H. Sadok, "A block
+     * version of BiCGSTAB for linear systems with multiple right-hand
+     * sides", ETNA 16, 2003. The operator and the preconditioner are
+     * applied to a block of x.cols() vectors at once. The initial
+     * residual is first deflated with a rank revealing QR, so that
+     * linearly dependent right hand sides do not cause a breakdown.
+     *
+     * \tparam scalar_t scalar type
+     * \tparam real_t real type, can be derived from the scalar_t type
+     *
+     * \param A routine to apply the matrix to a block of vectors
+     * \param M routine to apply the preconditioner, in place, to a
+     * block of vectors
+     * \param x on output the solution, on input the initial guess if
+     * non_zero_guess. Should have the same size as b.
+     * \param b the right hand sides
+     * \param rtol relative stopping tolerance, for each right hand side
+     * \param atol absolute stopping tolerance
+     * \param totit on output the number of block iterations
+     * \param maxit maximum number of block iterations
+     * \param non_zero_guess use x as an initial guess
+     * \param verbose print the maximum (relative) residual over all
+     * right hand sides in every iteration
+     * \return the largest relative residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockBiCGStab
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
     /**
      * Iterative refinement, with a sparse matrix, to solve a linear
      * system M^{-1}Ax=M^{-1}b.
@@ -131,6 +213,37 @@ namespace strumpack {
      bool non_zero_guess, bool verbose);
 
 
+    /**
+     * Iterative refinement, with the matrix only available as an
+     * operator, for instance A^T, to solve a linear system
+     * M^{-1}Ax=M^{-1}b. Unlike the sparse matrix version, this does
+     * not check the componentwise backward error.
+     *
+     * \tparam scalar_t scalar type
+     * \tparam real_t real type, can be derived from the scalar_t type
+     *
+     * \param A routine to compute the product of A with a matrix
+     * \param M routine to apply M^{-1} to a matrix
+     * \param x on output this contains the solution, on input this can
+     * be the initial guess. This always has to be allocated to the
+     * correct size (A.rows() x b.cols())
+     * \param b the right hand side, should have A.rows() rows
+     * \param rtol relative stopping tolerance
+     * \param atol absolute stopping tolerance
+     * \param totit on output this will contain the number of iterations
+     * that were performed
+     * \param maxit maximum number of iterations
+     * \param non_zero_guess x use x as an initial guess
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    void IterativeRefinement
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
+
   } // end namespace iterative
 } // end namespace strumpack
 
@@ -74,6 +74,39 @@ namespace strumpack {
      std::size_t n, scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
      int& totit, int maxit, bool non_zero_guess, bool verbose);
 
+    /**
+     * Left preconditioned restarted block GMRes, for multiple right
+     * hand sides, see BlockGMRes. Collective operation on comm.
+     *
+     * The blocks x and b should be divided over the processors in
+     * the same way as the matrix, x.rows() is the local number of
+     * rows.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockGMResMPI
+    (const MPIComm& comm, const BlockSPMV<scalar_t>& A,
+     const BlockPREC<scalar_t>& M, DenseMatrix<scalar_t>& x,
+     const DenseMatrix<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, int restart, GramSchmidtType GStype,
+     bool non_zero_guess, bool verbose);
+
+    /**
+     * Right preconditioned block BiCGStab, for multiple right hand
+     * sides, see BlockBiCGStab. Collective operation on comm.
+     *
+     * The blocks x and b should be divided over the processors in
+     * the same way as the matrix, x.rows() is the local number of
+     * rows.
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockBiCGStabMPI
+    (const MPIComm& comm, const BlockSPMV<scalar_t>& A,
+     const BlockPREC<scalar_t>& M, DenseMatrix<scalar_t>& x,
+     const DenseMatrix<scalar_t>& b, real_t rtol, real_t atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+
     /*
      * This is iterative refinement
      *  Input vectors x and b have stride 1, length n
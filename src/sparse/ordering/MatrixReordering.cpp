@@ -55,6 +55,7 @@
 #endif
 #include "RCMReordering.hpp"
 #include "GeometricReordering.hpp"
+#include "NDReordering.hpp"
 
 namespace strumpack {
 
@@ -100,6 +101,10 @@ namespace strumpack {
       sep_tree_ = rcm_reordering(A, perm_, iperm_);
       break;
     }
+    case ReorderingStrategy::ND: {
+      sep_tree_ = nd_nested_dissection(A, perm_, iperm_, opts);
+      break;
+    }
     default:
       std::cerr << "# ERROR: parallel matrix reorderings are"
         " not supported from this interface, \n"
@@ -125,6 +130,27 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  MatrixReordering<scalar_t,integer_t>::coordinate_nested_dissection
+  (const Opts_t& opts, const CSR_t& A,
+   const double* coords, int d, int components) {
+    if (d < 1 || components < 1 || A.size() % components) {
+      std::cerr << "# ERROR: Coordinate based nested dissection failed.\n"
+        "# The number of rows should be a multiple of the number of"
+        " components." << std::endl;
+      return 1;
+    }
+    sep_tree_ = nd_coordinate_nested_dissection
+      (A, coords, d, components, perm_, iperm_, opts);
+    sep_tree_->check();
+    nested_dissection_print(opts, A.nnz(), opts.verbose(), "Coordinate");
+    if (opts.verbose())
+      std::cout << "#      - " << d << "d coordinates, "
+                << (opts.inertial_bisection() ? "inertial" : "coordinate")
+                << " bisection" << std::endl;
+    return 0;
+  }
+
 // #if defined(STRUMPACK_USE_MPI)
 //   template<typename scalar_t,typename integer_t> int
 //   MatrixReordering<scalar_t,integer_t>::nested_dissection
@@ -247,17 +273,58 @@ namespace strumpack {
     F->permute_CB(sorder.data());
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::Schur_reordering
+  (const CSR_t& A, const std::vector<integer_t>& S) {
+    integer_t n = perm_.size(), nS = S.size(), nI = n - nS;
+    std::vector<integer_t> loc(n, -1), lold(nI);
+    for (auto s : S) loc[s] = -2;
+    // number the interior vertices in the current order
+    for (integer_t i=0, l=0; i<n; i++) {
+      auto o = iperm_[i];
+      if (loc[o] == -1) { loc[o] = l; lold[l++] = o; }
+    }
+    // graph of the interior vertices
+    std::vector<integer_t> ptr(nI+1), ind;
+    ind.reserve(A.nnz());
+    ptr[0] = 0;
+    for (integer_t l=0; l<nI; l++) {
+      auto o = lold[l];
+      for (integer_t j=A.ptr(o); j<A.ptr(o+1); j++)
+        if (loc[A.ind(j)] >= 0) ind.push_back(loc[A.ind(j)]);
+      ptr[l+1] = ind.size();
+    }
+    std::vector<Separator<integer_t>> seps;
+    if (nI) {
+      std::vector<integer_t> p(nI), ip(nI);
+      std::iota(p.begin(), p.end(), 0);
+      auto tI = build_sep_tree_from_perm(ptr.data(), ind.data(), p, ip);
+      for (integer_t l=0; l<nI; l++) perm_[lold[l]] = p[l];
+      integer_t ns = tI->separators(), r = tI->root();
+      for (integer_t s=0; s<ns; s++)
+        seps.emplace_back(tI->sizes(s+1), tI->pa(s), tI->lch(s), tI->rch(s));
+      seps[r].pa = ns + 1;
+      seps.emplace_back(nI, ns + 1, -1, -1);
+      seps.emplace_back(n, -1, r, ns);
+    } else seps.emplace_back(n, -1, -1, -1);
+    for (integer_t k=0; k<nS; k++) perm_[S[k]] = nI + k;
+    for (integer_t i=0; i<n; i++) iperm_[perm_[i]] = i;
+    sep_tree_.reset(new SeparatorTree<integer_t>(seps));
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::nested_dissection_print
-  (const Opts_t& opts, integer_t nnz, bool verbose) const {
+  (const Opts_t& opts, integer_t nnz, bool verbose,
+   const std::string& method) const {
     nested_dissection_print
-      (opts, nnz, sep_tree_->levels(), sep_tree_->separators(), verbose);
+      (opts, nnz, sep_tree_->levels(), sep_tree_->separators(), verbose,
+       method);
   }
 
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::nested_dissection_print
   (const Opts_t& opts, integer_t nnz, int max_level,
-   int total_separators, bool verbose) const {
+   int total_separators, bool verbose, const std::string& method) const {
     if (verbose) {
       std::cout << "# initial matrix:" << std::endl;
       std::cout << "#   - number of unknowns = "
@@ -265,8 +332,9 @@ namespace strumpack {
       std::cout << "#   - number of nonzeros = "
                 << number_format_with_commas(nnz) << std::endl;
       std::cout << "# nested dissection reordering:" << std::endl;
-      std::cout << "#   - " << get_name(opts.reordering_method())
-                << " reordering" << std::endl;
+      std::cout << "#   - "
+                << (method.empty() ? get_name(opts.reordering_method())
+                    : method) << " reordering" << std::endl;
       if (opts.reordering_method() == ReorderingStrategy::METIS) {
         if (opts.use_METIS_NodeNDP()) {
           std::cout << "#      - used METIS_NodeNDP (iso METIS_NodeND)"
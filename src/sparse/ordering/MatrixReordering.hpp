@@ -31,10 +31,12 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 #include "StrumpackOptions.hpp"
 #include "StrumpackConfig.hpp"
 #include "HSS/HSSPartitionTree.hpp"
+#include "misc/BinaryIO.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #endif
@@ -62,6 +64,15 @@ namespace strumpack {
     int set_permutation
     (const Opts_t& opts, const CSR_t& A, const int* p, int base);
 
+    /**
+     * Nested dissection based on the coordinates of the mesh points,
+     * see nd_coordinate_nested_dissection. This ignores the
+     * reordering method set in opts.
+     */
+    int coordinate_nested_dissection
+    (const Opts_t& opts, const CSR_t& A,
+     const double* coords, int d, int components);
+
 // #if defined(STRUMPACK_USE_MPI)
 //     int nested_dissection
 //     (const Opts_t& opts, const CSR_t& A, const MPIComm& comm,
@@ -74,11 +85,34 @@ namespace strumpack {
 
     void separator_reordering(const Opts_t& opts, CSR_t& A, F_t* F);
 
+    /**
+     * Modify the nested dissection, computed with nested_dissection
+     * or set_permutation, such that the vertices in S form the root
+     * separator, in the given order. The other vertices keep their
+     * relative order, the separator tree is rebuilt from the graph
+     * without the vertices in S. The root gets an additional empty
+     * leaf as second child.
+     */
+    void Schur_reordering(const CSR_t& A, const std::vector<integer_t>& S);
+
     virtual void clear_tree_data();
 
     const std::vector<integer_t>& perm() const { return perm_; }
     const std::vector<integer_t>& iperm() const { return iperm_; }
 
+    /**
+     * Write/read the permutation (not the separator tree) to/from a
+     * binary stream.
+     */
+    void write_permutation(std::ofstream& os) const {
+      io::write_binary(os, perm_);
+      io::write_binary(os, iperm_);
+    }
+    void read_permutation(std::ifstream& is) {
+      io::read_binary(is, perm_);
+      io::read_binary(is, iperm_);
+    }
+
     const SeparatorTree<integer_t>& tree() const { return *sep_tree_; }
     SeparatorTree<integer_t>& tree() { return *sep_tree_; }
 
@@ -86,9 +120,14 @@ namespace strumpack {
     virtual void separator_reordering_print
     (integer_t max_nr_neighbours, integer_t max_dim_sep);
 
+    /**
+     * Print statistics of the reordering. The reordering is described
+     * by method, or, if empty, by opts.reordering_method().
+     */
     void nested_dissection_print
     (const Opts_t& opts, integer_t nnz, int max_level,
-     int total_separators, bool verbose) const;
+     int total_separators, bool verbose,
+     const std::string& method="") const;
 
     std::vector<integer_t> perm_, iperm_;
 
@@ -96,7 +135,8 @@ namespace strumpack {
 
   private:
     void nested_dissection_print
-    (const Opts_t& opts, integer_t nnz, bool verbose) const;
+    (const Opts_t& opts, integer_t nnz, bool verbose,
+     const std::string& method="") const;
   };
 
 } // end namespace strumpack
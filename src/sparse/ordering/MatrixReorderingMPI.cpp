@@ -47,6 +47,7 @@
 #endif
 #include "RCMReordering.hpp"
 #include "GeometricReorderingMPI.hpp"
+#include "NDReordering.hpp"
 
 namespace strumpack {
 
@@ -96,6 +97,11 @@ namespace strumpack {
           global_sep_tree = rcm_reordering(*Aseq, perm_, iperm_);
           break;
         }
+        case ReorderingStrategy::ND: {
+          global_sep_tree = nd_nested_dissection
+            (*Aseq, perm_, iperm_, opts);
+          break;
+        }
         default: assert(true);
         }
         Aseq.reset();
@@ -208,6 +214,61 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> int
+  MatrixReorderingMPI<scalar_t,integer_t>::coordinate_nested_dissection
+  (const Opts_t& opts, const CSRMPI_t& A,
+   const double* coords, int d, int components) {
+    if (d < 1 || components < 1 || A.size() % components) {
+      if (comm_->is_root())
+        std::cerr << "# ERROR: Coordinate based nested dissection failed.\n"
+          "# The number of rows should be a multiple of the number of"
+          " components." << std::endl;
+      return 1;
+    }
+    auto rank = comm_->rank();
+    auto P = comm_->size();
+    std::vector<double> gcoords;
+    std::vector<int> rcnts(P), displs(P);
+    for (int p=0; p<P; p++) {
+      rcnts[p] = d * (A.dist()[p+1] - A.dist()[p]);
+      displs[p] = d * A.dist()[p];
+    }
+    if (!rank) gcoords.resize(std::size_t(d) * A.size());
+    MPI_Gatherv
+      (const_cast<double*>(coords), d*A.local_rows(), MPI_DOUBLE,
+       gcoords.data(), rcnts.data(), displs.data(), MPI_DOUBLE,
+       0, comm_->comm());
+    auto Aseq = A.gather_graph();
+    std::unique_ptr<SeparatorTree<integer_t>> global_sep_tree;
+    if (Aseq) {
+      global_sep_tree = nd_coordinate_nested_dissection
+        (*Aseq, gcoords.data(), d, components, perm_, iperm_, opts);
+      Aseq.reset();
+      global_sep_tree->check();
+    }
+    gcoords.clear();
+    comm_->broadcast(perm_);
+    comm_->broadcast(iperm_);
+    integer_t nbsep;
+    if (!rank) nbsep = global_sep_tree->separators();
+    comm_->broadcast(nbsep);
+    if (rank)
+      global_sep_tree = std::unique_ptr<SeparatorTree<integer_t>>
+        (new SeparatorTree<integer_t>(nbsep));
+    global_sep_tree->broadcast(*comm_);
+    local_tree_ = global_sep_tree->subtree(rank, P);
+    sep_tree_ = global_sep_tree->toptree(P);
+    local_tree_->check();
+    sep_tree_->check();
+    get_local_graphs(A);
+    nested_dissection_print(opts, A.nnz(), "Coordinate");
+    if (opts.verbose() && comm_->is_root())
+      std::cout << "#      - " << d << "d coordinates, "
+                << (opts.inertial_bisection() ? "inertial" : "coordinate")
+                << " bisection" << std::endl;
+    return 0;
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReorderingMPI<scalar_t,integer_t>::separator_reordering
   (const Opts_t& opts, CSM_t& A, F_t* F) {
@@ -311,7 +372,7 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   MatrixReorderingMPI<scalar_t,integer_t>::nested_dissection_print
-  (const Opts_t& opts, integer_t nnz) const {
+  (const Opts_t& opts, integer_t nnz, const std::string& method) const {
     if (opts.verbose()) {
       auto total_separators =
         comm_->all_reduce(local_tree_->separators(), MPI_SUM) +
@@ -324,7 +385,7 @@ namespace strumpack {
       integer_t max_level = comm_->all_reduce(local_levels, MPI_MAX);
       if (comm_->is_root())
         MatrixReordering<scalar_t,integer_t>::nested_dissection_print
-          (opts, nnz, max_level, total_separators, true);
+          (opts, nnz, max_level, total_separators, true, method);
     }
   }
 
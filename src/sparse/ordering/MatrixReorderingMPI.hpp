@@ -94,6 +94,16 @@ namespace strumpack {
     int set_permutation
     (const Opts_t& opts, const CSRMPI_t& A, const int* p, int base);
 
+    /**
+     * Nested dissection based on the coordinates of the mesh points,
+     * coords holds the coordinates of the local rows of A. The
+     * coordinates are gathered, and the ordering is computed, on the
+     * root.
+     */
+    int coordinate_nested_dissection
+    (const Opts_t& opts, const CSRMPI_t& A,
+     const double* coords, int d, int components);
+
     void separator_reordering(const Opts_t& opts, CSM_t& A, F_t* F);
 
     void clear_tree_data() override;
@@ -149,7 +159,8 @@ namespace strumpack {
     void build_local_tree(const CSRMPI_t& Ampi);
 
     void nested_dissection_print
-    (const SPOptions<scalar_t>& opts, integer_t nnz) const;
+    (const SPOptions<scalar_t>& opts, integer_t nnz,
+     const std::string& method="") const;
 
     using MatrixReordering<scalar_t,integer_t>::perm_;
     using MatrixReordering<scalar_t,integer_t>::iperm_;
@@ -0,0 +1,909 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <limits>
+#include <cstdint>
+#include <cmath>
+
+#include "NDReordering.hpp"
+#include "StrumpackParameters.hpp"
+#include "clustering/Clustering.hpp"
+
+namespace strumpack {
+
+  /**
+   * Graph with vertex and edge weights, in compressed sparse row
+   * format without the diagonal, as used in the nested dissection.
+   */
+  template<typename integer_t> class NDGraph {
+  public:
+    std::vector<integer_t> ptr, ind, ewgt, vwgt;
+
+    integer_t vertices() const { return vwgt.size(); }
+    integer_t weight() const {
+      return std::accumulate(vwgt.begin(), vwgt.end(), integer_t(0));
+    }
+    integer_t max_vertex_weight() const {
+      return vwgt.empty() ? 0 : *std::max_element(vwgt.begin(), vwgt.end());
+    }
+  };
+
+  /**
+   * Bisection of a graph, part[v] is 0 or 1, or 2 for vertices in
+   * the separator.
+   */
+  using NDPart = std::vector<char>;
+
+  inline std::uint64_t nd_hash(std::uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+  // cheaper hash of the edge (u,v), symmetric in u and v
+  template<typename integer_t> inline std::uint64_t
+  nd_edge_hash(integer_t u, integer_t v) {
+    return (std::uint64_t(u ^ v) * 0x9e3779b97f4a7c15ULL) ^
+      (std::uint64_t(u + v) * 0xbf58476d1ce4e5b9ULL);
+  }
+
+  // subgraphs smaller than this are bisected without parallelism
+  const int nd_parallel_min_size = 20000;
+  // stop coarsening when the graph has less vertices
+  const int nd_coarsen_to = 100;
+  // number of rounds of parallel matching, before the greedy matching
+  const int nd_matching_rounds = 2;
+  // number of tries for the initial bisection of the coarsest graph,
+  // or of a graph which is small enough not to be coarsened
+  const int nd_initial_tries = 8, nd_initial_tries_small = 2;
+  // maximum number of Fiduccia-Mattheyses passes
+  const int nd_fm_passes = 6;
+  // allowed imbalance of the bisection
+  const double nd_imbalance = 0.1;
+
+  /**
+   * Coarsen g by matching each vertex with at most one neighbor,
+   * preferring heavy edges. The matching is computed in a number of
+   * rounds, in each round, every unmatched vertex proposes to its
+   * unmatched neighbor with the heaviest edge (ties broken by a hash
+   * of the edge), and mutual proposals are matched. This only reads
+   * the state of the previous round, so it can be done in parallel,
+   * and the result does not depend on the number of threads. The
+   * remaining vertices are matched greedily, or with a vertex two
+   * hops away. Returns the coarse graph, cmap[v] is the coarse vertex
+   * of v.
+   */
+  template<typename integer_t> NDGraph<integer_t>
+  nd_coarsen(const NDGraph<integer_t>& g, std::vector<integer_t>& cmap,
+             bool par) {
+    const integer_t n = g.vertices();
+    const integer_t maxvw =
+      std::max(integer_t(1), integer_t(1.5 * g.weight() / nd_coarsen_to));
+    std::vector<integer_t> match(n, -1), cand(n);
+    for (int round=0; round<nd_matching_rounds; round++) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+      for (integer_t v=0; v<n; v++) {
+        cand[v] = -1;
+        if (match[v] != -1) continue;
+        integer_t bw = 0;
+        std::uint64_t bh = 0;
+        for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+          auto u = g.ind[j];
+          if (match[u] != -1 || g.vwgt[u] + g.vwgt[v] > maxvw) continue;
+          auto w = g.ewgt[j];
+          auto h = nd_edge_hash(u, v);
+          if (w > bw || (w == bw && h > bh)) {
+            bw = w; bh = h; cand[v] = u;
+          }
+        }
+      }
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+      for (integer_t v=0; v<n; v++)
+        if (match[v] == -1 && cand[v] != -1 && cand[cand[v]] == v)
+          match[v] = cand[v];
+    }
+    // the vertices whose proposals were not accepted are matched
+    // greedily, this is much less work
+    for (integer_t v=0; v<n; v++) {
+      if (match[v] != -1) continue;
+      integer_t bw = 0, b = -1;
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+        auto u = g.ind[j];
+        if (match[u] == -1 && u != v && g.ewgt[j] > bw &&
+            g.vwgt[u] + g.vwgt[v] <= maxvw) {
+          bw = g.ewgt[j]; b = u;
+        }
+      }
+      if (b != -1) { match[v] = b; match[b] = v; }
+    }
+    // vertices with only matched neighbors, for instance the leaves
+    // of a star, are matched with another such vertex with the same
+    // (heaviest) neighbor, even though they are not connected
+    std::fill(cand.begin(), cand.end(), -1);
+    for (integer_t v=0; v<n; v++) {
+      if (match[v] != -1 || g.ptr[v] == g.ptr[v+1]) continue;
+      auto h = g.ind[std::max_element
+                     (g.ewgt.begin()+g.ptr[v], g.ewgt.begin()+g.ptr[v+1])
+                     - g.ewgt.begin()];
+      auto w = cand[h];
+      if (w != -1 && g.vwgt[w] + g.vwgt[v] <= maxvw) {
+        match[v] = w; match[w] = v; cand[h] = -1;
+      } else cand[h] = v;
+    }
+    // the coarse vertex is numbered by its smallest fine vertex
+    cmap.resize(n);
+    std::vector<integer_t> v1, v2;
+    v1.reserve(n);
+    v2.reserve(n);
+    for (integer_t v=0; v<n; v++) {
+      if (match[v] == -1) match[v] = v;
+      if (match[v] >= v) {
+        cmap[v] = v1.size();
+        v1.push_back(v);
+        v2.push_back(match[v]);
+      }
+    }
+    integer_t nc = v1.size();
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+    for (integer_t v=0; v<n; v++)
+      if (match[v] < v) cmap[v] = cmap[match[v]];
+
+    // merge the adjacency lists of the fine vertices, first in a
+    // buffer with an upper bound on the degree of each coarse vertex,
+    // pos[cu] is the position of coarse neighbor cu in the buffer
+    NDGraph<integer_t> c;
+    c.vwgt.resize(nc);
+    c.ptr.resize(nc+1);
+    std::vector<integer_t> bptr(nc+1), cnt(nc);
+    bptr[0] = 0;
+    for (integer_t i=0; i<nc; i++)
+      bptr[i+1] = bptr[i] + g.ptr[v1[i]+1] - g.ptr[v1[i]] +
+        ((v2[i] != v1[i]) ? g.ptr[v2[i]+1] - g.ptr[v2[i]] : 0);
+    std::vector<std::pair<integer_t,integer_t>> buf(bptr[nc]);
+    const int nb = par ? params::num_threads : 1;
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+    for (int blk=0; blk<nb; blk++) {
+      std::vector<integer_t> pos(nc, -1);
+      for (integer_t i=nc*blk/nb; i<nc*(blk+1)/nb; i++) {
+        auto b = bptr[i], e = b;
+        for (auto v : {v1[i], v2[i]}) {
+          for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+            auto cu = cmap[g.ind[j]];
+            if (cu == i) continue;
+            if (pos[cu] >= b) buf[pos[cu]].second += g.ewgt[j];
+            else { pos[cu] = e; buf[e++] = {cu, g.ewgt[j]}; }
+          }
+          if (v1[i] == v2[i]) break;
+        }
+        cnt[i] = e - b;
+        c.vwgt[i] = g.vwgt[v1[i]] + ((v2[i] != v1[i]) ? g.vwgt[v2[i]] : 0);
+      }
+    }
+    c.ptr[0] = 0;
+    for (integer_t i=0; i<nc; i++)
+      c.ptr[i+1] = c.ptr[i] + cnt[i];
+    c.ind.resize(c.ptr[nc]);
+    c.ewgt.resize(c.ptr[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+    for (integer_t i=0; i<nc; i++)
+      for (integer_t k=0; k<cnt[i]; k++) {
+        c.ind[c.ptr[i]+k] = buf[bptr[i]+k].first;
+        c.ewgt[c.ptr[i]+k] = buf[bptr[i]+k].second;
+      }
+    return c;
+  }
+
+  /**
+   * Maximum weight of each of the two parts.
+   */
+  template<typename integer_t> integer_t
+  nd_max_part_weight(const NDGraph<integer_t>& g) {
+    auto W = g.weight();
+    return std::max(integer_t(std::ceil((1. + nd_imbalance) * W / 2.)),
+                    (W + 1) / 2 + g.max_vertex_weight());
+  }
+
+  template<typename integer_t> integer_t
+  nd_edge_cut(const NDGraph<integer_t>& g, const NDPart& part) {
+    integer_t cut = 0;
+    for (integer_t v=0; v<g.vertices(); v++)
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+        if (part[g.ind[j]] != part[v]) cut += g.ewgt[j];
+    return cut / 2;
+  }
+
+  /**
+   * Fiduccia-Mattheyses refinement of the edge bisection part of g.
+   * In each pass, boundary vertices are moved one at a time, the one
+   * with the largest reduction of the edge cut first, as long as the
+   * balance constraint allows it. Each vertex moves at most once per
+   * pass, and the pass is rolled back to the best bisection seen.
+   */
+  template<typename integer_t> void
+  nd_fm_refine(const NDGraph<integer_t>& g, NDPart& part) {
+    const integer_t n = g.vertices(), maxw = nd_max_part_weight(g),
+      limit = std::min(integer_t(100), std::max(integer_t(15), n / 100));
+    std::vector<integer_t> ed(n, 0), id(n, 0), moves;
+    integer_t pw[2] = {0, 0}, cut = 0;
+    for (integer_t v=0; v<n; v++) {
+      pw[int(part[v])] += g.vwgt[v];
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+        if (part[g.ind[j]] != part[v]) ed[v] += g.ewgt[j];
+        else id[v] += g.ewgt[j];
+      cut += ed[v];
+    }
+    cut /= 2;
+    std::vector<char> locked(n, 0);
+    auto feasible = [&]() { return pw[0] <= maxw && pw[1] <= maxw; };
+    auto move = [&](integer_t v) {
+      int to = 1 - part[v];
+      part[v] = to;
+      pw[to] += g.vwgt[v];
+      pw[1-to] -= g.vwgt[v];
+      cut -= ed[v] - id[v];
+      std::swap(ed[v], id[v]);
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+        auto u = g.ind[j];
+        auto w = g.ewgt[j];
+        if (part[u] == to) { ed[u] -= w; id[u] += w; }
+        else { ed[u] += w; id[u] -= w; }
+      }
+    };
+    using Q = std::priority_queue<std::pair<integer_t,integer_t>>;
+    for (int pass=0; pass<nd_fm_passes; pass++) {
+      Q q[2];
+      for (integer_t v=0; v<n; v++)
+        if (ed[v] > 0) q[int(part[v])].emplace(ed[v] - id[v], v);
+      moves.clear();
+      integer_t best_cut = cut, best_imb = std::abs(pw[0] - pw[1]);
+      bool best_feas = feasible();
+      std::size_t best = 0;
+      while (true) {
+        for (int s=0; s<2; s++)
+          while (!q[s].empty()) {
+            auto v = q[s].top().second;
+            if (locked[v] || part[v] != s ||
+                ed[v] - id[v] != q[s].top().first) q[s].pop();
+            else break;
+          }
+        int from = -1;
+        if (pw[0] > maxw) from = q[0].empty() ? -1 : 0;
+        else if (pw[1] > maxw) from = q[1].empty() ? -1 : 1;
+        else {
+          for (int s=0; s<2; s++) {
+            if (q[s].empty() ||
+                pw[1-s] + g.vwgt[q[s].top().second] > maxw) continue;
+            if (from == -1 || q[s].top().first > q[from].top().first ||
+                (q[s].top().first == q[from].top().first &&
+                 pw[s] > pw[from]))
+              from = s;
+          }
+        }
+        if (from == -1) break;
+        auto v = q[from].top().second;
+        q[from].pop();
+        move(v);
+        locked[v] = 1;
+        moves.push_back(v);
+        for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+          auto u = g.ind[j];
+          if (!locked[u] && ed[u] > 0)
+            q[int(part[u])].emplace(ed[u] - id[u], u);
+        }
+        integer_t imb = std::abs(pw[0] - pw[1]);
+        bool feas = feasible();
+        if ((feas && !best_feas) ||
+            (feas == best_feas &&
+             (cut < best_cut || (cut == best_cut && imb < best_imb)))) {
+          best_cut = cut; best_imb = imb; best_feas = feas;
+          best = moves.size();
+        } else if (moves.size() - best > std::size_t(limit)) break;
+      }
+      for (auto v : moves) locked[v] = 0;
+      while (moves.size() > best) {
+        move(moves.back());
+        moves.pop_back();
+      }
+      if (!best) break;
+    }
+  }
+
+  /**
+   * Initial bisection of (the coarsest) graph g, by growing part 0
+   * from a random vertex, each time adding the vertex which most
+   * reduces the edge cut, until it has half the weight, followed by
+   * refinement. The best of a number of tries is kept.
+   */
+  template<typename integer_t> NDPart
+  nd_initial_bisection(const NDGraph<integer_t>& g, int tries) {
+    const integer_t n = g.vertices(), half = g.weight() / 2;
+    NDPart best;
+    integer_t best_cut = 0, best_imb = 0;
+    std::vector<integer_t> conn(n), degw(n);
+    for (integer_t v=0; v<n; v++)
+      degw[v] = std::accumulate
+        (g.ewgt.begin()+g.ptr[v], g.ewgt.begin()+g.ptr[v+1], integer_t(0));
+    for (int t=0; t<tries; t++) {
+      NDPart part(n, 1);
+      std::fill(conn.begin(), conn.end(), 0);
+      std::priority_queue<std::pair<integer_t,integer_t>> q;
+      integer_t w0 = 0, next = 0;
+      auto seed = integer_t(nd_hash(n * tries + t) % n);
+      q.emplace(-degw[seed], seed);
+      while (w0 < half) {
+        if (q.empty()) {
+          // disconnected, start again from an unassigned vertex
+          while (next < n && part[next] == 0) next++;
+          if (next == n) break;
+          q.emplace(-degw[next], next);
+        }
+        auto v = q.top().second;
+        auto gain = q.top().first;
+        q.pop();
+        if (part[v] == 0 || gain != 2 * conn[v] - degw[v]) continue;
+        part[v] = 0;
+        w0 += g.vwgt[v];
+        for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+          auto u = g.ind[j];
+          if (part[u] == 0) continue;
+          conn[u] += g.ewgt[j];
+          q.emplace(2 * conn[u] - degw[u], u);
+        }
+      }
+      nd_fm_refine(g, part);
+      integer_t cut = nd_edge_cut(g, part), pw0 = 0;
+      for (integer_t v=0; v<n; v++)
+        if (part[v] == 0) pw0 += g.vwgt[v];
+      integer_t imb = std::abs(g.weight() - 2 * pw0);
+      if (best.empty() || cut < best_cut ||
+          (cut == best_cut && imb < best_imb)) {
+        best.swap(part);
+        best_cut = cut;
+        best_imb = imb;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * Multilevel edge bisection of g.
+   */
+  template<typename integer_t> NDPart
+  nd_multilevel_bisection(const NDGraph<integer_t>& g, bool par) {
+    std::vector<NDGraph<integer_t>> graphs;
+    std::vector<std::vector<integer_t>> cmaps;
+    const NDGraph<integer_t>* cur = &g;
+    while (cur->vertices() > nd_coarsen_to) {
+      std::vector<integer_t> cmap;
+      auto c = nd_coarsen(*cur, cmap, par && cur->vertices() >=
+                          nd_parallel_min_size);
+      if (c.vertices() > 0.95 * cur->vertices()) break;
+      graphs.push_back(std::move(c));
+      cmaps.push_back(std::move(cmap));
+      cur = &graphs.back();
+    }
+    auto part = nd_initial_bisection
+      (*cur, graphs.empty() ? nd_initial_tries_small : nd_initial_tries);
+    for (int l=int(graphs.size())-1; l>=0; l--) {
+      auto& fine = l ? graphs[l-1] : g;
+      auto& cmap = cmaps[l];
+      NDPart fpart(fine.vertices());
+      bool lpar = par && fine.vertices() >= nd_parallel_min_size;
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(lpar)
+#endif
+      for (integer_t v=0; v<fine.vertices(); v++)
+        fpart[v] = part[cmap[v]];
+      part.swap(fpart);
+      graphs.pop_back();
+      cmaps.pop_back();
+      nd_fm_refine(fine, part);
+    }
+    return part;
+  }
+
+  /**
+   * Turn the edge bisection part of g into a vertex separator, the
+   * separator vertices get part 2. The separator is a minimum vertex
+   * cover of the bipartite graph of cut edges, computed from a
+   * maximum matching (Hopcroft-Karp) and Koenig's theorem.
+   */
+  template<typename integer_t> void
+  nd_vertex_separator(const NDGraph<integer_t>& g, NDPart& part) {
+    const integer_t n = g.vertices(), inf = n + 1;
+    std::vector<integer_t> L;
+    for (integer_t v=0; v<n; v++) {
+      if (part[v] != 0) continue;
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+        if (part[g.ind[j]] == 1) { L.push_back(v); break; }
+    }
+    if (L.empty()) return;
+    std::vector<integer_t> mate(n, -1), dist(n, inf), it(n), stack;
+    std::queue<integer_t> q;
+    auto bfs = [&]() {
+      bool found = false;
+      for (auto u : L) {
+        if (mate[u] == -1) { dist[u] = 0; q.push(u); }
+        else dist[u] = inf;
+      }
+      while (!q.empty()) {
+        auto u = q.front(); q.pop();
+        for (integer_t j=g.ptr[u]; j<g.ptr[u+1]; j++) {
+          auto v = g.ind[j];
+          if (part[v] != 1) continue;
+          auto w = mate[v];
+          if (w == -1) found = true;
+          else if (dist[w] == inf) { dist[w] = dist[u] + 1; q.push(w); }
+        }
+      }
+      return found;
+    };
+    auto dfs = [&](integer_t root) {
+      stack.assign(1, root);
+      while (!stack.empty()) {
+        auto u = stack.back();
+        if (it[u] == g.ptr[u+1]) {
+          dist[u] = inf;
+          stack.pop_back();
+          if (!stack.empty()) it[stack.back()]++;
+          continue;
+        }
+        auto v = g.ind[it[u]];
+        if (part[v] != 1) { it[u]++; continue; }
+        auto w = mate[v];
+        if (w == -1) {
+          for (auto s : stack) {
+            auto vs = g.ind[it[s]];
+            mate[s] = vs;
+            mate[vs] = s;
+          }
+          return true;
+        }
+        if (dist[w] == dist[u] + 1) stack.push_back(w);
+        else it[u]++;
+      }
+      return false;
+    };
+    while (bfs()) {
+      for (auto u : L) it[u] = g.ptr[u];
+      for (auto u : L)
+        if (mate[u] == -1) dfs(u);
+    }
+    // Z: vertices reachable from unmatched vertices in L by
+    // alternating paths, the cover is (L \ Z) + (R in Z)
+    std::vector<char> z(n, 0);
+    for (auto u : L)
+      if (mate[u] == -1) { z[u] = 1; q.push(u); }
+    while (!q.empty()) {
+      auto u = q.front(); q.pop();
+      for (integer_t j=g.ptr[u]; j<g.ptr[u+1]; j++) {
+        auto v = g.ind[j];
+        if (part[v] != 1 || z[v] || mate[u] == v) continue;
+        z[v] = 1;
+        auto w = mate[v];
+        if (w != -1 && !z[w]) { z[w] = 1; q.push(w); }
+      }
+    }
+    for (auto u : L) {
+      if (!z[u]) part[u] = 2;
+      for (integer_t j=g.ptr[u]; j<g.ptr[u+1]; j++) {
+        auto v = g.ind[j];
+        if (part[v] == 1 && z[v]) part[v] = 2;
+      }
+    }
+    // separator vertices with neighbors in only one part can be
+    // moved to that part
+    integer_t pw[3] = {0, 0, 0};
+    for (integer_t v=0; v<n; v++) pw[int(part[v])] += g.vwgt[v];
+    for (integer_t v=0; v<n; v++) {
+      if (part[v] != 2) continue;
+      bool nb[3] = {false, false, false};
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+        nb[int(part[g.ind[j]])] = true;
+      if (nb[0] && nb[1]) continue;
+      int p = nb[0] ? 0 : (nb[1] ? 1 : (pw[0] <= pw[1] ? 0 : 1));
+      part[v] = p;
+      pw[p] += g.vwgt[v];
+      pw[2] -= g.vwgt[v];
+    }
+  }
+
+  /**
+   * If g is not connected, and no component has more than 2/3 of the
+   * weight, split it into two parts by distributing the components,
+   * without separator. Returns false if g is connected.
+   */
+  template<typename integer_t> bool
+  nd_split_components(const NDGraph<integer_t>& g, NDPart& part) {
+    const integer_t n = g.vertices();
+    std::vector<integer_t> comp(n, -1), cw, stack;
+    for (integer_t r=0; r<n; r++) {
+      if (comp[r] != -1) continue;
+      integer_t c = cw.size();
+      cw.push_back(0);
+      comp[r] = c;
+      stack.assign(1, r);
+      while (!stack.empty()) {
+        auto v = stack.back(); stack.pop_back();
+        cw[c] += g.vwgt[v];
+        for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+          if (comp[g.ind[j]] == -1) {
+            comp[g.ind[j]] = c;
+            stack.push_back(g.ind[j]);
+          }
+      }
+    }
+    if (cw.size() < 2 ||
+        3 * *std::max_element(cw.begin(), cw.end()) > 2 * g.weight())
+      return false;
+    std::vector<integer_t> order(cw.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](integer_t a, integer_t b) { return cw[a] > cw[b]; });
+    std::vector<char> cp(cw.size());
+    integer_t pw[2] = {0, 0};
+    for (auto c : order) {
+      int p = pw[0] <= pw[1] ? 0 : 1;
+      cp[c] = p;
+      pw[p] += cw[c];
+    }
+    part.resize(n);
+    for (integer_t v=0; v<n; v++) part[v] = cp[comp[v]];
+    return true;
+  }
+
+  /**
+   * Balanced edge bisection of g, from a breadth first search
+   * starting at a pseudo-peripheral vertex: part 0 gets the first
+   * half of the weight in breadth first order. This is used when the
+   * separator of the regular bisection leaves one of the parts empty.
+   */
+  template<typename integer_t> NDPart
+  nd_balanced_bisection(const NDGraph<integer_t>& g) {
+    const integer_t n = g.vertices();
+    std::vector<integer_t> order;
+    order.reserve(n);
+    std::vector<char> mark(n);
+    auto bfs = [&](integer_t s) {
+      order.clear();
+      std::fill(mark.begin(), mark.end(), 0);
+      for (integer_t r=s, k=0; r<n+s; r++) {
+        // restart from an unvisited vertex for other components
+        if (mark[r % n]) continue;
+        mark[r % n] = 1;
+        order.push_back(r % n);
+        for (; k<integer_t(order.size()); k++) {
+          auto v = order[k];
+          for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+            if (!mark[g.ind[j]]) {
+              mark[g.ind[j]] = 1;
+              order.push_back(g.ind[j]);
+            }
+        }
+      }
+    };
+    bfs(0);
+    bfs(order.back());
+    NDPart part(n, 1);
+    const auto half = g.weight() / 2;
+    integer_t w = 0;
+    for (auto v : order) {
+      if (w >= half) break;
+      part[v] = 0;
+      w += g.vwgt[v];
+    }
+    return part;
+  }
+
+  /**
+   * Extract the subgraph of g induced by the vertices v with part[v]
+   * == p, loc[v] is the index of v in that subgraph.
+   */
+  template<typename integer_t> NDGraph<integer_t>
+  nd_extract(const NDGraph<integer_t>& g, const NDPart& part, char p,
+             const std::vector<integer_t>& verts,
+             const std::vector<integer_t>& loc, bool par) {
+    const integer_t m = verts.size();
+    NDGraph<integer_t> s;
+    s.ptr.resize(m+1);
+    s.vwgt.resize(m);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+    for (integer_t i=0; i<m; i++) {
+      auto v = verts[i];
+      integer_t d = 0;
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++)
+        if (part[g.ind[j]] == p) d++;
+      s.ptr[i+1] = d;
+      s.vwgt[i] = g.vwgt[v];
+    }
+    s.ptr[0] = 0;
+    for (integer_t i=0; i<m; i++) s.ptr[i+1] += s.ptr[i];
+    s.ind.resize(s.ptr[m]);
+    s.ewgt.resize(s.ptr[m]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) if(par)
+#endif
+    for (integer_t i=0; i<m; i++) {
+      auto v = verts[i];
+      auto k = s.ptr[i];
+      for (integer_t j=g.ptr[v]; j<g.ptr[v+1]; j++) {
+        auto u = g.ind[j];
+        if (part[u] != p) continue;
+        s.ind[k] = loc[u];
+        s.ewgt[k++] = g.ewgt[j];
+      }
+    }
+    return s;
+  }
+
+  /**
+   * Nested dissection of g, whose vertices have global indices gid,
+   * into positions [offset, offset+|g|) of the ordering iperm.
+   * Returns the separator tree of g, with sep_end relative to
+   * offset, in postorder. The edge bisection of each subgraph is
+   * computed as bisect(g, gid, par), and is then turned into a
+   * vertex separator.
+   */
+  template<typename integer_t,typename B> std::vector<Separator<integer_t>>
+  nd_recursive(NDGraph<integer_t> g, std::vector<integer_t> gid,
+               integer_t* iperm, integer_t offset, int leaf, int depth,
+               const B& bisect) {
+    const integer_t n = g.vertices();
+    auto make_leaf = [&]() {
+      std::copy(gid.begin(), gid.end(), iperm+offset);
+      return std::vector<Separator<integer_t>>{{n, -1, -1, -1}};
+    };
+    if (n <= leaf) return make_leaf();
+    const bool par = depth < params::task_recursion_cutoff_level &&
+      n >= nd_parallel_min_size;
+    NDPart part;
+    auto empty_part = [&]() {
+      integer_t cnt[3] = {0, 0, 0};
+      for (auto p : part) cnt[int(p)]++;
+      return !cnt[0] || !cnt[1];
+    };
+    if (!nd_split_components(g, part)) {
+      part = bisect(g, gid, par);
+      nd_vertex_separator(g, part);
+      if (empty_part()) {
+        part = nd_balanced_bisection(g);
+        nd_vertex_separator(g, part);
+        // for instance for a (nearly) complete graph
+        if (empty_part()) return make_leaf();
+      }
+    }
+    std::vector<integer_t> verts[3], loc(n);
+    for (integer_t v=0; v<n; v++) {
+      loc[v] = verts[int(part[v])].size();
+      verts[int(part[v])].push_back(v);
+    }
+    const integer_t n0 = verts[0].size(), n1 = verts[1].size();
+    std::vector<integer_t> gid0(n0), gid1(n1);
+    for (integer_t i=0; i<n0; i++) gid0[i] = gid[verts[0][i]];
+    for (integer_t i=0; i<n1; i++) gid1[i] = gid[verts[1][i]];
+    for (std::size_t i=0; i<verts[2].size(); i++)
+      iperm[offset+n0+n1+i] = gid[verts[2][i]];
+    auto g0 = nd_extract(g, part, 0, verts[0], loc, par);
+    auto g1 = nd_extract(g, part, 1, verts[1], loc, par);
+    g = NDGraph<integer_t>();
+    gid.clear();
+    std::vector<Separator<integer_t>> tl, tr;
+    if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task default(shared)
+      tl = nd_recursive(std::move(g0), std::move(gid0), iperm,
+                        offset, leaf, depth+1, bisect);
+#pragma omp task default(shared)
+      tr = nd_recursive(std::move(g1), std::move(gid1), iperm,
+                        offset+n0, leaf, depth+1, bisect);
+#pragma omp taskwait
+    } else {
+      tl = nd_recursive(std::move(g0), std::move(gid0), iperm,
+                        offset, leaf, depth, bisect);
+      tr = nd_recursive(std::move(g1), std::move(gid1), iperm,
+                        offset+n0, leaf, depth, bisect);
+    }
+    const integer_t nl = tl.size(), nr = tr.size();
+    tl.reserve(nl + nr + 1);
+    for (auto& s : tr)
+      tl.emplace_back(s.sep_end + n0, (s.pa == -1) ? -1 : s.pa + nl,
+                      (s.lch == -1) ? -1 : s.lch + nl,
+                      (s.rch == -1) ? -1 : s.rch + nl);
+    tl[nl-1].pa = nl + nr;
+    tl[nl+nr-1].pa = nl + nr;
+    tl.emplace_back(n, -1, nl-1, nl+nr-1);
+    return tl;
+  }
+
+  /**
+   * Graph of the points of the matrix graph (ptr, ind), where each
+   * point corresponds to components consecutive rows, without self
+   * loops. With components == 1, this is the graph of the matrix
+   * without the diagonal.
+   */
+  template<typename integer_t> NDGraph<integer_t>
+  nd_point_graph(integer_t n, const integer_t* ptr, const integer_t* ind,
+                 int components) {
+    const integer_t np = n / components;
+    NDGraph<integer_t> g;
+    g.ptr.resize(np+1);
+    g.vwgt.assign(np, 1);
+    g.ptr[0] = 0;
+    std::vector<integer_t> mark(np, -1);
+    for (integer_t p=0; p<np; p++) {
+      integer_t d = 0;
+      for (integer_t i=p*components; i<(p+1)*components; i++)
+        for (integer_t j=ptr[i]; j<ptr[i+1]; j++) {
+          auto q = ind[j] / components;
+          if (q != p && mark[q] != p) { mark[q] = p; d++; }
+        }
+      g.ptr[p+1] = g.ptr[p] + d;
+    }
+    g.ind.resize(g.ptr[np]);
+    g.ewgt.assign(g.ptr[np], 1);
+    std::fill(mark.begin(), mark.end(), -1);
+    for (integer_t p=0, k=0; p<np; p++)
+      for (integer_t i=p*components; i<(p+1)*components; i++)
+        for (integer_t j=ptr[i]; j<ptr[i+1]; j++) {
+          auto q = ind[j] / components;
+          if (q != p && mark[q] != p) { mark[q] = p; g.ind[k++] = q; }
+        }
+    return g;
+  }
+
+  /**
+   * Nested dissection of the point graph g, expanded to the
+   * components rows of each point.
+   */
+  template<typename integer_t,typename B>
+  std::unique_ptr<SeparatorTree<integer_t>>
+  nd_order(NDGraph<integer_t> g, int components,
+           std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+           int leaf, const B& bisect) {
+    const integer_t np = g.vertices(), n = np * components;
+    std::vector<integer_t> gid(np), piperm(np);
+    std::iota(gid.begin(), gid.end(), 0);
+    std::vector<Separator<integer_t>> tree;
+#pragma omp parallel default(shared)
+#pragma omp single nowait
+    tree = nd_recursive
+      (std::move(g), std::move(gid), piperm.data(), integer_t(0),
+       std::max(1, leaf / components), 0, bisect);
+    perm.resize(n);
+    iperm.resize(n);
+    for (integer_t i=0; i<np; i++)
+      for (int c=0; c<components; c++)
+        iperm[i*components+c] = piperm[i]*components + c;
+    for (integer_t i=0; i<n; i++)
+      perm[iperm[i]] = i;
+    if (components > 1)
+      for (auto& s : tree) s.sep_end *= components;
+    return std::unique_ptr<SeparatorTree<integer_t>>
+      (new SeparatorTree<integer_t>(tree));
+  }
+
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  nd_nested_dissection(integer_t n, const integer_t* ptr,
+                       const integer_t* ind, std::vector<integer_t>& perm,
+                       std::vector<integer_t>& iperm, int leaf) {
+    return nd_order
+      (nd_point_graph(n, ptr, ind, 1), 1, perm, iperm, leaf,
+       [](const NDGraph<integer_t>& g, const std::vector<integer_t>&,
+          bool par) {
+        return nd_multilevel_bisection(g, par); });
+  }
+
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  nd_coordinate_nested_dissection
+  (integer_t n, const integer_t* ptr, const integer_t* ind,
+   const double* coords, int d, int components,
+   std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+   int leaf, bool inertial) {
+    auto bisect = [&](const NDGraph<integer_t>& g,
+                      const std::vector<integer_t>& gid, bool) {
+      const integer_t ng = g.vertices();
+      // coordinates of the first row of each point
+      DenseMatrix<double> P(d, ng);
+      for (integer_t v=0; v<ng; v++)
+        for (int k=0; k<d; k++)
+          P(k, v) = coords[std::size_t(gid[v])*components*d + k];
+      if (inertial) {
+        // principal direction of the centered coordinates
+        for (int k=0; k<d; k++) {
+          double m = 0.;
+          for (integer_t v=0; v<ng; v++) m += P(k, v);
+          m /= ng;
+          for (integer_t v=0; v<ng; v++) P(k, v) -= m;
+        }
+      }
+      std::vector<int> lperm(ng);
+      std::iota(lperm.begin(), lperm.end(), 0);
+      std::vector<std::size_t> nc(2);
+      if (inertial) pca_partition(P, nc, lperm.data());
+      else kd_partition(P, nc, std::size_t(leaf), lperm.data());
+      NDPart part(ng);
+      for (integer_t i=0; i<ng; i++)
+        part[lperm[i]] = (std::size_t(i) < nc[0]) ? 0 : 1;
+      // the cut follows the coordinates, improve it on the graph
+      nd_fm_refine(g, part);
+      return part;
+    };
+    return nd_order
+      (nd_point_graph(n, ptr, ind, components), components,
+       perm, iperm, leaf, bisect);
+  }
+
+  // explicit template instantiations
+  template std::unique_ptr<SeparatorTree<int>>
+  nd_nested_dissection(int n, const int* ptr, const int* ind,
+                       std::vector<int>& perm, std::vector<int>& iperm,
+                       int leaf);
+  template std::unique_ptr<SeparatorTree<long int>>
+  nd_nested_dissection(long int n, const long int* ptr, const long int* ind,
+                       std::vector<long int>& perm,
+                       std::vector<long int>& iperm, int leaf);
+  template std::unique_ptr<SeparatorTree<long long int>>
+  nd_nested_dissection(long long int n, const long long int* ptr,
+                       const long long int* ind,
+                       std::vector<long long int>& perm,
+                       std::vector<long long int>& iperm, int leaf);
+
+  template std::unique_ptr<SeparatorTree<int>>
+  nd_coordinate_nested_dissection
+  (int n, const int* ptr, const int* ind, const double* coords, int d,
+   int components, std::vector<int>& perm, std::vector<int>& iperm,
+   int leaf, bool inertial);
+  template std::unique_ptr<SeparatorTree<long int>>
+  nd_coordinate_nested_dissection
+  (long int n, const long int* ptr, const long int* ind,
+   const double* coords, int d, int components,
+   std::vector<long int>& perm, std::vector<long int>& iperm,
+   int leaf, bool inertial);
+  template std::unique_ptr<SeparatorTree<long long int>>
+  nd_coordinate_nested_dissection
+  (long long int n, const long long int* ptr, const long long int* ind,
+   const double* coords, int d, int components,
+   std::vector<long long int>& perm, std::vector<long long int>& iperm,
+   int leaf, bool inertial);
+
+} // end namespace strumpack
@@ -0,0 +1,101 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef ND_REORDERING_HPP
+#define ND_REORDERING_HPP
+
+#include <vector>
+#include <memory>
+
+#include "StrumpackOptions.hpp"
+#include "sparse/SeparatorTree.hpp"
+
+namespace strumpack {
+
+  /**
+   * Multilevel nested dissection of the graph (ptr, ind), which
+   * should be symmetric, the diagonal is ignored. Each bisection
+   * coarsens the graph with heavy edge matching, computes an initial
+   * bisection of the coarsest graph by greedy graph growing, refines
+   * it with Fiduccia-Mattheyses during uncoarsening and finally
+   * extracts a vertex separator as a minimum vertex cover of the
+   * edges cut by the bisection. The coarsening is done with OpenMP
+   * tasks, and the two halves are ordered in parallel. The recursion
+   * stops at subgraphs with at most leaf vertices.
+   *
+   * This directly builds the separator tree, it does not need to be
+   * reconstructed from the permutation. On return, perm[i] is the new
+   * index of vertex i, and iperm is the inverse of perm.
+   */
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  nd_nested_dissection(integer_t n, const integer_t* ptr,
+                       const integer_t* ind, std::vector<integer_t>& perm,
+                       std::vector<integer_t>& iperm, int leaf);
+
+  template<typename scalar_t,typename integer_t,typename G>
+  std::unique_ptr<SeparatorTree<integer_t>> nd_nested_dissection
+  (const G& A, std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+   const SPOptions<scalar_t>& opts) {
+    return nd_nested_dissection
+      (A.size(), A.ptr(), A.ind(), perm, iperm, opts.nd_param());
+  }
+
+  /**
+   * Nested dissection using the coordinates of the mesh points,
+   * for unstructured meshes. Each subgraph is split at the median of
+   * its coordinates, along the coordinate direction with the largest
+   * extent (kd_partition), or along the principal direction if
+   * inertial is true (pca_partition). The cut is refined with
+   * Fiduccia-Mattheyses on the graph, and a vertex separator is
+   * extracted from it as in nd_nested_dissection.
+   *
+   * coords holds d coordinates for each row, row after row. Each
+   * mesh point has components consecutive rows (degrees of freedom),
+   * which are kept together, only the coordinates of the first row
+   * of a point are used. n should be a multiple of components.
+   */
+  template<typename integer_t> std::unique_ptr<SeparatorTree<integer_t>>
+  nd_coordinate_nested_dissection
+  (integer_t n, const integer_t* ptr, const integer_t* ind,
+   const double* coords, int d, int components,
+   std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+   int leaf, bool inertial);
+
+  template<typename scalar_t,typename integer_t,typename G>
+  std::unique_ptr<SeparatorTree<integer_t>> nd_coordinate_nested_dissection
+  (const G& A, const double* coords, int d, int components,
+   std::vector<integer_t>& perm, std::vector<integer_t>& iperm,
+   const SPOptions<scalar_t>& opts) {
+    return nd_coordinate_nested_dissection
+      (A.size(), A.ptr(), A.ind(), coords, d, components, perm, iperm,
+       opts.nd_param(), opts.inertial_bisection());
+  }
+
+} // end namespace strumpack
+
+#endif // ND_REORDERING_HPP
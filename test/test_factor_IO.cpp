@@ -0,0 +1,159 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <unistd.h>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "misc/RandomWrapper.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+/**
+ * Factor, save the factors to file, load them in a new solver and
+ * check that the solution is identical to the one from the original
+ * solver.
+ */
+template<typename scalar_t,typename integer_t> int
+test_factor_IO(int argc, const char* const argv[],
+               CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  // unique per process, so tests running concurrently do not
+  // overwrite each other's files
+  string fname = "strumpack_factors_test_" + to_string(getpid()) + ".bin";
+  int N = A.size();
+  vector<scalar_t> b(N), x(N), xl(N), x_exact(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& xi : x_exact)
+      xi = rgen->get();
+  }
+  A.spmv(x_exact.data(), b.data());
+
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.set_matrix(A);
+    if (spss.factor() != ReturnCode::SUCCESS) {
+      cout << "problem during factorization of the matrix." << endl;
+      return 1;
+    }
+    spss.solve(b.data(), x.data());
+    if (spss.save_factors(fname) != ReturnCode::SUCCESS) {
+      cout << "problem saving the factors." << endl;
+      return 1;
+    }
+  }
+  {
+    // loading a truncated file should fail cleanly
+    ifstream is(fname, ios::binary);
+    string bytes((istreambuf_iterator<char>(is)),
+                 istreambuf_iterator<char>());
+    string tname = "strumpack_factors_truncated_" +
+      to_string(getpid()) + ".bin";
+    for (auto frac : {0.1, 0.3, 0.5, 0.7, 0.9, 1.}) {
+      {
+        ofstream os(tname, ios::binary);
+        os.write(bytes.data(), std::size_t(frac * bytes.size()) - 1);
+      }
+      StrumpackSparseSolver<scalar_t,integer_t> spss;
+      spss.options().set_from_command_line(argc, argv);
+      if (spss.load_factors(tname) != ReturnCode::FILE_ERROR) {
+        cout << "ERROR: loading a truncated factor file did not fail"
+             << endl;
+        return 1;
+      }
+    }
+    remove(tname.c_str());
+  }
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    if (spss.load_factors(fname) != ReturnCode::SUCCESS) {
+      cout << "problem loading the factors." << endl;
+      return 1;
+    }
+    spss.solve(b.data(), xl.data());
+    remove(fname.c_str());
+    auto comp_scal_res = A.max_scaled_residual(xl.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (loaded) = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+      return 1;
+  }
+  blas::axpy(N, scalar_t(-1.), x.data(), 1, xl.data(), 1);
+  auto nrm_diff = blas::nrm2(N, xl.data(), 1);
+  auto nrm_x = blas::nrm2(N, x.data(), 1);
+  cout << "# RELATIVE DIFFERENCE SAVED/LOADED = "
+       << (nrm_diff/nrm_x) << endl;
+  return (nrm_diff/nrm_x > 1e-10) ? 1 : 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f) == 0)
+    return test_factor_IO(argc, argv, A);
+  else {
+    CSRMatrix<complex<real_t>,integer_t> Acomplex;
+    if (Acomplex.read_matrix_market(f)) {
+      std::cerr << "Could not read matrix from file." << std::endl;
+      return 1;
+    }
+    return test_factor_IO(argc, argv, Acomplex);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Factor a matrix given in matrix market format, save the\n"
+      << "factors to file, load them again and solve.\n\n"
+      << "Usage: \n\t./test_factor_IO pde900.mtx" << endl;
+    return 1;
+  }
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
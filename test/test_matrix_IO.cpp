@@ -27,11 +27,13 @@
  *
  */
 #include <iostream>
+#include <fstream>
 #include <random>
 using namespace std;
 
 #include "dense/DenseMatrix.hpp"
 #include "HSS/HSSMatrix.hpp"
+#include "sparse/CSRMatrix.hpp"
 using namespace strumpack;
 using namespace strumpack::HSS;
 
@@ -181,6 +183,110 @@ int run(int argc, char* argv[]) {
 }
 
 
+/**
+ * Read small matrix market files with blank lines, which should be
+ * skipped, with a line with a missing value, which should be
+ * rejected, a symmetric matrix, and a complex matrix, which should
+ * not be read into a real matrix.
+ */
+int test_matrix_market() {
+  {
+    ofstream f("A_blank_lines.mtx");
+    f << "%%MatrixMarket matrix coordinate real general\n"
+      << "% comment\n"
+      << "3 3 5\n"
+      << "1 1 2.0\n"
+      << "\n"
+      << "2 1 -1.0\n"
+      << "  \t \n"
+      << "2 2 3.0\n"
+      << "3 2 -1.0\n"
+      << "\n"
+      << "3 3 4.0\n"
+      << "\n";
+  }
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market("A_blank_lines.mtx")) {
+    cout << "ERROR: could not read matrix market file" << endl;
+    return 1;
+  }
+  const int ptr[] = {0, 1, 3, 5}, ind[] = {0, 0, 1, 1, 2};
+  const double val[] = {2., -1., 3., -1., 4.};
+  if (A.size() != 3 || A.nnz() != 5) {
+    cout << "ERROR: wrong size or nnz after reading matrix market file"
+         << endl;
+    return 1;
+  }
+  for (int i=0; i<=3; i++)
+    if (A.ptr()[i] != ptr[i]) {
+      cout << "ERROR: wrong row pointers" << endl;
+      return 1;
+    }
+  for (int i=0; i<5; i++)
+    if (A.ind()[i] != ind[i] || A.val()[i] != val[i]) {
+      cout << "ERROR: wrong entries after reading matrix market file"
+           << endl;
+      return 1;
+    }
+  {
+    ofstream f("A_short_line.mtx");
+    f << "%%MatrixMarket matrix coordinate real general\n"
+      << "2 2 3\n"
+      << "1 1 1.0\n"
+      << "2 1\n"
+      << "2 2 1.0";
+  }
+  CSRMatrix<double,int> B;
+  if (!B.read_matrix_market("A_short_line.mtx")) {
+    cout << "ERROR: line with a missing value was not rejected" << endl;
+    return 1;
+  }
+  {
+    ofstream f("A_symmetric.mtx");
+    f << "%%MatrixMarket matrix coordinate real symmetric\n"
+      << "3 3 4\n"
+      << "3 1 -1.0\n"
+      << "1 1 2.0\n"
+      << "2 2 3.0\n"
+      << "3 3 4.0\n";
+  }
+  CSRMatrix<double,int> C;
+  if (C.read_matrix_market("A_symmetric.mtx")) {
+    cout << "ERROR: could not read symmetric matrix market file" << endl;
+    return 1;
+  }
+  const int sptr[] = {0, 2, 3, 5}, sind[] = {0, 2, 1, 0, 2};
+  const double sval[] = {2., -1., 3., -1., 4.};
+  if (C.size() != 3 || C.nnz() != 5) {
+    cout << "ERROR: wrong size or nnz after reading symmetric matrix"
+         << endl;
+    return 1;
+  }
+  for (int i=0; i<=3; i++)
+    if (C.ptr()[i] != sptr[i]) {
+      cout << "ERROR: wrong row pointers of symmetric matrix" << endl;
+      return 1;
+    }
+  for (int i=0; i<5; i++)
+    if (C.ind()[i] != sind[i] || C.val()[i] != sval[i]) {
+      cout << "ERROR: wrong entries of symmetric matrix" << endl;
+      return 1;
+    }
+  {
+    ofstream f("A_complex.mtx");
+    f << "%%MatrixMarket matrix coordinate complex general\n"
+      << "1 1 1\n"
+      << "1 1 1.0 2.0\n";
+  }
+  CSRMatrix<double,int> D;
+  if (!D.read_matrix_market("A_complex.mtx")) {
+    cout << "ERROR: complex matrix was read into a real matrix" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+
 int main(int argc, char* argv[]) {
   cout << "# Running with:\n# ";
 #if defined(_OPENMP)
@@ -193,5 +299,6 @@ int main(int argc, char* argv[]) {
 #pragma omp parallel
 #pragma omp single nowait
   ierr = run(argc, argv);
+  if (!ierr) ierr = test_matrix_market();
   return ierr;
 }
@@ -0,0 +1,99 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "misc/RandomWrapper.hpp"
+
+using namespace strumpack;
+using namespace strumpack::random;
+
+/**
+ * After seed(i,j), check that fill(n) and fill(k,n) give the same
+ * elements as n calls to get(), for any n and k, also when not
+ * aligned to the blocks used by the counter based generator.
+ */
+template<typename real_t> int
+test_fill(RandomEngine e, RandomDistribution d) {
+  auto rgen = make_random_generator<real_t>(1234, e, d);
+  const std::size_t N = 300;
+  for (std::uint32_t i=0; i<3; i++)
+    for (std::uint32_t j=0; j<3; j++) {
+      vector<real_t> ref(N), x(N);
+      rgen->seed(i, j);
+      for (auto& r : ref) r = rgen->get();
+      for (std::size_t k : {0, 1, 3, 5, 37, 64}) {
+        for (std::size_t n : {1, 2, 3, 7, 31, 32, 33, 100, 200}) {
+          rgen->seed(i, j);
+          rgen->fill(std::uint64_t(k), n, x.data());
+          for (std::size_t l=0; l<n; l++)
+            if (x[l] != ref[k+l]) {
+              cout << "ERROR: " << get_name(e) << " " << get_name(d)
+                   << ": fill(" << k << "," << n << ") after seed("
+                   << i << "," << j << ") differs from get()" << endl;
+              return 1;
+            }
+          // after k calls to get, fill(n) continues the sequence
+          rgen->seed(i, j);
+          for (std::size_t l=0; l<k; l++) rgen->get();
+          rgen->fill(n, x.data());
+          for (std::size_t l=0; l<n; l++)
+            if (x[l] != ref[k+l]) {
+              cout << "ERROR: " << get_name(e) << " " << get_name(d)
+                   << ": fill(" << n << ") after seed(" << i << ","
+                   << j << ") and " << k << " calls to get() differs"
+                   << endl;
+              return 1;
+            }
+          if (rgen->get() != ref[k+n]) {
+            cout << "ERROR: " << get_name(e) << " " << get_name(d)
+                 << ": wrong position after fill(" << n << ")" << endl;
+            return 1;
+          }
+        }
+      }
+    }
+  return 0;
+}
+
+template<typename real_t> int test_fill() {
+  for (auto e : {RandomEngine::LINEAR, RandomEngine::MERSENNE,
+        RandomEngine::PHILOX})
+    for (auto d : {RandomDistribution::NORMAL, RandomDistribution::UNIFORM})
+      if (test_fill<real_t>(e, d)) return 1;
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (test_fill<float>() || test_fill<double>()) return 1;
+  cout << "# fill is consistent with get for all random generators"
+       << endl;
+  return 0;
+}
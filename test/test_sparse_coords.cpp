@@ -0,0 +1,152 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "StrumpackSparseSolver.h"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+// the fill of the coordinate based ordering should be close to that
+// of METIS
+#define FILL_TOLERANCE 1.75
+
+/**
+ * 5-point Laplacian on an n x n grid, with the rows in random order,
+ * so the ordering can only be recovered from the coordinates of the
+ * mesh points.
+ */
+CSRMatrix<double,int> scrambled_laplacian(int n, vector<double>& coords) {
+  int N = n * n;
+  vector<int> p(N), ip(N);
+  for (int i=0; i<N; i++) p[i] = i;
+  shuffle(p.begin(), p.end(), mt19937(1));
+  for (int i=0; i<N; i++) ip[p[i]] = i;
+  vector<int> ptr(N+1), ind;
+  vector<double> val;
+  coords.resize(2*N);
+  for (int r=0; r<N; r++) {
+    // row r is grid point p[r]
+    int x = p[r] % n, y = p[r] / n;
+    coords[2*r] = x;
+    coords[2*r+1] = y;
+    vector<pair<int,double>> row = {{r, 4.}};
+    if (x > 0)   row.push_back({ip[p[r]-1], -1.});
+    if (x < n-1) row.push_back({ip[p[r]+1], -1.});
+    if (y > 0)   row.push_back({ip[p[r]-n], -1.});
+    if (y < n-1) row.push_back({ip[p[r]+n], -1.});
+    sort(row.begin(), row.end());
+    for (auto& e : row) { ind.push_back(e.first); val.push_back(e.second); }
+    ptr[r+1] = ind.size();
+  }
+  return CSRMatrix<double,int>(N, ptr.data(), ind.data(), val.data(), true);
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++) cout << argv[i] << " ";
+  cout << endl;
+
+  int n = 40;
+  vector<double> coords;
+  auto A = scrambled_laplacian(n, coords);
+  int N = A.size();
+  vector<double> b(N), x(N), x_exact(N, 1.);
+  A.spmv(x_exact.data(), b.data());
+
+  // C++ interface
+  {
+    StrumpackSparseSolver<double,int> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.set_matrix(A);
+    if (spss.reorder(coords.data(), 2) != ReturnCode::SUCCESS) {
+      cout << "problem with the coordinate reordering." << endl;
+      return 1;
+    }
+    if (spss.solve(b.data(), x.data()) != ReturnCode::SUCCESS) {
+      cout << "problem with the solve." << endl;
+      return 1;
+    }
+    auto res = A.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL = " << res << endl;
+    if (res > ERROR_TOLERANCE*spss.options().rel_tol())
+      return 1;
+
+    // compare the number of nonzeros in the factors with METIS,
+    // which does not need the coordinates
+    StrumpackSparseSolver<double,int> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_reordering_method(ReorderingStrategy::METIS);
+    sps.set_matrix(A);
+    if (sps.factor() != ReturnCode::SUCCESS) {
+      cout << "problem with the factorization with METIS." << endl;
+      return 1;
+    }
+    auto nnz = spss.factor_nonzeros(), nnz_metis = sps.factor_nonzeros();
+    cout << "# FACTOR NONZEROS = " << nnz << ", WITH METIS = "
+         << nnz_metis << endl;
+    if (nnz > FILL_TOLERANCE * nnz_metis) {
+      cout << "ERROR: the coordinate based ordering has more than "
+           << FILL_TOLERANCE << " times the fill of METIS" << endl;
+      return 1;
+    }
+  }
+
+  // C interface
+  {
+    STRUMPACK_SparseSolver S;
+    STRUMPACK_init_mt(&S, STRUMPACK_DOUBLE, STRUMPACK_MT, argc, argv, 0);
+    STRUMPACK_set_from_options(S);
+    STRUMPACK_set_csr_matrix(S, &N, A.ptr(), A.ind(), A.val(), 1);
+    fill(x.begin(), x.end(), 0.);
+    if (STRUMPACK_reorder_coordinates(S, coords.data(), 2, 1)
+        != STRUMPACK_SUCCESS ||
+        STRUMPACK_solve(S, b.data(), x.data(), 0) != STRUMPACK_SUCCESS) {
+      cout << "problem with the C interface." << endl;
+      STRUMPACK_destroy(&S);
+      return 1;
+    }
+    auto rel_tol = STRUMPACK_rel_tol(S);
+    STRUMPACK_destroy(&S);
+    auto res = A.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL (C) = " << res << endl;
+    if (res > ERROR_TOLERANCE*rel_tol)
+      return 1;
+  }
+  return 0;
+}
@@ -38,6 +38,76 @@ using namespace strumpack;
 
 #define ERROR_TOLERANCE 1e2
 #define SOLVE_TOLERANCE 1e-12
+// the fill of the built-in nested dissection should be close to that
+// of METIS
+#define ND_FILL_TOLERANCE 1.5
+
+/**
+ * Replace A by (A + A^T)/2 + shift*I, to test the symmetric
+ * factorizations.
+ */
+template<typename scalar_t,typename integer_t> void
+symmetrize(CSRMatrix<scalar_t,integer_t>& A, scalar_t shift) {
+  A.symmetrize_sparsity();
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  std::vector<scalar_t> sval(A.nnz());
+  for (integer_t i=0; i<A.size(); i++)
+    for (integer_t k=ptr[i]; k<ptr[i+1]; k++) {
+      auto j = ind[k];
+      for (integer_t l=ptr[j]; l<ptr[j+1]; l++)
+        if (ind[l] == i) {
+          sval[k] = (val[k] + val[l]) / scalar_t(2.);
+          break;
+        }
+      if (i == j) sval[k] += shift;
+    }
+  std::copy(sval.begin(), sval.end(), val);
+}
+
+/**
+ * Compare the multiple vector products A X, A^T X and A^H X with
+ * single vector products.
+ */
+template<typename scalar_t,typename integer_t> int
+test_spmv(const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  const int N = A.size(), nrhs = 7;
+  DenseMatrix<scalar_t> X(N, nrhs), Y(N, nrhs), y(N, 1), AT(N, N);
+  X.random();
+  A.spmv(X, Y);
+  for (int c=0; c<nrhs; c++) {
+    A.spmv(X.ptr(0, c), y.data());
+    for (int i=0; i<N; i++) y(i, 0) -= Y(i, c);
+    if (y.norm() > SOLVE_TOLERANCE * Y.norm()) {
+      cout << "ERROR: SpMM differs from SpMV" << endl;
+      return 1;
+    }
+  }
+  // dense A^T, to check the transposed products
+  AT.zero();
+  for (int r=0; r<N; r++)
+    for (int j=A.ptr(r); j<A.ptr(r+1); j++)
+      AT(A.ind(j), r) = A.val(j);
+  for (auto op : {Trans::T, Trans::C}) {
+    A.spmv(op, X, Y);
+    if (op == Trans::T)
+      gemm(Trans::N, Trans::N, scalar_t(-1.), AT, X, scalar_t(1.), Y);
+    else {
+      DenseMatrix<scalar_t> AH(N, N);
+      for (int j=0; j<N; j++)
+        for (int i=0; i<N; i++)
+          AH(i, j) = blas::my_conj(AT(i, j));
+      gemm(Trans::N, Trans::N, scalar_t(-1.), AH, X, scalar_t(1.), Y);
+    }
+    if (Y.norm() > real_t(SOLVE_TOLERANCE) * AT.norm() * X.norm()) {
+      cout << "ERROR: transposed SpMM is wrong" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
 
 template<typename scalar_t,typename integer_t> int
 test_sparse_solver(int argc, const char* const argv[],
@@ -45,6 +115,11 @@ test_sparse_solver(int argc, const char* const argv[],
   using real_t = typename RealType<scalar_t>::value_type;
   StrumpackSparseSolver<scalar_t,integer_t> spss;
   spss.options().set_from_command_line(argc, argv);
+  switch (spss.options().factorization_type()) {
+  case FactorizationType::CHOLESKY: symmetrize(A, scalar_t(0.)); break;
+  case FactorizationType::LDLT: symmetrize(A, scalar_t(-2.)); break;
+  default: break;
+  }
 
   int N = A.size();
   vector<scalar_t> b(N), x(N), x_exact(N);
@@ -54,6 +129,7 @@ test_sparse_solver(int argc, const char* const argv[],
       xi = rgen->get();
   }
   A.spmv(x_exact.data(), b.data());
+  if (test_spmv(A)) return 1;
 
   spss.set_matrix(A);
   if (spss.reorder() != ReturnCode::SUCCESS) {
@@ -66,6 +142,46 @@ test_sparse_solver(int argc, const char* const argv[],
   }
   spss.solve(b.data(), x.data());
 
+  // the level batched factorization, with the small front kernels,
+  // should give the same solution as the regular factorization
+  if (spss.options().level_batching()) {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().disable_level_batching();
+    sps.set_matrix(A);
+    vector<scalar_t> xnb(N);
+    if (sps.factor() != ReturnCode::SUCCESS ||
+        sps.solve(b.data(), xnb.data()) != ReturnCode::SUCCESS) {
+      cout << "problem with the factorization without level batching."
+           << endl;
+      return 1;
+    }
+    blas::axpy(N, scalar_t(-1.), x.data(), 1, xnb.data(), 1);
+    auto rel_diff = blas::nrm2(N, xnb.data(), 1) / blas::nrm2(N, x.data(), 1);
+    cout << "# RELATIVE DIFFERENCE WITH/WITHOUT LEVEL BATCHING = "
+         << rel_diff << endl;
+    if (rel_diff > ERROR_TOLERANCE*SOLVE_TOLERANCE) return 1;
+  }
+
+  if (spss.options().reordering_method() == ReorderingStrategy::ND) {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_reordering_method(ReorderingStrategy::METIS);
+    sps.set_matrix(A);
+    if (sps.factor() != ReturnCode::SUCCESS) {
+      cout << "problem with the factorization with METIS." << endl;
+      return 1;
+    }
+    auto nnz = spss.factor_nonzeros(), nnz_metis = sps.factor_nonzeros();
+    cout << "# FACTOR NONZEROS = " << nnz << ", WITH METIS = "
+         << nnz_metis << endl;
+    if (nnz > ND_FILL_TOLERANCE * nnz_metis) {
+      cout << "ERROR: nested dissection has more than "
+           << ND_FILL_TOLERANCE << " times the fill of METIS" << endl;
+      return 1;
+    }
+  }
+
   auto comp_scal_res = A.max_scaled_residual(x.data(), b.data());
   cout << "# COMPONENTWISE SCALED RESIDUAL = "
        << comp_scal_res << endl;
@@ -77,7 +193,170 @@ test_sparse_solver(int argc, const char* const argv[],
 
   if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
     return 1;
-  else return 0;
+
+  // multiple right hand sides, the last one is a copy of the first,
+  // to check the handling of a rank deficient block
+  const int nrhs = 4;
+  DenseMatrix<scalar_t> B(N, nrhs), X(N, nrhs), X_exact(N, nrhs);
+  X_exact.random();
+  for (int i=0; i<N; i++) X_exact(i, nrhs-1) = X_exact(i, 0);
+  A.spmv(X_exact, B);
+  spss.solve(B, X);
+  comp_scal_res = A.max_scaled_residual(X, B);
+  cout << "# COMPONENTWISE SCALED RESIDUAL, " << nrhs << " RHS = "
+       << comp_scal_res << endl;
+  if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+    return 1;
+
+  // solves with A^T and A^H, reusing the factors of A, skipped when
+  // not supported with the compression used here
+  for (auto op : {Trans::T, Trans::C}) {
+    DenseMatrix<scalar_t> Bt(N, nrhs), Rt(N, nrhs);
+    A.spmv(op, X_exact, Bt);
+    auto ierr = spss.solve(op, Bt, X);
+    if (ierr == ReturnCode::NOT_SUPPORTED) break;
+    if (ierr != ReturnCode::SUCCESS) {
+      cout << "problem with the transposed solve." << endl;
+      return 1;
+    }
+    A.spmv(op, X, Rt);
+    Rt.scaled_add(scalar_t(-1.), Bt);
+    auto rel_res = Rt.norm() / Bt.norm();
+    cout << "# RELATIVE RESIDUAL, " << (op == Trans::T ? "A^T" : "A^H")
+         << " = " << rel_res << endl;
+    if (rel_res > ERROR_TOLERANCE*spss.options().rel_tol())
+      return 1;
+  }
+
+  // sparse right-hand sides, only computing some entries of the
+  // solution, compared to the full (direct) solve
+  {
+    std::vector<integer_t> b_nz = {0, N/2, N-1}, x_idx = {1, N/3, N-2};
+    DenseMatrix<scalar_t> Bs(N, 2), Xs(N, 2), Xf(N, 2);
+    Bs.zero();
+    for (auto i : b_nz) { Bs(i, 0) = scalar_t(1.); Bs(i, 1) = scalar_t(i); }
+    spss.solve_sparse(Bs, Xf, {}, {});
+    spss.solve_sparse(Bs, Xs, b_nz, x_idx);
+    for (auto i : x_idx)
+      for (int c=0; c<2; c++)
+        if (std::abs(Xs(i, c) - Xf(i, c)) >
+            real_t(SOLVE_TOLERANCE) * Xf.norm()) {
+          cout << "ERROR: sparse solve differs from full solve" << endl;
+          return 1;
+        }
+  }
+
+  // Schur complement on a few interface variables, S x_S should be
+  // the condensed right-hand side, and the interior solve should
+  // give the full solution, without compression these are exact
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_compression(CompressionType::NONE);
+    sps.set_matrix(A);
+    std::vector<integer_t> S;
+    for (int i=N/7; i<N; i+=std::max(1, N/5)) S.push_back(i);
+    sps.set_Schur_indices(S);
+    int nS = S.size();
+    DenseMatrix<scalar_t> Sc, g, xS(nS, 1), b1(N, 1), x1(N, 1);
+    for (int i=0; i<N; i++) b1(i, 0) = B(i, 0);
+    for (int k=0; k<nS; k++) xS(k, 0) = X_exact(S[k], 0);
+    if (sps.Schur_complement(Sc) != ReturnCode::SUCCESS ||
+        sps.Schur_forward_solve(b1, x1, g) != ReturnCode::SUCCESS) {
+      cout << "problem computing the Schur complement." << endl;
+      return 1;
+    }
+    auto nrm_g = g.norm();
+    gemm(Trans::N, Trans::N, scalar_t(-1.), Sc, xS, scalar_t(1.), g);
+    cout << "# SCHUR COMPLEMENT ERROR = " << g.norm() / nrm_g << endl;
+    if (g.norm() > real_t(ERROR_TOLERANCE*SOLVE_TOLERANCE) * nrm_g)
+      return 1;
+    sps.Schur_backward_solve(xS, x1);
+    comp_scal_res = A.max_scaled_residual(x1, b1);
+    cout << "# COMPONENTWISE SCALED RESIDUAL, SCHUR = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+      return 1;
+    // the root front is not factored, a regular solve is an error
+    if (sps.solve(b1, x1) != ReturnCode::NOT_SUPPORTED) {
+      cout << "ERROR: solve should fail with a Schur interface" << endl;
+      return 1;
+    }
+  }
+
+  // refactor with new values, same sparsity pattern, this reuses the
+  // scatter maps for the front assembly
+  CSRMatrix<scalar_t,integer_t> A2(A);
+  for (integer_t i=0; i<A2.nnz(); i++) A2.val(i) *= scalar_t(2.);
+  spss.update_matrix_values(A2);
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during refactorization of the matrix." << endl;
+    return 1;
+  }
+  A2.spmv(x_exact.data(), b.data());
+  spss.solve(b.data(), x.data());
+  comp_scal_res = A2.max_scaled_residual(x.data(), b.data());
+  cout << "# COMPONENTWISE SCALED RESIDUAL, REFACTORED = "
+       << comp_scal_res << endl;
+  if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+    return 1;
+
+  // modify some rows, as a low-rank update U V^T, first applied with
+  // the Woodbury formula, then added to the matrix when the rank
+  // exceeds the maximum
+  spss.options().set_low_rank_update_max_rank(2);
+  {
+    // zeroing a row makes A + U V^T singular, this update should be
+    // rejected, without compression A^{-1} U is accurate
+    StrumpackSparseSolver<scalar_t,integer_t> sps;
+    sps.options().set_from_command_line(argc, argv);
+    sps.options().set_compression(CompressionType::NONE);
+    sps.set_matrix(A);
+    integer_t i = N/3;
+    DenseMatrix<scalar_t> U(N, 1), V(N, 1);
+    U.zero();
+    V.zero();
+    U(i, 0) = scalar_t(1.);
+    for (integer_t j=A.ptr(i); j<A.ptr(i+1); j++)
+      V(A.ind(j), 0) = -A.val(j);
+    if (sps.add_low_rank_update(U, V) != ReturnCode::INVALID_ARGUMENT ||
+        sps.low_rank_update_rank() != 0) {
+      cout << "ERROR: singular low-rank update was not rejected" << endl;
+      return 1;
+    }
+  }
+  for (auto rows : {std::vector<integer_t>{N/4, 3*N/4},
+        std::vector<integer_t>{N/2}}) {
+    integer_t r = rows.size();
+    DenseMatrix<scalar_t> U(N, r), V(N, r);
+    U.zero();
+    V.zero();
+    for (integer_t k=0; k<r; k++) {
+      auto i = rows[k];
+      U(i, k) = scalar_t(1.);
+      for (integer_t j=A2.ptr(i); j<A2.ptr(i+1); j++) {
+        V(A2.ind(j), k) = scalar_t(2.) * A2.val(j);
+        A2.val(j) *= scalar_t(3.);
+      }
+    }
+    if (spss.add_low_rank_update(U, V) != ReturnCode::SUCCESS) {
+      cout << "problem with the low-rank update." << endl;
+      return 1;
+    }
+    A2.spmv(x_exact.data(), b.data());
+    spss.solve(b.data(), x.data());
+    comp_scal_res = A2.max_scaled_residual(x.data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL, LOW-RANK UPDATE, RANK "
+         << spss.low_rank_update_rank() << " = " << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol())
+      return 1;
+  }
+  if (spss.options().factorization_type() == FactorizationType::LU &&
+      spss.low_rank_update_rank() != 0) {
+    cout << "ERROR: low-rank update was not added to the matrix" << endl;
+    return 1;
+  }
+  return 0;
 }
 
 
@@ -0,0 +1,172 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <map>
+#include <cstdio>
+#include <unistd.h>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Return the value following "key": in a line of the trace, or -1
+ * if the key is not found.
+ */
+long long get_value(const string& line, const string& key) {
+  auto k = line.find("\"" + key + "\":");
+  if (k == string::npos) return -1;
+  istringstream is(line.substr(k + key.size() + 3));
+  long long v = -1;
+  is >> v;
+  return v;
+}
+
+string get_name(const string& line) {
+  auto k = line.find("{\"name\":\"");
+  if (k == string::npos) return "";
+  k += 9;
+  return line.substr(k, line.find('"', k) - k);
+}
+
+/**
+ * Factor and solve with tracing enabled, and check the events in the
+ * trace file: every unknown is in the separator of exactly one
+ * factored front, every front which is factored is also assembled
+ * and solved, and the thread ids are consistent with the number of
+ * threads.
+ */
+template<typename scalar_t,typename integer_t> int
+test_trace(int argc, const char* const argv[],
+           CSRMatrix<scalar_t,integer_t>& A) {
+  // unique per process, so tests running concurrently do not
+  // overwrite each other's files
+  string fname = "strumpack_trace_test_" + to_string(getpid()) + ".json";
+  int N = A.size();
+  vector<scalar_t> b(N, scalar_t(1.)), x(N);
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.options().set_trace_file(fname);
+    spss.set_matrix(A);
+    if (spss.factor() != ReturnCode::SUCCESS) {
+      cout << "problem during factorization of the matrix." << endl;
+      return 1;
+    }
+    spss.solve(b.data(), x.data());
+  } // the trace is written when the solver is destroyed
+  ifstream is(fname);
+  if (!is) {
+    cout << "ERROR: the trace file was not written" << endl;
+    return 1;
+  }
+  string line;
+  getline(is, line);
+  if (line.find("{\"traceEvents\":[") != 0) {
+    cout << "ERROR: the trace file does not start with traceEvents"
+         << endl;
+    return 1;
+  }
+  map<string,set<long long>> fronts;
+  set<long long> tids;
+  long long sep = 0, events = 0;
+  while (getline(is, line)) {
+    if (line.find("\"ph\":\"X\"") == string::npos) continue;
+    events++;
+    auto name = get_name(line);
+    auto f = get_value(line, "front");
+    auto tid = get_value(line, "tid");
+    if (f < 0 || tid < 0 || get_value(line, "dur") < 0 ||
+        get_value(line, "dim_sep") < 0) {
+      cout << "ERROR: incomplete event: " << line << endl;
+      return 1;
+    }
+    if (!fronts[name].insert(f).second && name == "factor") {
+      cout << "ERROR: front " << f << " was factored twice" << endl;
+      return 1;
+    }
+    if (name == "factor") sep += get_value(line, "dim_sep");
+    tids.insert(tid);
+  }
+  is.close();
+  remove(fname.c_str());
+  cout << "# trace events: " << events << ", factored fronts: "
+       << fronts["factor"].size() << ", threads: " << tids.size()
+       << endl;
+  if (sep != N) {
+    cout << "ERROR: the separators of the factored fronts add up to "
+         << sep << ", not " << N << endl;
+    return 1;
+  }
+  for (auto e : {"assembly", "forward_solve", "backward_solve"})
+    for (auto f : fronts["factor"])
+      if (!fronts[e].count(f)) {
+        cout << "ERROR: no " << e << " event for front " << f << endl;
+        return 1;
+      }
+  int threads = 1;
+#if defined(_OPENMP)
+  threads = omp_get_max_threads();
+#endif
+  if (int(tids.size()) > threads) {
+    cout << "ERROR: events from " << tids.size() << " threads, but "
+         << "running with " << threads << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Factor and solve a matrix given in matrix market format,\n"
+      << "with tracing enabled, and check the trace file.\n\n"
+      << "Usage: \n\t./test_trace pde900.mtx" << endl;
+    return 1;
+  }
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++)
+    cout << argv[i] << " ";
+  cout << endl;
+
+  CSRMatrix<double,int> A;
+  if (A.read_matrix_market(argv[1])) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  return test_trace(argc, argv, A);
+}